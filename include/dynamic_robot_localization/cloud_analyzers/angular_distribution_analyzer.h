@@ -10,6 +10,7 @@
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
 #include <cmath>
+#include <complex>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +23,9 @@
 // PCL includes
 #include <pcl/point_cloud.h>
 
+// external libs includes
+#include <unsupported/Eigen/FFT>
+
 // project includes
 #include <dynamic_robot_localization/cloud_analyzers/cloud_analyzer.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -49,12 +53,26 @@ class AngularDistributionAnalyzer : public CloudAnalyzer<PointT> {
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
 		virtual bool computeAnalysisHistogram(const tf2::Transform& estimated_pose, const pcl::PointCloud<PointT>& pointcloud, std::vector<size_t>& analysis_histogram_out);
 		virtual double computeAnalysis(std::vector<size_t>& analysis_histogram);
+
+		/**
+		 * Histogram with number_of_angular_bins_ over [0, 2pi[ (or [0, pi[ if axial is true, for normals without consistent flipping) of the yaw of the normals, weighted by the norm of their xy projection
+		 * @return false if there are no normals with a valid xy projection
+		 */
+		bool computeNormalsOrientationHistogram(const pcl::PointCloud<PointT>& pointcloud, const std::vector<int>* indices, bool axial, std::vector<double>& histogram_out) const;
+
+		/**
+		 * Circular cross correlation computed with FFTs: correlation_out[s] = sum_j reference_histogram[j] * ambient_histogram[(j - s) mod n]
+		 * (s is the rotation, in bins, that aligns the ambient histogram with the reference histogram)
+		 */
+		static bool s_computeCircularCrossCorrelation(const std::vector<double>& reference_histogram, const std::vector<double>& ambient_histogram, std::vector<double>& correlation_out);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </AngularDistributionAnalyzer-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline int getNumberOfAngularBins() const { return number_of_angular_bins_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setNumberOfAngularBins(int number_of_angular_bins) { number_of_angular_bins_ = number_of_angular_bins; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
@@ -93,6 +93,49 @@ double AngularDistributionAnalyzer<PointT>::computeAnalysis(std::vector<size_t>&
 
 	return (double)filled_bins / (double)analysis_histogram.size();
 }
+
+
+template<typename PointT>
+bool AngularDistributionAnalyzer<PointT>::computeNormalsOrientationHistogram(const pcl::PointCloud<PointT>& pointcloud, const std::vector<int>* indices, bool axial, std::vector<double>& histogram_out) const {
+	if (number_of_angular_bins_ <= 0) { return false; }
+	histogram_out.assign((size_t)number_of_angular_bins_, 0.0);
+
+	double histogram_range = axial ? M_PI : 2.0 * M_PI;
+	double bins_per_radian = (double)number_of_angular_bins_ / histogram_range;
+	size_t number_of_points = indices ? indices->size() : pointcloud.size();
+	bool has_valid_normals = false;
+
+	for (size_t i = 0; i < number_of_points; ++i) {
+		const PointT& point = pointcloud[indices ? (size_t)(*indices)[i] : i];
+		double normal_xy_norm = std::sqrt((double)point.normal_x * (double)point.normal_x + (double)point.normal_y * (double)point.normal_y);
+		if (!std::isfinite(normal_xy_norm) || normal_xy_norm < 1e-6) { continue; }
+
+		double angle = std::fmod(std::atan2((double)point.normal_y, (double)point.normal_x) + 2.0 * M_PI, histogram_range);
+		size_t bin = std::min((size_t)(angle * bins_per_radian), histogram_out.size() - 1);
+		histogram_out[bin] += normal_xy_norm;
+		has_valid_normals = true;
+	}
+
+	return has_valid_normals;
+}
+
+
+template<typename PointT>
+bool AngularDistributionAnalyzer<PointT>::s_computeCircularCrossCorrelation(const std::vector<double>& reference_histogram, const std::vector<double>& ambient_histogram, std::vector<double>& correlation_out) {
+	if (reference_histogram.empty() || reference_histogram.size() != ambient_histogram.size()) { return false; }
+
+	Eigen::FFT<double> fft;
+	std::vector< std::complex<double> > reference_spectrum, ambient_spectrum;
+	fft.fwd(reference_spectrum, reference_histogram);
+	fft.fwd(ambient_spectrum, ambient_histogram);
+
+	for (size_t i = 0; i < reference_spectrum.size(); ++i) {
+		reference_spectrum[i] *= std::conj(ambient_spectrum[i]);
+	}
+
+	fft.inv(correlation_out, reference_spectrum);
+	return true;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </AngularDistributionAnalyzer-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
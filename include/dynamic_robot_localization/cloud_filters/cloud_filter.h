@@ -20,6 +20,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <pcl/filters/filter.h>
+#include <pcl/filters/filter_indices.h>
 #include <pcl_conversions/pcl_conversions.h>
 
 // project includes
@@ -25,6 +25,19 @@ void CloudFilter<PointT>::setupConfigurationFromParameterServer(ros::NodeHandleP
 	cloud_publisher_ = typename CloudPublisher<PointT>::Ptr(new CloudPublisher<PointT>());
 	cloud_publisher_->setParameterServerArgumentToLoadTopicName(configuration_namespace + "filtered_cloud_publish_topic");
 	cloud_publisher_->setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+
+	bool keep_organized = false;
+	std::string final_param_name;
+	if (ros::param::search(private_node_handle->getNamespace() + "/" + configuration_namespace, "keep_organized", final_param_name)) {
+		private_node_handle->param(final_param_name, keep_organized, false);
+	}
+
+	typename pcl::FilterIndices<PointT>::Ptr filter_indices = std::dynamic_pointer_cast< pcl::FilterIndices<PointT> >(filter_);
+	if (filter_indices) {
+		filter_indices->setKeepOrganized(keep_organized);
+	} else if (keep_organized) {
+		ROS_DEBUG_STREAM(filter_name_ << " filter can not keep the point cloud organized");
+	}
 }
 
 template<typename PointT>
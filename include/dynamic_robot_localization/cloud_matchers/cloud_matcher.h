@@ -9,6 +9,8 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
 
@@ -43,6 +45,8 @@
 #include <dynamic_robot_localization/common/registration_visualizer.h>
 #include <dynamic_robot_localization/cloud_matchers/correspondence_estimation.h>
 #include <dynamic_robot_localization/cloud_matchers/transformation_estimation.h>
+#include <dynamic_robot_localization/cloud_matchers/transformation_estimation_lm_analytic.h>
+#include <dynamic_robot_localization/cloud_matchers/transformation_estimation_point_to_plane_lls_parallel.h>
 #include <laserscan_to_pointcloud/tf_rosmsg_eigen_conversions.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -77,7 +81,12 @@ class CloudMatcher : public ConfigurableObject {
 				typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
 				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
 				tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints = false);
+		virtual void computeRegistrationInitialGuess(Eigen::Matrix4f& initial_guess_in_out) {}
+		/** Pose (in the map frame) around which the ambient cloud is expected to be registered (used by the matchers that support gating their search space) */
+		virtual void setPosePrior(const tf2::Transform& pose_prior) {}
 		virtual bool postProcessRegistrationMatrix(typename pcl::PointCloud<PointT>::Ptr &ambient_pointcloud, const Eigen::Matrix4f &final_transformation, tf2::Transform &best_pose_correction_out);
+		/** Fraction of the points (at most maximum_number_of_points evenly spaced, <= 0 -> all) that after being transformed are within inlier_distance of the reference point cloud */
+		float computeInlierFraction(const pcl::PointCloud<PointT>& pointcloud, const Eigen::Matrix4f& transformation, double inlier_distance, int maximum_number_of_points = 0) const;
 
 		virtual void initializeKeypointProcessing() {}
 		virtual void processKeypoints(typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
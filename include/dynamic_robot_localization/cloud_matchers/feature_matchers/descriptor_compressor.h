@@ -0,0 +1,96 @@
+#pragma once
+
+/**\file descriptor_compressor.h
+ * \brief PCA projection and 8 bits quantization (or binarization) of keypoint descriptors into compact codes.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// external libs includes
+#include <Eigen/Core>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// #########################################################################   descriptor_compressor   #########################################################################
+/**
+ * \brief Learns a PCA projection from a set of descriptors and encodes each descriptor into a compact code, with either:
+ *  - one byte per principal component (the same quantization step is used for all components, which keeps the L2 distances between codes proportional to the L2 distances between the projected descriptors)
+ *  - one bit per principal component (sign of the centered projection, compared with the Hamming distance)
+ * The distances between codes are only an approximation of the descriptors distances, and should be used to select candidates for an exact re-ranking.
+ */
+class DescriptorCompressor {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< DescriptorCompressor >;
+		using ConstPtr = std::shared_ptr< const DescriptorCompressor >;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <enums>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		enum CodeType {
+			Quantized8Bits,
+			Binary
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </enums>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		DescriptorCompressor() : code_type_(Quantized8Bits), dimensions_(0), number_of_components_(0), code_size_(0), quantization_scale_(1.0f) {}
+		virtual ~DescriptorCompressor() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <DescriptorCompressor-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/**
+		 * Learns the projection from the row major descriptors (at most maximum_number_of_training_samples, evenly spaced, are used for the PCA)
+		 * @return false if there is not enough data
+		 */
+		bool train(const float* descriptors, size_t number_of_descriptors, int dimensions, int number_of_components, CodeType code_type, size_t maximum_number_of_training_samples = 10000);
+		/** Writes the getNumberOfComponents() principal components of the centered descriptor */
+		void project(const float* descriptor, float* projected) const;
+		void encode(const float* descriptor, uint8_t* code) const;
+		void encode(const float* descriptors, size_t number_of_descriptors, std::vector<uint8_t>& codes) const;
+
+		/** Squared L2 distance (in quantization steps) for Quantized8Bits codes or Hamming distance for Binary codes */
+		inline uint32_t computeDistance(const uint8_t* code_a, const uint8_t* code_b) const {
+			return (code_type_ == Binary) ? s_computeHammingDistance(code_a, code_b, code_size_) : s_computeSquaredL2Distance(code_a, code_b, code_size_);
+		}
+
+		static uint32_t s_computeSquaredL2Distance(const uint8_t* code_a, const uint8_t* code_b, size_t code_size);
+		static uint32_t s_computeHammingDistance(const uint8_t* code_a, const uint8_t* code_b, size_t code_size);
+
+		bool save(std::ostream& output_stream) const;
+		bool load(std::istream& input_stream);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </DescriptorCompressor-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline bool isTrained() const { return code_size_ > 0; }
+		inline CodeType getCodeType() const { return code_type_; }
+		inline int getDimensions() const { return dimensions_; }
+		inline int getNumberOfComponents() const { return number_of_components_; }
+		inline size_t getCodeSize() const { return code_size_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		CodeType code_type_;
+		int dimensions_;
+		int number_of_components_;
+		size_t code_size_;
+		Eigen::VectorXf mean_;
+		Eigen::MatrixXf projection_; // number_of_components_ x dimensions_
+		Eigen::VectorXf quantization_offset_;
+		float quantization_scale_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,185 @@
+#pragma once
+
+/**\file descriptor_index.h
+ * \brief Nearest neighbor index for keypoint descriptors, with exact and approximate FLANN backends.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/kdtree/kdtree.h>
+
+// external libs includes
+#include <flann/flann.hpp>
+
+// project includes
+#include <dynamic_robot_localization/common/performance_timer.h>
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_compressor.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ###########################################################################   descriptor_index   ############################################################################
+/**
+ * \brief Drop in replacement of pcl::KdTreeFLANN for the descriptors matching, that allows the selection of the FLANN index type.
+ * The single kd-tree is exact (same results as pcl::KdTreeFLANN), but degrades to a brute force search on high dimensional descriptors (such as SHOT352 or PFH125).
+ * The randomized kd-trees and the hierarchical k-means tree are approximate, and their recall / speed trade off is controlled by the number of checks (leafs visited per query).
+ * The PCA compressed indexes store a compact code per descriptor (8 bits per principal component or 1 bit per principal component), grouped in inverted lists
+ * by a coarse k-means quantizer in the PCA space. Each query scans only the codes of the lists with the closest centroids (number of probes),
+ * followed by an exact re-ranking of the best candidates using the original descriptors.
+ * The exact re-ranking reads the descriptors from the input cloud, which must be kept in memory. The feature matcher needs the float reference descriptors cloud anyway
+ * (pcl registration target features, pose prior gating kd-tree), and keeps loading and saving it in reference_pointcloud_descriptors_filename.
+ * As such, the compression reduces the size of the index (and of its file) and the search time, but it does not reduce the memory nor the files of the reference descriptors.
+ * The index can be saved and loaded from disk, to avoid its construction when the reference descriptors are also loaded from file.
+ * The saved index includes a hash of the descriptors and build parameters, and it is rebuilt when the hash does not match the descriptors being indexed.
+ */
+template <typename FeatureT>
+class DescriptorIndex : public pcl::KdTree<FeatureT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< DescriptorIndex<FeatureT> >;
+		using ConstPtr = std::shared_ptr< const DescriptorIndex<FeatureT> >;
+		using PointCloudConstPtr = typename pcl::KdTree<FeatureT>::PointCloudConstPtr;
+		using IndicesConstPtr = typename pcl::KdTree<FeatureT>::IndicesConstPtr;
+		using FLANNIndex = flann::Index< flann::L2_Simple<float> >;
+
+		using pcl::KdTree<FeatureT>::nearestKSearch;
+		using pcl::KdTree<FeatureT>::radiusSearch;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <enums>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		enum IndexType {
+			KdTreeSingle,
+			KdTreeRandomized,
+			HierarchicalKMeans,
+			PCAQuantized,
+			PCABinary
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </enums>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		DescriptorIndex() :
+			pcl::KdTree<FeatureT>(true),
+			index_type_(KdTreeSingle), number_of_randomized_trees_(4), kmeans_branching_(32), kmeans_iterations_(11), number_of_checks_(256),
+			compression_number_of_components_(32), compression_maximum_number_of_training_samples_(10000), compression_number_of_lists_(0), compression_number_of_probes_(8), rerank_factor_(4),
+			dimensions_(0), total_number_of_points_(0), identity_mapping_(true), index_hash_(0), index_loaded_from_file_(false), index_build_elapsed_time_(0) {}
+		virtual ~DescriptorIndex() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <DescriptorIndex-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		static bool parseIndexType(const std::string& index_type_name, IndexType& index_type);
+
+		/** Builds the index (or loads it from the file set in setIndexLoadFilename, if it was built for a dataset with the same size) */
+		virtual void setInputCloud(const PointCloudConstPtr& cloud, const IndicesConstPtr& indices = IndicesConstPtr());
+		virtual int nearestKSearch(const FeatureT& point, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const;
+		virtual int radiusSearch(const FeatureT& point, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn = 0) const;
+		bool saveIndex(const std::string& filename) const;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </DescriptorIndex-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline IndexType getIndexType() const { return index_type_; }
+		inline int getNumberOfChecks() const { return number_of_checks_; }
+		inline bool isCompressed() const { return index_type_ == PCAQuantized || index_type_ == PCABinary; }
+		inline bool isBuilt() const { return index_ || !codes_.empty(); }
+		inline size_t getCodesMemorySize() const { return codes_.size(); }
+		inline size_t getNumberOfLists() const { return lists_offsets_.empty() ? 0 : lists_offsets_.size() - 1; }
+		inline bool isIndexLoadedFromFile() const { return index_loaded_from_file_; }
+		inline uint64_t getIndexHash() const { return index_hash_; }
+		inline double getIndexBuildElapsedTime() const { return index_build_elapsed_time_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline void setIndexType(IndexType index_type) { index_type_ = index_type; }
+		inline void setNumberOfRandomizedTrees(int number_of_randomized_trees) { number_of_randomized_trees_ = number_of_randomized_trees; }
+		inline void setKMeansBranching(int kmeans_branching) { kmeans_branching_ = kmeans_branching; }
+		inline void setKMeansIterations(int kmeans_iterations) { kmeans_iterations_ = kmeans_iterations; }
+		/** Number of leafs visited per query by the approximate indexes (higher values increase the recall and the search time | <= 0 -> unlimited, which is an exact search) */
+		inline void setNumberOfChecks(int number_of_checks) { number_of_checks_ = number_of_checks; }
+		inline void setCompressionNumberOfComponents(int compression_number_of_components) { compression_number_of_components_ = compression_number_of_components; }
+		inline void setCompressionMaximumNumberOfTrainingSamples(size_t compression_maximum_number_of_training_samples) { compression_maximum_number_of_training_samples_ = compression_maximum_number_of_training_samples; }
+		/** Number of inverted lists of the compressed indexes (<= 0 -> square root of the number of descriptors) */
+		inline void setCompressionNumberOfLists(int compression_number_of_lists) { compression_number_of_lists_ = compression_number_of_lists; }
+		/** Minimum number of inverted lists scanned per query (more are scanned if they do not have enough candidates for the re-ranking | <= 0 -> all lists, which is a linear scan) */
+		inline void setCompressionNumberOfProbes(int compression_number_of_probes) { compression_number_of_probes_ = compression_number_of_probes; }
+		/** The compressed indexes re-rank k * rerank_factor candidates with the exact descriptors distance */
+		inline void setRerankFactor(int rerank_factor) { rerank_factor_ = rerank_factor; }
+		inline void setIndexLoadFilename(const std::string& index_load_filename) { index_load_filename_ = index_load_filename; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		virtual std::string getName() const { return "DescriptorIndex"; }
+		flann::IndexParams createIndexParams() const;
+		flann::SearchParams createSearchParams() const;
+		void mapIndices(std::vector<int>& k_indices) const;
+		/** FNV-1a hash of the build parameters, the positions in the input cloud and the data of the indexed descriptors */
+		uint64_t computeIndexHash() const;
+		bool checkIndexFileHash(const std::string& filename) const;
+		bool buildCompressedIndex();
+		void buildInvertedLists();
+		int findNearestList(const float* projected_descriptor) const;
+		size_t selectListsToProbe(const std::vector<float>& query, std::vector< std::pair<float, int> >& lists_distances) const;
+		bool loadCompressedIndex(const std::string& filename);
+		bool saveCompressedIndex(const std::string& filename) const;
+		int nearestKSearchCompressed(const std::vector<float>& query, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const;
+		float computeExactSquaredDistance(const std::vector<float>& query, int index_position, std::vector<float>& descriptor_buffer) const;
+		static float s_computeSquaredDistance(const float* a, const float* b, int dimensions);
+
+		IndexType index_type_;
+		int number_of_randomized_trees_;
+		int kmeans_branching_;
+		int kmeans_iterations_;
+		int number_of_checks_;
+		int compression_number_of_components_;
+		size_t compression_maximum_number_of_training_samples_;
+		int compression_number_of_lists_;
+		int compression_number_of_probes_;
+		int rerank_factor_;
+		std::string index_load_filename_;
+
+		std::shared_ptr<FLANNIndex> index_;
+		std::vector<float> descriptors_data_; // row major, referenced by the FLANN index
+		DescriptorCompressor compressor_;
+		std::vector<uint8_t> codes_; // row major, compressor_.getCodeSize() bytes per descriptor, sorted by inverted list
+		std::vector<float> lists_centroids_; // row major, compressor_.getNumberOfComponents() floats per list
+		std::vector<size_t> lists_offsets_; // codes of list i are in [lists_offsets_[i], lists_offsets_[i + 1][
+		std::vector<int> codes_positions_; // position in index_mapping_ of each code
+		std::vector<int> index_mapping_;
+		int dimensions_;
+		int total_number_of_points_;
+		bool identity_mapping_;
+		uint64_t index_hash_;
+		static constexpr uint64_t s_index_file_hash_marker_ = 0x48534148584449ULL; // "IDXHASH", appended to the FLANN index files before the hash
+		bool index_loaded_from_file_;
+		double index_build_elapsed_time_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/impl/descriptor_index.hpp>
+#endif
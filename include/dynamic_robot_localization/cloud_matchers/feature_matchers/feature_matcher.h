@@ -9,8 +9,11 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <cmath>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // ROS includes
 #include <ros/ros.h>
@@ -18,10 +21,16 @@
 // PCL includes
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
+#include <pcl/kdtree/kdtree_flann.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
 
 // project includes
 #include <dynamic_robot_localization/common/pointcloud_conversions.h>
 #include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_index.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_descriptors/keypoint_descriptor.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_descriptors/fpfh.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_descriptors/shot.h>
@@ -42,7 +51,9 @@ class FeatureMatcher : public CloudMatcher<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		FeatureMatcher() : save_descriptors_in_binary_format_(true) {}
+		FeatureMatcher() : save_descriptors_in_binary_format_(true), reference_descriptors_index_(new DescriptorIndex<FeatureT>()),
+			pose_prior_gating_(false), pose_prior_translation_uncertainty_(1.0f, 1.0f, 0.0f), pose_prior_rotation_uncertainty_(0.5f), pose_prior_gating_fallback_to_global_search_(true),
+			pose_prior_available_(false), pose_prior_position_(Eigen::Vector3f::Zero()), pose_prior_rotation_(Eigen::Matrix3f::Identity()) {}
 		virtual ~FeatureMatcher() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -57,14 +68,28 @@ class FeatureMatcher : public CloudMatcher<PointT> {
 
 		virtual void setMatcherReferenceDescriptors(typename pcl::PointCloud<FeatureT>::Ptr& reference_descriptors) = 0;
 		virtual void setMatcherAmbientDescriptors(typename pcl::PointCloud<FeatureT>::Ptr& ambient_descriptors) = 0;
+		virtual void setMatcherDescriptorsSearchMethod(typename pcl::KdTree<FeatureT>::Ptr descriptors_search_method) = 0;
+		virtual void setMatcherHypothesisValidator(const std::function<bool (const Eigen::Matrix4f&)>& hypothesis_validator) = 0;
+
+		virtual void setPosePrior(const tf2::Transform& pose_prior);
+		virtual bool registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+				typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+				tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints = false);
+		bool computeGatedDescriptorsSearchMethod(const typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, typename pcl::KdTree<FeatureT>::Ptr& gated_descriptors_search_method_out);
+		bool isTransformationConsistentWithPosePrior(const Eigen::Matrix4f& pose_correction) const;
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </FeatureMatcher-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		const typename KeypointDescriptor<PointT, FeatureT>::Ptr getKeypointDescriptor() { return keypoint_descriptor_; }
+		const typename DescriptorIndex<FeatureT>::Ptr getReferenceDescriptorsIndex() { return reference_descriptors_index_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		void setKeypointDescriptor(const typename KeypointDescriptor<PointT, FeatureT>::Ptr& keypoint_descriptor) { keypoint_descriptor_ = keypoint_descriptor; }
+		void setPosePriorGating(bool pose_prior_gating) { pose_prior_gating_ = pose_prior_gating; }
+		/** Semi-axes of the uncertainty ellipsoid of the position (in the pose prior frame) and maximum rotation angle (radians) of the pose correction */
+		void setPosePriorUncertainty(const Eigen::Vector3f& translation_uncertainty, float rotation_uncertainty) { pose_prior_translation_uncertainty_ = translation_uncertainty; pose_prior_rotation_uncertainty_ = rotation_uncertainty; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
@@ -75,6 +100,17 @@ class FeatureMatcher : public CloudMatcher<PointT> {
 		std::string reference_pointcloud_descriptors_filename_;
 		std::string reference_pointcloud_descriptors_save_filename_;
 		bool save_descriptors_in_binary_format_;
+		typename DescriptorIndex<FeatureT>::Ptr reference_descriptors_index_;
+		std::string reference_pointcloud_descriptors_index_filename_;
+		std::string reference_pointcloud_descriptors_index_save_filename_;
+		typename pcl::PointCloud<FeatureT>::Ptr reference_descriptors_;
+		bool pose_prior_gating_;
+		Eigen::Vector3f pose_prior_translation_uncertainty_;
+		float pose_prior_rotation_uncertainty_;
+		bool pose_prior_gating_fallback_to_global_search_;
+		bool pose_prior_available_;
+		Eigen::Vector3f pose_prior_position_;
+		Eigen::Matrix3f pose_prior_rotation_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -40,9 +40,12 @@
 #ifndef IA_RANSAC_H_
 #define IA_RANSAC_H_
 
+#include <functional>
 #include <limits>
 #include <memory>
 #include <pcl/registration/registration.h>
+#include <pcl/kdtree/kdtree.h>
+#include <pcl/kdtree/kdtree_flann.h>
 #include <pcl/registration/transformation_estimation_svd.h>
 #include <pcl/common/time.h>
 #include <Eigen/Core>
@@ -133,7 +136,8 @@ namespace dynamic_robot_localization
           float threshold_;
       };
 
-      using FeatureKdTreePtr = typename pcl::KdTreeFLANN<FeatureT>::Ptr;
+      using FeatureKdTreePtr = typename pcl::KdTree<FeatureT>::Ptr;
+      using HypothesisValidator = std::function<bool (const Eigen::Matrix4f&)>;
       /** \brief Constructor. */
       SampleConsensusInitialAlignmentRegistration () :
         input_features_ (), target_features_ (), 
@@ -202,6 +206,23 @@ namespace dynamic_robot_localization
       int
       getCorrespondenceRandomness () { return (k_correspondences_); }
 
+      /** \brief Provide the search method used to find the most similar target feature descriptors (pcl::KdTreeFLANN by default)
+        * \param[in] feature_tree the search method (its input cloud is set to the target features, unless it was already built for them)
+        */
+      void
+      setFeatureSearchMethod (const FeatureKdTreePtr &feature_tree)
+      {
+        feature_tree_ = feature_tree;
+        if (target_features_ && feature_tree_->getInputCloud () != target_features_)
+          feature_tree_->setInputCloud (target_features_);
+      }
+
+      /** \brief Provide a function that rejects pose hypotheses before their evaluation (for example, hypotheses inconsistent with a pose prior)
+        * \param hypothesis_validator returns false for rejected hypotheses (an empty function accepts all hypotheses)
+        */
+      inline void
+      setHypothesisValidator (const HypothesisValidator &hypothesis_validator) { hypothesis_validator_ = hypothesis_validator; }
+
       /** \brief Specify the error function to minimize
        * \note This call is optional.  TruncatedError will be used by default
        * \param[in] error_functor a shared pointer to a subclass of SampleConsensusInitialAlignmentRegistration::ErrorFunctor
@@ -278,6 +299,9 @@ namespace dynamic_robot_localization
       /** \brief The KdTree used to compare feature descriptors. */
       FeatureKdTreePtr feature_tree_;               
 
+      /** \brief Optional function that rejects pose hypotheses before their evaluation */
+      HypothesisValidator hypothesis_validator_;
+
       /** */
       std::shared_ptr<ErrorFunctor> error_functor_;
 
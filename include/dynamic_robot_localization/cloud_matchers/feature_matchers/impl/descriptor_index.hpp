@@ -0,0 +1,574 @@
+/**\file descriptor_index.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_index.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <DescriptorIndex-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename FeatureT>
+void DescriptorIndex<FeatureT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	std::string final_param_name;
+	std::string search_namespace = private_node_handle->getNamespace() + "/" + configuration_namespace;
+
+	std::string index_type_name("kdtree_single");
+	if (ros::param::search(search_namespace, "descriptors_index_type", final_param_name)) { private_node_handle->param(final_param_name, index_type_name, std::string("kdtree_single")); }
+	if (!parseIndexType(index_type_name, index_type_)) {
+		ROS_WARN_STREAM("Unknown descriptors_index_type [" << index_type_name << "] -> using kdtree_single");
+		index_type_ = KdTreeSingle;
+	}
+
+	if (ros::param::search(search_namespace, "descriptors_index_number_of_randomized_trees", final_param_name)) { private_node_handle->param(final_param_name, number_of_randomized_trees_, 4); }
+	if (ros::param::search(search_namespace, "descriptors_index_kmeans_branching", final_param_name)) { private_node_handle->param(final_param_name, kmeans_branching_, 32); }
+	if (ros::param::search(search_namespace, "descriptors_index_kmeans_iterations", final_param_name)) { private_node_handle->param(final_param_name, kmeans_iterations_, 11); }
+	if (ros::param::search(search_namespace, "descriptors_index_number_of_checks", final_param_name)) { private_node_handle->param(final_param_name, number_of_checks_, 256); }
+	if (ros::param::search(search_namespace, "descriptors_index_compression_number_of_components", final_param_name)) { private_node_handle->param(final_param_name, compression_number_of_components_, 32); }
+	if (ros::param::search(search_namespace, "descriptors_index_compression_max_training_samples", final_param_name)) {
+		int compression_maximum_number_of_training_samples;
+		private_node_handle->param(final_param_name, compression_maximum_number_of_training_samples, 10000);
+		compression_maximum_number_of_training_samples_ = (size_t)std::max(compression_maximum_number_of_training_samples, 0);
+	}
+	if (ros::param::search(search_namespace, "descriptors_index_compression_number_of_lists", final_param_name)) { private_node_handle->param(final_param_name, compression_number_of_lists_, 0); }
+	if (ros::param::search(search_namespace, "descriptors_index_compression_number_of_probes", final_param_name)) { private_node_handle->param(final_param_name, compression_number_of_probes_, 8); }
+	if (ros::param::search(search_namespace, "descriptors_index_rerank_factor", final_param_name)) { private_node_handle->param(final_param_name, rerank_factor_, 4); }
+
+	double epsilon = 0.0;
+	if (ros::param::search(search_namespace, "descriptors_index_epsilon", final_param_name)) { private_node_handle->param(final_param_name, epsilon, 0.0); }
+	pcl::KdTree<FeatureT>::setEpsilon((float)epsilon);
+}
+
+
+template<typename FeatureT>
+bool DescriptorIndex<FeatureT>::parseIndexType(const std::string& index_type_name, IndexType& index_type) {
+	if (index_type_name == "kdtree_single") { index_type = KdTreeSingle; return true; }
+	if (index_type_name == "kdtree_randomized") { index_type = KdTreeRandomized; return true; }
+	if (index_type_name == "hierarchical_kmeans") { index_type = HierarchicalKMeans; return true; }
+	if (index_type_name == "pca_quantized") { index_type = PCAQuantized; return true; }
+	if (index_type_name == "pca_binary") { index_type = PCABinary; return true; }
+	return false;
+}
+
+
+template<typename FeatureT>
+void DescriptorIndex<FeatureT>::setInputCloud(const PointCloudConstPtr& cloud, const IndicesConstPtr& indices) {
+	index_.reset();
+	descriptors_data_.clear();
+	codes_.clear();
+	lists_centroids_.clear();
+	lists_offsets_.clear();
+	codes_positions_.clear();
+	index_mapping_.clear();
+	index_hash_ = 0;
+	index_loaded_from_file_ = false;
+	index_build_elapsed_time_ = 0;
+	pcl::KdTree<FeatureT>::input_ = cloud;
+	pcl::KdTree<FeatureT>::indices_ = indices;
+	if (!cloud || cloud->empty()) { total_number_of_points_ = 0; return; }
+
+	PerformanceTimer timer;
+	timer.start();
+
+	dimensions_ = pcl::KdTree<FeatureT>::point_representation_->getNumberOfDimensions();
+	size_t number_of_candidates = (indices && !indices->empty()) ? indices->size() : cloud->size();
+	descriptors_data_.resize(number_of_candidates * (size_t)dimensions_);
+	index_mapping_.reserve(number_of_candidates);
+	identity_mapping_ = !(indices && !indices->empty());
+
+	float* row = descriptors_data_.data();
+	for (size_t i = 0; i < number_of_candidates; ++i) {
+		int cloud_index = identity_mapping_ ? (int)i : (*indices)[i];
+		const FeatureT& descriptor = (*cloud)[cloud_index];
+		if (!pcl::KdTree<FeatureT>::point_representation_->isValid(descriptor)) {
+			identity_mapping_ = false;
+			continue;
+		}
+		pcl::KdTree<FeatureT>::point_representation_->copyToFloatArray(descriptor, row);
+		row += dimensions_;
+		index_mapping_.push_back(cloud_index);
+	}
+
+	total_number_of_points_ = (int)index_mapping_.size();
+	if (total_number_of_points_ == 0) {
+		PCL_ERROR("[DescriptorIndex::setInputCloud] Cannot create an index without valid descriptors!\n");
+		return;
+	}
+	index_hash_ = computeIndexHash();
+
+	if (isCompressed()) {
+		if (!index_load_filename_.empty()) {
+			index_loaded_from_file_ = loadCompressedIndex(index_load_filename_);
+			if (!index_loaded_from_file_) { ROS_WARN_STREAM("Failed to load the compressed descriptors index from file " << index_load_filename_ << " -> building a new index"); }
+		}
+
+		if (!index_loaded_from_file_ && !buildCompressedIndex()) {
+			PCL_ERROR("[DescriptorIndex::setInputCloud] Failed to train the descriptors compressor!\n");
+		}
+
+		// the codes replace the float descriptors (the exact re-ranking uses the descriptors in the input cloud)
+		std::vector<float>().swap(descriptors_data_);
+		index_build_elapsed_time_ = timer.getElapsedTimeInMilliSec();
+		ROS_DEBUG_STREAM("Compressed descriptors index with " << total_number_of_points_ << " descriptors (" << codes_.size() << " bytes of codes in " << getNumberOfLists() << " inverted lists) " << (index_loaded_from_file_ ? "loaded" : "built") << " in " << index_build_elapsed_time_ << " ms");
+		return;
+	}
+
+	flann::Matrix<float> descriptors_matrix(descriptors_data_.data(), index_mapping_.size(), dimensions_);
+
+	if (!index_load_filename_.empty()) {
+		if (!checkIndexFileHash(index_load_filename_)) {
+			ROS_WARN_STREAM("The descriptors index in file " << index_load_filename_ << " was not built for the current descriptors and index parameters -> building a new index");
+		} else {
+			try {
+				index_.reset(new FLANNIndex(descriptors_matrix, flann::SavedIndexParams(index_load_filename_)));
+				index_loaded_from_file_ = true;
+			} catch (std::exception& e) {
+				ROS_WARN_STREAM("Failed to load the descriptors index from file " << index_load_filename_ << " (" << e.what() << ") -> building a new index");
+				index_.reset();
+			}
+		}
+	}
+
+	if (!index_) {
+		index_.reset(new FLANNIndex(descriptors_matrix, createIndexParams()));
+		index_->buildIndex();
+	}
+
+	index_build_elapsed_time_ = timer.getElapsedTimeInMilliSec();
+	ROS_DEBUG_STREAM("Descriptors index with " << total_number_of_points_ << " descriptors " << (index_loaded_from_file_ ? "loaded" : "built") << " in " << index_build_elapsed_time_ << " ms");
+}
+
+
+template<typename FeatureT>
+int DescriptorIndex<FeatureT>::nearestKSearch(const FeatureT& point, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const {
+	k_indices.clear();
+	k_sqr_distances.clear();
+	if (!isBuilt() || k <= 0 || !pcl::KdTree<FeatureT>::point_representation_->isValid(point)) { return 0; }
+
+	k = std::min(k, total_number_of_points_);
+	std::vector<float> query(dimensions_);
+	pcl::KdTree<FeatureT>::point_representation_->copyToFloatArray(point, query.data());
+	if (isCompressed()) { return nearestKSearchCompressed(query, k, k_indices, k_sqr_distances); }
+
+	k_indices.resize(k);
+	k_sqr_distances.resize(k);
+
+	flann::Matrix<int> k_indices_matrix(k_indices.data(), 1, k);
+	flann::Matrix<float> k_distances_matrix(k_sqr_distances.data(), 1, k);
+	int number_of_neighbors = index_->knnSearch(flann::Matrix<float>(query.data(), 1, dimensions_), k_indices_matrix, k_distances_matrix, k, createSearchParams());
+	if (number_of_neighbors < k) {
+		k_indices.resize(std::max(number_of_neighbors, 0));
+		k_sqr_distances.resize(std::max(number_of_neighbors, 0));
+	}
+
+	mapIndices(k_indices);
+	return (int)k_indices.size();
+}
+
+
+template<typename FeatureT>
+int DescriptorIndex<FeatureT>::radiusSearch(const FeatureT& point, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn) const {
+	k_indices.clear();
+	k_sqr_distances.clear();
+	if (!isBuilt() || !pcl::KdTree<FeatureT>::point_representation_->isValid(point)) { return 0; }
+
+	std::vector<float> query(dimensions_);
+	pcl::KdTree<FeatureT>::point_representation_->copyToFloatArray(point, query.data());
+
+	if (isCompressed()) {
+		// the code distances are not a bound on the descriptors distances -> exact distances of the descriptors in the probed lists
+		std::vector< std::pair<float, int> > lists_distances;
+		size_t number_of_probes = selectListsToProbe(query, lists_distances);
+		float squared_radius = (float)(radius * radius);
+		std::vector<float> descriptor_buffer(dimensions_);
+		std::vector< std::pair<float, int> > neighbors;
+		for (size_t probe = 0; probe < number_of_probes; ++probe) {
+			int list = lists_distances[probe].second;
+			for (size_t code_position = lists_offsets_[list]; code_position < lists_offsets_[list + 1]; ++code_position) {
+				int index_position = codes_positions_[code_position];
+				float squared_distance = computeExactSquaredDistance(query, index_position, descriptor_buffer);
+				if (squared_distance <= squared_radius) { neighbors.push_back(std::make_pair(squared_distance, index_mapping_[index_position])); }
+			}
+		}
+		if (pcl::KdTree<FeatureT>::sorted_ || (max_nn > 0 && neighbors.size() > max_nn)) { std::sort(neighbors.begin(), neighbors.end()); }
+		if (max_nn > 0 && neighbors.size() > max_nn) { neighbors.resize(max_nn); }
+		k_indices.reserve(neighbors.size());
+		k_sqr_distances.reserve(neighbors.size());
+		for (size_t i = 0; i < neighbors.size(); ++i) {
+			k_sqr_distances.push_back(neighbors[i].first);
+			k_indices.push_back(neighbors[i].second);
+		}
+		return (int)k_indices.size();
+	}
+
+	flann::SearchParams search_params = createSearchParams();
+	search_params.max_neighbors = (max_nn == 0 || max_nn > (unsigned int)total_number_of_points_) ? -1 : (int)max_nn;
+
+	std::vector< std::vector<int> > indices(1);
+	std::vector< std::vector<float> > distances(1);
+	index_->radiusSearch(flann::Matrix<float>(query.data(), 1, dimensions_), indices, distances, (float)(radius * radius), search_params);
+
+	k_indices.swap(indices[0]);
+	k_sqr_distances.swap(distances[0]);
+	mapIndices(k_indices);
+	return (int)k_indices.size();
+}
+
+
+template<typename FeatureT>
+bool DescriptorIndex<FeatureT>::saveIndex(const std::string& filename) const {
+	if (!isBuilt() || filename.empty()) { return false; }
+	if (isCompressed()) { return saveCompressedIndex(filename); }
+	try {
+		index_->save(filename);
+	} catch (std::exception& e) {
+		ROS_WARN_STREAM("Failed to save the descriptors index to file " << filename << " (" << e.what() << ")");
+		return false;
+	}
+
+	// FLANN reads only its own data when loading the index, so the hash can be appended at the end of the file
+	const uint64_t hash_trailer[2] = { s_index_file_hash_marker_, index_hash_ };
+	std::ofstream output_stream(filename.c_str(), std::ios::binary | std::ios::app);
+	output_stream.write(reinterpret_cast<const char*>(hash_trailer), sizeof(hash_trailer));
+	return output_stream.good();
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </DescriptorIndex-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename FeatureT>
+flann::IndexParams DescriptorIndex<FeatureT>::createIndexParams() const {
+	switch (index_type_) {
+		case KdTreeRandomized: return flann::KDTreeIndexParams(std::max(number_of_randomized_trees_, 1));
+		case HierarchicalKMeans: return flann::KMeansIndexParams(std::max(kmeans_branching_, 2), kmeans_iterations_);
+		default: return flann::KDTreeSingleIndexParams(15); // same as pcl::KdTreeFLANN
+	}
+}
+
+
+template<typename FeatureT>
+flann::SearchParams DescriptorIndex<FeatureT>::createSearchParams() const {
+	flann::SearchParams search_params((index_type_ == KdTreeSingle || number_of_checks_ <= 0) ? flann::FLANN_CHECKS_UNLIMITED : number_of_checks_, pcl::KdTree<FeatureT>::epsilon_);
+	search_params.sorted = pcl::KdTree<FeatureT>::sorted_;
+	return search_params;
+}
+
+
+template<typename FeatureT>
+void DescriptorIndex<FeatureT>::mapIndices(std::vector<int>& k_indices) const {
+	if (identity_mapping_) { return; }
+	for (size_t i = 0; i < k_indices.size(); ++i) {
+		k_indices[i] = index_mapping_[k_indices[i]];
+	}
+}
+
+
+template<typename FeatureT>
+uint64_t DescriptorIndex<FeatureT>::computeIndexHash() const {
+	uint64_t hash = 14695981039346656037ULL;
+	auto combine = [&hash](uint64_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+	combine((uint64_t)index_type_);
+	combine((uint64_t)dimensions_);
+	switch (index_type_) {
+		case KdTreeRandomized: { combine((uint64_t)number_of_randomized_trees_); break; }
+		case HierarchicalKMeans: { combine((uint64_t)kmeans_branching_); combine((uint64_t)kmeans_iterations_); break; }
+		case PCAQuantized:
+		case PCABinary: {
+			combine((uint64_t)compression_number_of_components_);
+			combine((uint64_t)compression_maximum_number_of_training_samples_);
+			combine((uint64_t)compression_number_of_lists_);
+			combine((uint64_t)kmeans_iterations_);
+			break;
+		}
+		default: break;
+	}
+
+	combine((uint64_t)index_mapping_.size());
+	for (size_t i = 0; i < index_mapping_.size(); ++i) {
+		combine((uint64_t)index_mapping_[i]);
+	}
+
+	uint32_t value_bits;
+	for (size_t i = 0; i < index_mapping_.size() * (size_t)dimensions_; ++i) {
+		std::memcpy(&value_bits, &descriptors_data_[i], sizeof(uint32_t));
+		combine((uint64_t)value_bits);
+	}
+	return hash;
+}
+
+
+template<typename FeatureT>
+bool DescriptorIndex<FeatureT>::checkIndexFileHash(const std::string& filename) const {
+	std::ifstream input_stream(filename.c_str(), std::ios::binary | std::ios::ate);
+	if (!input_stream.is_open() || input_stream.tellg() < (std::streamoff)(2 * sizeof(uint64_t))) { return false; }
+	input_stream.seekg(-(std::streamoff)(2 * sizeof(uint64_t)), std::ios::end);
+	uint64_t hash_trailer[2] = { 0, 0 };
+	input_stream.read(reinterpret_cast<char*>(hash_trailer), sizeof(hash_trailer));
+	return input_stream.good() && hash_trailer[0] == s_index_file_hash_marker_ && hash_trailer[1] == index_hash_;
+}
+
+
+template<typename FeatureT>
+bool DescriptorIndex<FeatureT>::buildCompressedIndex() {
+	DescriptorCompressor::CodeType code_type = (index_type_ == PCABinary) ? DescriptorCompressor::Binary : DescriptorCompressor::Quantized8Bits;
+	if (!compressor_.train(descriptors_data_.data(), index_mapping_.size(), dimensions_, compression_number_of_components_, code_type, compression_maximum_number_of_training_samples_)) { return false; }
+	compressor_.encode(descriptors_data_.data(), index_mapping_.size(), codes_);
+	buildInvertedLists();
+	return true;
+}
+
+
+template<typename FeatureT>
+void DescriptorIndex<FeatureT>::buildInvertedLists() {
+	size_t number_of_descriptors = index_mapping_.size();
+	size_t number_of_components = (size_t)compressor_.getNumberOfComponents();
+	size_t code_size = compressor_.getCodeSize();
+
+	std::vector<float> projected_descriptors(number_of_descriptors * number_of_components);
+	#pragma omp parallel for schedule(static)
+	for (long i = 0; i < (long)number_of_descriptors; ++i) {
+		compressor_.project(descriptors_data_.data() + (size_t)i * dimensions_, projected_descriptors.data() + (size_t)i * number_of_components);
+	}
+
+	// coarse quantizer trained with k-means on the same evenly spaced samples used for the pca
+	size_t stride = (compression_maximum_number_of_training_samples_ > 0 && number_of_descriptors > compression_maximum_number_of_training_samples_) ?
+			(number_of_descriptors + compression_maximum_number_of_training_samples_ - 1) / compression_maximum_number_of_training_samples_ : 1;
+	std::vector<size_t> training_samples;
+	for (size_t i = 0; i < number_of_descriptors; i += stride) { training_samples.push_back(i); }
+
+	size_t number_of_lists = (compression_number_of_lists_ > 0) ? (size_t)compression_number_of_lists_ : (size_t)std::round(std::sqrt((double)number_of_descriptors));
+	number_of_lists = std::max((size_t)1, std::min(number_of_lists, training_samples.size()));
+
+	lists_centroids_.resize(number_of_lists * number_of_components);
+	for (size_t list = 0; list < number_of_lists; ++list) {
+		const float* sample = projected_descriptors.data() + training_samples[list * training_samples.size() / number_of_lists] * number_of_components;
+		std::copy(sample, sample + number_of_components, lists_centroids_.begin() + list * number_of_components);
+	}
+
+	std::vector<int> samples_lists(training_samples.size(), -1);
+	for (int iteration = 0; iteration < std::max(kmeans_iterations_, 1); ++iteration) {
+		size_t number_of_changed_samples = 0;
+		#pragma omp parallel for schedule(static) reduction(+:number_of_changed_samples)
+		for (long i = 0; i < (long)training_samples.size(); ++i) {
+			int list = findNearestList(projected_descriptors.data() + training_samples[i] * number_of_components);
+			if (list != samples_lists[i]) { samples_lists[i] = list; ++number_of_changed_samples; }
+		}
+		if (number_of_changed_samples == 0) { break; }
+
+		// empty lists keep their previous centroid
+		std::vector<double> lists_sums(number_of_lists * number_of_components, 0.0);
+		std::vector<size_t> lists_sizes(number_of_lists, 0);
+		for (size_t i = 0; i < training_samples.size(); ++i) {
+			const float* sample = projected_descriptors.data() + training_samples[i] * number_of_components;
+			double* list_sum = lists_sums.data() + (size_t)samples_lists[i] * number_of_components;
+			for (size_t c = 0; c < number_of_components; ++c) { list_sum[c] += sample[c]; }
+			++lists_sizes[samples_lists[i]];
+		}
+		for (size_t list = 0; list < number_of_lists; ++list) {
+			if (lists_sizes[list] == 0) { continue; }
+			for (size_t c = 0; c < number_of_components; ++c) {
+				lists_centroids_[list * number_of_components + c] = (float)(lists_sums[list * number_of_components + c] / (double)lists_sizes[list]);
+			}
+		}
+	}
+
+	std::vector<int> descriptors_lists(number_of_descriptors);
+	#pragma omp parallel for schedule(static)
+	for (long i = 0; i < (long)number_of_descriptors; ++i) {
+		descriptors_lists[i] = findNearestList(projected_descriptors.data() + (size_t)i * number_of_components);
+	}
+
+	// counting sort of the codes by list
+	lists_offsets_.assign(number_of_lists + 1, 0);
+	for (size_t i = 0; i < number_of_descriptors; ++i) { ++lists_offsets_[descriptors_lists[i] + 1]; }
+	for (size_t list = 0; list < number_of_lists; ++list) { lists_offsets_[list + 1] += lists_offsets_[list]; }
+
+	std::vector<size_t> insert_positions(lists_offsets_.begin(), lists_offsets_.end() - 1);
+	std::vector<uint8_t> sorted_codes(codes_.size());
+	codes_positions_.resize(number_of_descriptors);
+	for (size_t i = 0; i < number_of_descriptors; ++i) {
+		size_t code_position = insert_positions[descriptors_lists[i]]++;
+		std::copy(codes_.begin() + i * code_size, codes_.begin() + (i + 1) * code_size, sorted_codes.begin() + code_position * code_size);
+		codes_positions_[code_position] = (int)i;
+	}
+	codes_.swap(sorted_codes);
+}
+
+
+template<typename FeatureT>
+bool DescriptorIndex<FeatureT>::loadCompressedIndex(const std::string& filename) {
+	std::ifstream input_stream(filename.c_str(), std::ios::binary);
+	if (!input_stream.is_open() || !compressor_.load(input_stream)) { return false; }
+
+	uint64_t number_of_codes = 0;
+	uint64_t index_hash = 0;
+	input_stream.read(reinterpret_cast<char*>(&number_of_codes), sizeof(uint64_t));
+	input_stream.read(reinterpret_cast<char*>(&index_hash), sizeof(uint64_t));
+	bool expected_code_type = (compressor_.getCodeType() == DescriptorCompressor::Binary) == (index_type_ == PCABinary);
+	if (!input_stream.good() || !expected_code_type || compressor_.getDimensions() != dimensions_ || number_of_codes != (uint64_t)index_mapping_.size()) { return false; }
+	if (index_hash != index_hash_) {
+		ROS_WARN_STREAM("The compressed descriptors index in file " << filename << " was not built for the current descriptors and compression parameters");
+		return false;
+	}
+
+	codes_.resize((size_t)number_of_codes * compressor_.getCodeSize());
+	input_stream.read(reinterpret_cast<char*>(codes_.data()), codes_.size());
+
+	uint64_t number_of_lists = 0;
+	input_stream.read(reinterpret_cast<char*>(&number_of_lists), sizeof(uint64_t));
+	if (!input_stream.good() || number_of_lists == 0 || number_of_lists > number_of_codes) { codes_.clear(); return false; }
+
+	lists_centroids_.resize((size_t)number_of_lists * (size_t)compressor_.getNumberOfComponents());
+	std::vector<uint64_t> lists_offsets((size_t)number_of_lists + 1);
+	std::vector<int32_t> codes_positions((size_t)number_of_codes);
+	input_stream.read(reinterpret_cast<char*>(lists_centroids_.data()), sizeof(float) * lists_centroids_.size());
+	input_stream.read(reinterpret_cast<char*>(lists_offsets.data()), sizeof(uint64_t) * lists_offsets.size());
+	input_stream.read(reinterpret_cast<char*>(codes_positions.data()), sizeof(int32_t) * codes_positions.size());
+
+	bool valid_lists = input_stream.good() && lists_offsets.front() == 0 && lists_offsets.back() == number_of_codes && std::is_sorted(lists_offsets.begin(), lists_offsets.end());
+	for (size_t i = 0; valid_lists && i < codes_positions.size(); ++i) {
+		valid_lists = codes_positions[i] >= 0 && (uint64_t)codes_positions[i] < number_of_codes;
+	}
+	if (!valid_lists) {
+		codes_.clear();
+		lists_centroids_.clear();
+		return false;
+	}
+
+	lists_offsets_.assign(lists_offsets.begin(), lists_offsets.end());
+	codes_positions_.assign(codes_positions.begin(), codes_positions.end());
+	return true;
+}
+
+
+template<typename FeatureT>
+bool DescriptorIndex<FeatureT>::saveCompressedIndex(const std::string& filename) const {
+	std::ofstream output_stream(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if (!output_stream.is_open() || !compressor_.save(output_stream)) {
+		ROS_WARN_STREAM("Failed to save the compressed descriptors index to file " << filename);
+		return false;
+	}
+
+	uint64_t number_of_codes = (uint64_t)index_mapping_.size();
+	output_stream.write(reinterpret_cast<const char*>(&number_of_codes), sizeof(uint64_t));
+	output_stream.write(reinterpret_cast<const char*>(&index_hash_), sizeof(uint64_t));
+	output_stream.write(reinterpret_cast<const char*>(codes_.data()), codes_.size());
+
+	uint64_t number_of_lists = (uint64_t)getNumberOfLists();
+	std::vector<uint64_t> lists_offsets(lists_offsets_.begin(), lists_offsets_.end());
+	std::vector<int32_t> codes_positions(codes_positions_.begin(), codes_positions_.end());
+	output_stream.write(reinterpret_cast<const char*>(&number_of_lists), sizeof(uint64_t));
+	output_stream.write(reinterpret_cast<const char*>(lists_centroids_.data()), sizeof(float) * lists_centroids_.size());
+	output_stream.write(reinterpret_cast<const char*>(lists_offsets.data()), sizeof(uint64_t) * lists_offsets.size());
+	output_stream.write(reinterpret_cast<const char*>(codes_positions.data()), sizeof(int32_t) * codes_positions.size());
+	return output_stream.good();
+}
+
+
+template<typename FeatureT>
+int DescriptorIndex<FeatureT>::nearestKSearchCompressed(const std::vector<float>& query, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const {
+	size_t code_size = compressor_.getCodeSize();
+	std::vector<uint8_t> query_code(code_size);
+	compressor_.encode(query.data(), query_code.data());
+
+	std::vector< std::pair<float, int> > lists_distances;
+	size_t number_of_probes = selectListsToProbe(query, lists_distances);
+
+	// max heap with the best candidates according to the code distance (lists beyond the number of probes are scanned only until there are enough candidates)
+	size_t number_of_candidates = std::min((size_t)total_number_of_points_, (size_t)k * (size_t)std::max(rerank_factor_, 1));
+	std::vector< std::pair<uint32_t, int> > candidates;
+	candidates.reserve(number_of_candidates + 1);
+	for (size_t probe = 0; probe < lists_distances.size() && (probe < number_of_probes || candidates.size() < number_of_candidates); ++probe) {
+		int list = lists_distances[probe].second;
+		const uint8_t* code = codes_.data() + lists_offsets_[list] * code_size;
+		for (size_t code_position = lists_offsets_[list]; code_position < lists_offsets_[list + 1]; ++code_position, code += code_size) {
+			uint32_t code_distance = compressor_.computeDistance(query_code.data(), code);
+			if (candidates.size() < number_of_candidates) {
+				candidates.push_back(std::make_pair(code_distance, codes_positions_[code_position]));
+				std::push_heap(candidates.begin(), candidates.end());
+			} else if (code_distance < candidates.front().first) {
+				std::pop_heap(candidates.begin(), candidates.end());
+				candidates.back() = std::make_pair(code_distance, codes_positions_[code_position]);
+				std::push_heap(candidates.begin(), candidates.end());
+			}
+		}
+	}
+
+	// exact re-ranking
+	std::vector<float> descriptor_buffer(dimensions_);
+	std::vector< std::pair<float, int> > reranked_candidates(candidates.size());
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		reranked_candidates[i] = std::make_pair(computeExactSquaredDistance(query, candidates[i].second, descriptor_buffer), candidates[i].second);
+	}
+	size_t number_of_neighbors = std::min((size_t)k, reranked_candidates.size());
+	std::partial_sort(reranked_candidates.begin(), reranked_candidates.begin() + number_of_neighbors, reranked_candidates.end());
+
+	k_indices.resize(number_of_neighbors);
+	k_sqr_distances.resize(number_of_neighbors);
+	for (size_t i = 0; i < number_of_neighbors; ++i) {
+		k_sqr_distances[i] = reranked_candidates[i].first;
+		k_indices[i] = index_mapping_[reranked_candidates[i].second];
+	}
+	return (int)number_of_neighbors;
+}
+
+
+template<typename FeatureT>
+float DescriptorIndex<FeatureT>::computeExactSquaredDistance(const std::vector<float>& query, int index_position, std::vector<float>& descriptor_buffer) const {
+	pcl::KdTree<FeatureT>::point_representation_->copyToFloatArray((*pcl::KdTree<FeatureT>::input_)[index_mapping_[index_position]], descriptor_buffer.data());
+	return s_computeSquaredDistance(query.data(), descriptor_buffer.data(), dimensions_);
+}
+
+
+template<typename FeatureT>
+float DescriptorIndex<FeatureT>::s_computeSquaredDistance(const float* a, const float* b, int dimensions) {
+	float squared_distance = 0.0f;
+	for (int d = 0; d < dimensions; ++d) {
+		float difference = a[d] - b[d];
+		squared_distance += difference * difference;
+	}
+	return squared_distance;
+}
+
+
+template<typename FeatureT>
+int DescriptorIndex<FeatureT>::findNearestList(const float* projected_descriptor) const {
+	int number_of_components = compressor_.getNumberOfComponents();
+	int nearest_list = 0;
+	float nearest_squared_distance = std::numeric_limits<float>::max();
+	for (size_t list = 0; list < lists_centroids_.size() / (size_t)number_of_components; ++list) {
+		float squared_distance = s_computeSquaredDistance(projected_descriptor, lists_centroids_.data() + list * number_of_components, number_of_components);
+		if (squared_distance < nearest_squared_distance) {
+			nearest_squared_distance = squared_distance;
+			nearest_list = (int)list;
+		}
+	}
+	return nearest_list;
+}
+
+
+template<typename FeatureT>
+size_t DescriptorIndex<FeatureT>::selectListsToProbe(const std::vector<float>& query, std::vector< std::pair<float, int> >& lists_distances) const {
+	size_t number_of_lists = getNumberOfLists();
+	int number_of_components = compressor_.getNumberOfComponents();
+	std::vector<float> projected_query(number_of_components);
+	compressor_.project(query.data(), projected_query.data());
+
+	lists_distances.resize(number_of_lists);
+	for (size_t list = 0; list < number_of_lists; ++list) {
+		lists_distances[list] = std::make_pair(s_computeSquaredDistance(projected_query.data(), lists_centroids_.data() + list * number_of_components, number_of_components), (int)list);
+	}
+	std::sort(lists_distances.begin(), lists_distances.end());
+	return (compression_number_of_probes_ <= 0) ? number_of_lists : std::min((size_t)compression_number_of_probes_, number_of_lists);
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
@@ -29,6 +29,20 @@ void FeatureMatcher<PointT, FeatureT>::setupConfigurationFromParameterServer(ros
 	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_filename_, std::string("")); }
 	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_save_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_save_filename_, std::string("")); }
 	if (ros::param::search(search_namespace, "save_descriptors_in_binary_format", final_param_name)) { private_node_handle->param(final_param_name, save_descriptors_in_binary_format_, true); }
+	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_index_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_index_filename_, std::string("")); }
+	if (ros::param::search(search_namespace, "reference_pointcloud_descriptors_index_save_filename", final_param_name)) { private_node_handle->param(final_param_name, reference_pointcloud_descriptors_index_save_filename_, std::string("")); }
+
+	if (ros::param::search(search_namespace, "pose_prior_gating", final_param_name)) { private_node_handle->param(final_param_name, pose_prior_gating_, false); }
+	if (ros::param::search(search_namespace, "pose_prior_gating_fallback_to_global_search", final_param_name)) { private_node_handle->param(final_param_name, pose_prior_gating_fallback_to_global_search_, true); }
+	double pose_prior_translation_uncertainty_x = 1.0, pose_prior_translation_uncertainty_y = 1.0, pose_prior_translation_uncertainty_z = 0.0, pose_prior_rotation_uncertainty = 0.5;
+	if (ros::param::search(search_namespace, "pose_prior_translation_uncertainty_x", final_param_name)) { private_node_handle->param(final_param_name, pose_prior_translation_uncertainty_x, 1.0); }
+	if (ros::param::search(search_namespace, "pose_prior_translation_uncertainty_y", final_param_name)) { private_node_handle->param(final_param_name, pose_prior_translation_uncertainty_y, 1.0); }
+	if (ros::param::search(search_namespace, "pose_prior_translation_uncertainty_z", final_param_name)) { private_node_handle->param(final_param_name, pose_prior_translation_uncertainty_z, 0.0); }
+	if (ros::param::search(search_namespace, "pose_prior_rotation_uncertainty", final_param_name)) { private_node_handle->param(final_param_name, pose_prior_rotation_uncertainty, 0.5); }
+	setPosePriorUncertainty(Eigen::Vector3f((float)pose_prior_translation_uncertainty_x, (float)pose_prior_translation_uncertainty_y, (float)pose_prior_translation_uncertainty_z), (float)pose_prior_rotation_uncertainty);
+
+	reference_descriptors_index_->setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+	setMatcherDescriptorsSearchMethod(reference_descriptors_index_);
 
 	CloudMatcher<PointT>::setDisplayCloudAligment(display_feature_matching);
 
@@ -60,10 +74,12 @@ void FeatureMatcher<PointT, FeatureT>::setupReferenceCloud(typename pcl::PointCl
 	}
 
 	typename pcl::PointCloud<FeatureT>::Ptr reference_descriptors(new pcl::PointCloud<FeatureT>());
+	bool reference_descriptors_loaded_from_file = false;
 	if (reference_pointcloud_descriptors_filename_.empty() || !pointcloud_conversions::fromFile(*reference_descriptors, reference_pointcloud_descriptors_filename_, reference_pointclouds_database_folder_path_)) {
 		if (keypoint_descriptor_) // must be set previously
 			reference_descriptors = keypoint_descriptor_->computeKeypointsDescriptors(reference_cloud_final, reference_cloud, search_method);
 	} else {
+		reference_descriptors_loaded_from_file = true;
 		ROS_INFO_STREAM("Loaded " << reference_descriptors->size() << " keypoint descriptors from file " << reference_pointcloud_descriptors_filename_);
 	}
 
@@ -72,7 +88,21 @@ void FeatureMatcher<PointT, FeatureT>::setupReferenceCloud(typename pcl::PointCl
 		pcl::io::savePCDFile<FeatureT>(reference_pointcloud_descriptors_save_filename_, *reference_descriptors, save_descriptors_in_binary_format_);
 	}
 
-	setMatcherReferenceDescriptors(reference_descriptors);
+	// a saved index is only valid for the descriptors from which it was built
+	reference_descriptors_index_->setIndexLoadFilename((reference_descriptors_loaded_from_file && !reference_pointcloud_descriptors_index_filename_.empty()) ?
+			pointcloud_utils::parseFilePath(reference_pointcloud_descriptors_index_filename_, reference_pointclouds_database_folder_path_) : std::string(""));
+
+	reference_descriptors_ = reference_descriptors;
+	setMatcherReferenceDescriptors(reference_descriptors); // builds (or loads) the descriptors index
+
+	if (reference_descriptors_index_->isIndexLoadedFromFile()) {
+		ROS_INFO_STREAM("Loaded reference pointcloud descriptors index from file " << reference_pointcloud_descriptors_index_filename_);
+	}
+
+	if (!reference_pointcloud_descriptors_index_save_filename_.empty() && !reference_descriptors->empty()) {
+		ROS_INFO_STREAM("Saving reference pointcloud descriptors index to file " << reference_pointcloud_descriptors_index_save_filename_);
+		reference_descriptors_index_->saveIndex(reference_pointcloud_descriptors_index_save_filename_);
+	}
 }
 
 
@@ -91,6 +121,96 @@ void FeatureMatcher<PointT, FeatureT>::processKeypoints(typename pcl::PointCloud
 	setMatcherAmbientDescriptors(ambient_descriptors);
 	CloudMatcher<PointT>::setMatchOnlyKeypoints(true);
 }
+
+
+template<typename PointT, typename FeatureT>
+void FeatureMatcher<PointT, FeatureT>::setPosePrior(const tf2::Transform& pose_prior) {
+	Eigen::Transform<float, 3, Eigen::Affine> pose_prior_eigen = laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<float>(pose_prior);
+	pose_prior_position_ = pose_prior_eigen.translation();
+	pose_prior_rotation_ = pose_prior_eigen.linear();
+	pose_prior_available_ = true;
+}
+
+
+template<typename PointT, typename FeatureT>
+bool FeatureMatcher<PointT, FeatureT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+		typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+		tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints) {
+	if (!pose_prior_gating_ || !pose_prior_available_ || !reference_descriptors_ || reference_descriptors_->empty()) {
+		return CloudMatcher<PointT>::registerCloud(ambient_pointcloud, ambient_pointcloud_search_method, pointcloud_keypoints, best_pose_correction_out, accepted_pose_corrections_out, pointcloud_registered_out, return_aligned_keypoints);
+	}
+
+	typename pcl::KdTree<FeatureT>::Ptr gated_descriptors_search_method;
+	bool registration_successful = false;
+	if (computeGatedDescriptorsSearchMethod(pointcloud_keypoints->empty() ? ambient_pointcloud : pointcloud_keypoints, gated_descriptors_search_method)) {
+		setMatcherDescriptorsSearchMethod(gated_descriptors_search_method);
+		setMatcherHypothesisValidator([this](const Eigen::Matrix4f& pose_correction) { return isTransformationConsistentWithPosePrior(pose_correction); });
+		registration_successful = CloudMatcher<PointT>::registerCloud(ambient_pointcloud, ambient_pointcloud_search_method, pointcloud_keypoints, best_pose_correction_out, accepted_pose_corrections_out, pointcloud_registered_out, return_aligned_keypoints);
+		setMatcherHypothesisValidator(std::function<bool (const Eigen::Matrix4f&)>());
+		setMatcherDescriptorsSearchMethod(reference_descriptors_index_); // already built for the reference descriptors
+	}
+
+	if (!registration_successful && pose_prior_gating_fallback_to_global_search_) {
+		ROS_DEBUG("Pose prior gated feature matching failed -> performing global feature matching");
+		registration_successful = CloudMatcher<PointT>::registerCloud(ambient_pointcloud, ambient_pointcloud_search_method, pointcloud_keypoints, best_pose_correction_out, accepted_pose_corrections_out, pointcloud_registered_out, return_aligned_keypoints);
+	}
+
+	return registration_successful;
+}
+
+
+template<typename PointT, typename FeatureT>
+bool FeatureMatcher<PointT, FeatureT>::computeGatedDescriptorsSearchMethod(const typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, typename pcl::KdTree<FeatureT>::Ptr& gated_descriptors_search_method_out) {
+	typename pcl::Registration<PointT, PointT>::Ptr cloud_matcher = CloudMatcher<PointT>::getCloudMatcher();
+	if (!cloud_matcher || !cloud_matcher->getInputTarget() || cloud_matcher->getInputTarget()->size() != reference_descriptors_->size() || ambient_pointcloud->empty()) { return false; }
+
+	// the reference keypoints that can be observed from the region of the ellipsoid are within the sensor range plus the position uncertainty
+	float sensor_range_squared = 0.0f;
+	for (size_t i = 0; i < ambient_pointcloud->size(); ++i) {
+		sensor_range_squared = std::max(sensor_range_squared, ((*ambient_pointcloud)[i].getVector3fMap() - pose_prior_position_).squaredNorm());
+	}
+	float sensor_range = std::sqrt(sensor_range_squared);
+	Eigen::Vector3f reachable_region_inverse_semi_axes;
+	for (int axis = 0; axis < 3; ++axis) {
+		reachable_region_inverse_semi_axes(axis) = 1.0f / (sensor_range + std::max(pose_prior_translation_uncertainty_(axis), 0.0f) + 1e-6f);
+	}
+
+	const typename pcl::PointCloud<PointT>& reference_keypoints = *cloud_matcher->getInputTarget();
+	pcl::IndicesPtr reachable_indices(new std::vector<int>());
+	reachable_indices->reserve(reference_keypoints.size());
+	for (size_t i = 0; i < reference_keypoints.size(); ++i) {
+		Eigen::Vector3f offset_in_prior_frame = pose_prior_rotation_.transpose() * (reference_keypoints[i].getVector3fMap() - pose_prior_position_);
+		if (offset_in_prior_frame.cwiseProduct(reachable_region_inverse_semi_axes).squaredNorm() <= 1.0f) {
+			reachable_indices->push_back((int)i);
+		}
+	}
+
+	ROS_DEBUG_STREAM("Pose prior gating selected " << reachable_indices->size() << " of " << reference_keypoints.size() << " reference keypoints");
+	if (reachable_indices->size() < 3) { return false; }
+
+	// the gated subsets are small, so an exact kd-tree is built for them
+	gated_descriptors_search_method_out.reset(new pcl::KdTreeFLANN<FeatureT>());
+	gated_descriptors_search_method_out->setInputCloud(reference_descriptors_, reachable_indices);
+	return true;
+}
+
+
+template<typename PointT, typename FeatureT>
+bool FeatureMatcher<PointT, FeatureT>::isTransformationConsistentWithPosePrior(const Eigen::Matrix4f& pose_correction) const {
+	if (pose_prior_rotation_uncertainty_ > 0.0f && Eigen::AngleAxisf(Eigen::Matrix3f(pose_correction.block<3, 3>(0, 0))).angle() > pose_prior_rotation_uncertainty_) { return false; }
+
+	Eigen::Vector3f corrected_position = pose_correction.block<3, 3>(0, 0) * pose_prior_position_ + pose_correction.block<3, 1>(0, 3);
+	Eigen::Vector3f displacement_in_prior_frame = pose_prior_rotation_.transpose() * (corrected_position - pose_prior_position_);
+	float normalized_squared_distance = 0.0f;
+	for (int axis = 0; axis < 3; ++axis) {
+		if (pose_prior_translation_uncertainty_(axis) > 0.0f) {
+			float normalized_displacement = displacement_in_prior_frame(axis) / pose_prior_translation_uncertainty_(axis);
+			normalized_squared_distance += normalized_displacement * normalized_displacement;
+		}
+	}
+	return normalized_squared_distance <= 1.0f;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </FeatureMatcher-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
@@ -218,11 +218,13 @@ dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT,
   final_transformation_ = guess;
   int i_iter = 0;
   converged_ = false;
+  bool lowest_error_initialized = false;
   if (!guess.isApprox (Eigen::Matrix4f::Identity (), 0.01f)) 
   {
     // If guess is not the Identity matrix we check it.
 	pcl::transformPointCloudWithNormals (*input_, input_transformed, final_transformation_);
     lowest_error = computeErrorMetric (input_transformed, static_cast<float> (corr_dist_threshold_));
+    lowest_error_initialized = true;
     i_iter = 1;
   }
 
@@ -237,14 +239,19 @@ dynamic_robot_localization::SampleConsensusInitialAlignmentRegistration<PointT,
     // Estimate the transform from the samples to their corresponding points
     transformation_estimation_->estimateRigidTransformation (*input_, sample_indices, *target_, corresponding_indices, transformation_);
 
+    // Skip the evaluation of rejected hypotheses
+    if (hypothesis_validator_ && !hypothesis_validator_ (transformation_))
+      continue;
+
     // Tranform the data and compute the error
     pcl::transformPointCloudWithNormals (*input_, input_transformed, transformation_);
     error = computeErrorMetric (input_transformed, static_cast<float> (corr_dist_threshold_));
 
     // If the new error is lower, update the final transformation
-    if (i_iter == 0 || error < lowest_error)
+    if (!lowest_error_initialized || error < lowest_error)
     {
       lowest_error = error;
+      lowest_error_initialized = true;
       final_transformation_ = transformation_;
       converged_=true;
 
@@ -60,6 +60,18 @@ void SampleConsensusInitialAlignment<PointT, FeatureT>::setMatcherAmbientDescrip
 	matcher_scia_->setSourceFeatures(ambient_descriptors);
 	matcher_scia_->setNumberOfSamples(std::min(number_of_samples_, (int)ambient_descriptors->size()));
 }
+
+
+template<typename PointT, typename FeatureT>
+void SampleConsensusInitialAlignment<PointT, FeatureT>::setMatcherDescriptorsSearchMethod(typename pcl::KdTree<FeatureT>::Ptr descriptors_search_method) {
+	matcher_scia_->setFeatureSearchMethod(descriptors_search_method);
+}
+
+
+template<typename PointT, typename FeatureT>
+void SampleConsensusInitialAlignment<PointT, FeatureT>::setMatcherHypothesisValidator(const std::function<bool (const Eigen::Matrix4f&)>& hypothesis_validator) {
+	matcher_scia_->setHypothesisValidator(hypothesis_validator);
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </SampleConsensusInitialAlignment-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
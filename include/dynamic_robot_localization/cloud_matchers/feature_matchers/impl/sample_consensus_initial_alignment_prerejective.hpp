@@ -57,6 +57,22 @@ void SampleConsensusInitialAlignmentPrerejective<PointT, FeatureT>::setupConfigu
 	private_node_handle->param(configuration_namespace + "correspondence_randomness", correspondence_randomness, 3);
 	matcher_scia_->setCorrespondenceRandomness(correspondence_randomness);
 
+	int number_of_threads;
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads, 0);
+	matcher_scia_->setNumberOfThreads(number_of_threads);
+
+	int random_seed;
+	private_node_handle->param(configuration_namespace + "random_seed", random_seed, 0);
+	matcher_scia_->setRandomSeed((unsigned int)random_seed);
+
+	double confidence;
+	private_node_handle->param(configuration_namespace + "confidence", confidence, -1.0);
+	matcher_scia_->setConfidence(confidence);
+
+	double early_termination_inlier_fraction;
+	private_node_handle->param(configuration_namespace + "early_termination_inlier_fraction", early_termination_inlier_fraction, -1.0);
+	matcher_scia_->setEarlyTerminationInlierFraction(early_termination_inlier_fraction);
+
 	FeatureMatcher<PointT, FeatureT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
 }
 
@@ -72,6 +88,18 @@ void SampleConsensusInitialAlignmentPrerejective<PointT, FeatureT>::setMatcherAm
 	matcher_scia_->setSourceFeatures(ambient_descriptors);
 	matcher_scia_->setNumberOfSamples(std::min(number_of_samples_, (int)ambient_descriptors->size()));
 }
+
+
+template<typename PointT, typename FeatureT>
+void SampleConsensusInitialAlignmentPrerejective<PointT, FeatureT>::setMatcherDescriptorsSearchMethod(typename pcl::KdTree<FeatureT>::Ptr descriptors_search_method) {
+	matcher_scia_->setFeatureSearchMethod(descriptors_search_method);
+}
+
+
+template<typename PointT, typename FeatureT>
+void SampleConsensusInitialAlignmentPrerejective<PointT, FeatureT>::setMatcherHypothesisValidator(const std::function<bool (const Eigen::Matrix4f&)>& hypothesis_validator) {
+	matcher_scia_->setHypothesisValidator(hypothesis_validator);
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </SampleConsensusInitialAlignmentPrerejective-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
@@ -68,66 +68,75 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::selectSamples(
-        const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices) {
+        const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices, std::vector<char> &selected_points_flags, std::mt19937 &random_number_generator) {
 	if (nr_samples > static_cast<int>(cloud.size())) {
 		PCL_ERROR("[pcl::%s::selectSamples] ", getClassName().c_str());
 		PCL_ERROR("The number of samples (%d) must not be greater than the number of points (%lu)!\n", nr_samples, cloud.size());
 		return;
 	}
 
-	sample_indices.resize(nr_samples);
-	int temp_sample;
+	sample_indices.clear();
+	sample_indices.reserve(nr_samples);
+	selected_points_flags.resize(cloud.size(), 0);
 
-	// Draw random samples until n samples is reached
-	for (int i = 0; i < nr_samples; i++) {
-		// Select a random number
-		sample_indices[i] = getRandomIndex(static_cast<int>(cloud.size()) - i);
-
-		// Run trough list of numbers, starting at the lowest, to avoid duplicates
-		for (int j = 0; j < i; j++) {
-			// Move value up if it is higher than previous selections to ensure true randomness
-			if (sample_indices[i] >= sample_indices[j]) {
-				sample_indices[i]++;
-			} else {
-				// The new number is lower, place it at the correct point and break for a sorted list
-				temp_sample = sample_indices[i];
-				for (int k = i; k > j; k--)
-					sample_indices[k] = sample_indices[k - 1];
-
-				sample_indices[j] = temp_sample;
-				break;
-			}
+	// Draw random samples until n samples is reached (the flags avoid duplicates without searching the previous selections)
+	while (static_cast<int>(sample_indices.size()) < nr_samples) {
+		int sample_index = getRandomIndex(static_cast<int>(cloud.size()), random_number_generator);
+		if (!selected_points_flags[sample_index]) {
+			selected_points_flags[sample_index] = 1;
+			sample_indices.push_back(sample_index);
 		}
 	}
+
+	for (size_t i = 0; i < sample_indices.size(); ++i) {
+		selected_points_flags[sample_indices[i]] = 0;
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::findSimilarFeatures(
-        const std::vector<int> &sample_indices, std::vector<int> &corresponding_indices) {
+        const std::vector<int> &sample_indices, std::vector<int> &corresponding_indices, std::mt19937 &random_number_generator) {
 	// Allocate results
 	corresponding_indices.resize(sample_indices.size(), 0);
-	int k = std::min(k_correspondences_, (int)target_features_->size());
-	std::vector<int> similar_features(k);
-	std::vector<float> nn_distances(k);
 
-	// Loop over the sampled features
+	// Pick one of the precomputed most similar target features of each sample
 	for (size_t i = 0; i < sample_indices.size(); ++i) {
-		// Current feature index
 		const int idx = sample_indices[i];
-
-		int number_k_found = feature_tree_->nearestKSearch(*input_features_, idx, k, similar_features, nn_distances);
+		const int number_k_found = number_of_similar_features_[idx];
 
 		if (number_k_found > 0) {
-			if (k == 1)
+			const int* similar_features = &similar_features_table_[(size_t)idx * similar_features_table_k_];
+			if (number_k_found == 1)
 				corresponding_indices[i] = similar_features[0];
 			else
-				corresponding_indices[i] = similar_features[getRandomIndex(number_k_found)];
+				corresponding_indices[i] = similar_features[getRandomIndex(number_k_found, random_number_generator)];
 		} else {
 			corresponding_indices[i] = 0;
 		}
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeSimilarFeaturesTable() {
+	similar_features_table_k_ = std::max(1, std::min(k_correspondences_, (int)target_features_->size()));
+	similar_features_table_.assign(input_features_->size() * (size_t)similar_features_table_k_, 0);
+	number_of_similar_features_.assign(input_features_->size(), 0);
+
+	#pragma omp parallel num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	{
+		std::vector<int> similar_features(similar_features_table_k_);
+		std::vector<float> nn_distances(similar_features_table_k_);
+
+		#pragma omp for schedule(dynamic, 64)
+		for (int idx = 0; idx < (int)input_features_->size(); ++idx) {
+			int number_k_found = feature_tree_->nearestKSearch(*input_features_, idx, similar_features_table_k_, similar_features, nn_distances);
+			number_k_found = std::max(0, std::min(number_k_found, similar_features_table_k_));
+			number_of_similar_features_[idx] = number_k_found;
+			std::copy(similar_features.begin(), similar_features.begin() + number_k_found, similar_features_table_.begin() + (size_t)idx * similar_features_table_k_);
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointSource, typename PointTarget, typename FeatureT> void SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeTransformation(
         PointCloudSource &output, const Eigen::Matrix4f& guess) {
@@ -184,6 +193,9 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 
 	convergence_timer_.reset();
 
+	// The k most similar target features of each source feature are searched only once per alignment
+	computeSimilarFeaturesTable();
+
 	// Initialize prerejector (similarity threshold already set to default value in constructor)
 	/*correspondence_rejector_poly_->setInputSource(input_);
 	correspondence_rejector_poly_->setInputTarget(target_);
@@ -365,23 +377,34 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 
 #else //-----------------------------------------------------------------------------------------------------------------------------------
 
-	//double highest_inlier_fraction = 0.0;
 	accepted_transformations_->clear();
 
-	#pragma omp parallel for
-	for (int i = 0; i < max_iterations_; ++i) {
-		if (convergence_timer_.getTimeSeconds() > convergence_time_limit_seconds_) {
-			continue;
-		}
+	// the hypotheses are claimed by the threads from a shared counter, and the bound on the number of hypotheses
+	// shrinks when a better inlier fraction is found (adaptive number of iterations and early termination)
+	std::atomic<int> next_hypothesis(0);
+	std::atomic<int> number_of_hypotheses_bound(max_iterations_);
+	std::atomic<int> number_of_generated_hypotheses(0);
+	double highest_inlier_fraction = 0.0;
 
-		//		if (highest_inlier_fraction < 0.99) {
-			std::vector<int> sample_indices, corresponding_indices;
+	#pragma omp parallel num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	{
+		std::vector<int> sample_indices, corresponding_indices;
+		std::vector<char> selected_points_flags(input_->size(), 0);
+		std::mt19937 random_number_generator;
+
+		for (int hypothesis = next_hypothesis++; hypothesis < number_of_hypotheses_bound.load(); hypothesis = next_hypothesis++) {
+			if (convergence_timer_.getTimeSeconds() > convergence_time_limit_seconds_) {
+				break;
+			}
+
+			++number_of_generated_hypotheses;
+			random_number_generator.seed(random_seed_ + static_cast<unsigned int>(hypothesis));
 
 			// Draw nr_samples_ random samples
-			selectSamples(*input_, nr_samples_, sample_indices);
+			selectSamples(*input_, nr_samples_, sample_indices, selected_points_flags, random_number_generator);
 
 			// Find corresponding features in the target cloud
-			findSimilarFeatures(sample_indices, corresponding_indices);
+			findSimilarFeatures(sample_indices, corresponding_indices, random_number_generator);
 
 			// Apply prerejection
 			/*if (!correspondence_rejector_poly_->thresholdPolygon (sample_indices, corresponding_indices)) {
@@ -424,6 +447,9 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 				//			#pragma omp critical
 				transformation_estimation.estimateRigidTransformation(*input_, *target_, *filtered_corrs, transformation);
 
+				// Skip the evaluation of rejected hypotheses
+				if (hypothesis_validator_ && !hypothesis_validator_(transformation)) continue;
+
 				// Transform the input dataset using the final transformation
 				PointCloudSource input_transformed;
 				pcl::transformPointCloudWithNormals(*input_, input_transformed, transformation);
@@ -435,6 +461,8 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 				getFitness(input_transformed, inliers, error);
 
 				if (inliers.size() > 2) {
+					// geometric fraction of the source points aligned by the hypothesis, which is used as an estimate of the correspondences inlier ratio in the adaptive number of iterations
+					// (it is usually higher than the inlier ratio of the feature correspondences, so with ambiguous features the bound is optimistic and confidence should be set conservatively)
 					double current_inlier_fraction = 0.0;
 					if (!input_->empty()) {
 						current_inlier_fraction = static_cast<double>(inliers.size()) / static_cast<double>(input_->size());
@@ -455,18 +483,28 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 					if (current_inlier_fraction >= inlier_fraction_ && error < inlier_rmse_) {
 						accepted_transformations_->push_back(transformation);
 						if (error < lowest_error) {
-							//highest_inlier_fraction = current_inlier_fraction;
 							inliers_ = inliers;
 							lowest_error = error;
 							converged_ = true;
 							final_transformation_ = transformation;
 							transformation_ = transformation;
 						}
+
+						if (current_inlier_fraction > highest_inlier_fraction) {
+							highest_inlier_fraction = current_inlier_fraction;
+							if (early_termination_inlier_fraction_ > 0.0 && highest_inlier_fraction >= early_termination_inlier_fraction_) {
+								number_of_hypotheses_bound = 0;
+							} else if (confidence_ > 0.0) {
+								number_of_hypotheses_bound = std::min(number_of_hypotheses_bound.load(), computeAdaptiveNumberOfIterations(highest_inlier_fraction));
+							}
+						}
 					}
 				}
 			}
-//		}
+		}
 	}
+
+	number_of_generated_hypotheses_ = number_of_generated_hypotheses;
 #endif //--------------------------------------------------------------------------------------------------------------------------------
 
 
@@ -476,7 +514,21 @@ template<typename PointSource, typename PointTarget, typename FeatureT> void Sam
 	if (converged_) pcl::transformPointCloudWithNormals(*input_, output, final_transformation_);
 
 	// Debug output
-	PCL_DEBUG("[pcl::%s::computeTransformation] Accepted %i out of %i generated pose hypotheses.\n", getClassName().c_str(), accepted_transformations_->size(), max_iterations_);
+	PCL_DEBUG("[pcl::%s::computeTransformation] Accepted %zu out of %i generated pose hypotheses.\n", getClassName().c_str(), accepted_transformations_->size(), number_of_generated_hypotheses_);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget, typename FeatureT> int SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeAdaptiveNumberOfIterations(
+		double inlier_fraction) const {
+	if (confidence_ <= 0.0 || confidence_ >= 1.0 || inlier_fraction <= 0.0) { return max_iterations_; }
+	if (inlier_fraction >= 1.0) { return 1; }
+
+	double probability_of_outlier_sample = 1.0 - std::pow(inlier_fraction, std::max(nr_samples_, 1));
+	if (probability_of_outlier_sample <= 0.0) { return 1; }
+
+	double number_of_iterations = std::ceil(std::log(1.0 - confidence_) / std::log(probability_of_outlier_sample));
+	if (!std::isfinite(number_of_iterations) || number_of_iterations >= static_cast<double>(max_iterations_)) { return max_iterations_; }
+	return std::max(1, static_cast<int>(number_of_iterations));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
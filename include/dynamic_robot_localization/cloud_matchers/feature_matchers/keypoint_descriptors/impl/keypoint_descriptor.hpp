@@ -36,6 +36,14 @@ void KeypointDescriptor<PointT, FeatureT>::setupConfigurationFromParameterServer
 		} else {
 			feature_descriptor_->setRadiusSearch(0.0);
 		}
+
+		// descriptor specific parameters are read from configuration_namespace, while the search parameters may be inherited from parent namespaces
+		std::stringstream configuration;
+		configuration << typeid(*this).name() << "|" << feature_descriptor_->getKSearch() << "|" << feature_descriptor_->getRadiusSearch();
+		XmlRpc::XmlRpcValue descriptor_parameters;
+		if (private_node_handle->getParam(configuration_namespace, descriptor_parameters)) { configuration << "|" << descriptor_parameters.toXml(); }
+		configuration_hash_ = std::hash<std::string>()(configuration.str());
+		cached_descriptors_.clear();
 	}
 }
 
@@ -48,16 +56,79 @@ typename pcl::PointCloud<FeatureT>::Ptr KeypointDescriptor<PointT, FeatureT>::co
 	typename pcl::PointCloud<FeatureT>::Ptr descriptors(new pcl::PointCloud<FeatureT>());
 
 	if (feature_descriptor_) {
+		std::lock_guard<std::mutex> lock(cached_descriptors_mutex_);
+		size_t keypoints_hash = 0, surface_hash = 0;
+		if (maximum_number_of_cached_descriptors_ > 0) {
+			keypoints_hash = s_computePointCloudHash(*pointcloud_keypoints);
+			surface_hash = (surface == pointcloud_keypoints) ? keypoints_hash : s_computePointCloudHash(*surface);
+			for (size_t i = 0; i < cached_descriptors_.size(); ++i) {
+				if (cached_descriptors_[i].keypoints_hash == keypoints_hash && cached_descriptors_[i].surface_hash == surface_hash) {
+					ROS_DEBUG_STREAM("Reusing " << cached_descriptors_[i].descriptors->size() << " descriptors previously computed for the same keypoints and surface");
+					return cached_descriptors_[i].descriptors;
+				}
+			}
+		}
+
 		ROS_DEBUG_STREAM("Computing descriptors for " << pointcloud_keypoints->size() << " keypoints");
 		feature_descriptor_->setSearchMethod(surface_search_method);
 		feature_descriptor_->setSearchSurface(surface);
 		feature_descriptor_->setInputCloud(pointcloud_keypoints);
 		feature_descriptor_->compute(*descriptors);
 		ROS_DEBUG_STREAM("Finished computation of " << pointcloud_keypoints->size() << " descriptors");
+
+		if (maximum_number_of_cached_descriptors_ > 0) {
+			if (cached_descriptors_.size() >= maximum_number_of_cached_descriptors_) { cached_descriptors_.erase(cached_descriptors_.begin()); }
+			cached_descriptors_.push_back(CachedDescriptors { keypoints_hash, surface_hash, descriptors });
+		}
 	}
 
 	return descriptors;
 }
+
+
+template<typename PointT, typename FeatureT>
+typename KeypointDescriptor<PointT, FeatureT>::Ptr KeypointDescriptor<PointT, FeatureT>::s_getSharedKeypointDescriptor(const typename KeypointDescriptor<PointT, FeatureT>::Ptr& keypoint_descriptor) {
+	static std::map< size_t, std::weak_ptr< KeypointDescriptor<PointT, FeatureT> > > s_keypoint_descriptors_registry;
+	static std::mutex s_keypoint_descriptors_registry_mutex;
+
+	if (!keypoint_descriptor || keypoint_descriptor->getConfigurationHash() == 0) { return keypoint_descriptor; }
+
+	std::lock_guard<std::mutex> lock(s_keypoint_descriptors_registry_mutex);
+	typename KeypointDescriptor<PointT, FeatureT>::Ptr shared_keypoint_descriptor = s_keypoint_descriptors_registry[keypoint_descriptor->getConfigurationHash()].lock();
+	if (shared_keypoint_descriptor) {
+		ROS_DEBUG_STREAM("Sharing keypoint descriptor with configuration hash " << keypoint_descriptor->getConfigurationHash());
+		return shared_keypoint_descriptor;
+	}
+
+	s_keypoint_descriptors_registry[keypoint_descriptor->getConfigurationHash()] = keypoint_descriptor;
+	return keypoint_descriptor;
+}
+
+
+template<typename PointT, typename FeatureT>
+size_t KeypointDescriptor<PointT, FeatureT>::s_computePointCloudHash(const pcl::PointCloud<PointT>& pointcloud) {
+	// FNV-1a over the raw point data (64 bits at a time), the size and the timestamp
+	uint64_t hash = 14695981039346656037ULL;
+	auto combine = [&hash](uint64_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+	combine((uint64_t)pointcloud.size());
+	combine((uint64_t)pointcloud.header.stamp);
+
+	if (!pointcloud.empty()) {
+		const unsigned char* data = reinterpret_cast<const unsigned char*>(pointcloud.points.data());
+		size_t number_of_bytes = pointcloud.size() * sizeof(PointT);
+		size_t number_of_words = number_of_bytes / sizeof(uint64_t);
+		uint64_t word;
+		for (size_t i = 0; i < number_of_words; ++i) {
+			std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(uint64_t));
+			combine(word);
+		}
+		word = 0;
+		std::memcpy(&word, data + number_of_words * sizeof(uint64_t), number_of_bytes - number_of_words * sizeof(uint64_t));
+		combine(word);
+	}
+
+	return (size_t)hash;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </KeypointDescriptor-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
@@ -18,10 +18,78 @@ namespace dynamic_robot_localization {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PFHEstimationOMP-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointInT, typename PointNT, typename PointOutT>
+void PFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature(PointCloudOut &output) {
+	const int histogram_size = this->nr_subdiv_ * this->nr_subdiv_ * this->nr_subdiv_;
+	const int number_of_keypoints = (int)this->indices_->size();
+	const bool input_is_dense = this->input_->is_dense;
+	bool output_is_dense = true;
+
+	#pragma omp parallel num_threads(parallel_utils::getNumberOfThreads(number_of_threads_)) reduction(&&: output_is_dense)
+	{
+		std::vector<int> neighbors_indices(this->k_);
+		std::vector<float> neighbors_distances(this->k_);
+		Eigen::VectorXf pfh_histogram(histogram_size);
+
+		#pragma omp for schedule(dynamic, 16)
+		for (int idx = 0; idx < number_of_keypoints; ++idx) {
+			if ((!input_is_dense && !pcl::isFinite((*this->input_)[(*this->indices_)[idx]])) ||
+					this->searchForNeighbors((*this->indices_)[idx], this->search_parameter_, neighbors_indices, neighbors_distances) == 0) {
+				std::fill(output.points[idx].histogram, output.points[idx].histogram + histogram_size, std::numeric_limits<float>::quiet_NaN());
+				output_is_dense = false;
+				continue;
+			}
+
+			computePointPFHSignature(neighbors_indices, pfh_histogram);
+			std::copy(pfh_histogram.data(), pfh_histogram.data() + histogram_size, output.points[idx].histogram);
+		}
+	}
+
+	output.is_dense = output_is_dense;
+}
+
+
+template<typename PointInT, typename PointNT, typename PointOutT>
+void PFHEstimationOMP<PointInT, PointNT, PointOutT>::computePointPFHSignature(const std::vector<int>& neighbors_indices, Eigen::VectorXf& pfh_histogram) const {
+	// same binning as pcl::PFHEstimation::computePointPFHSignature
+	const pcl::PointCloud<PointInT>& cloud = *this->surface_;
+	const pcl::PointCloud<PointNT>& normals = *this->normals_;
+	const int nr_split = this->nr_subdiv_;
+	pfh_histogram.setZero();
+	float hist_incr = 100.0f / static_cast<float>(neighbors_indices.size() * (neighbors_indices.size() - 1) / 2);
+	float f1, f2, f3, f4;
+
+	for (size_t i_idx = 0; i_idx < neighbors_indices.size(); ++i_idx) {
+		const int i = neighbors_indices[i_idx];
+		if (!pcl::isFinite(cloud[i])) { continue; }
+		for (size_t j_idx = 0; j_idx < i_idx; ++j_idx) {
+			const int j = neighbors_indices[j_idx];
+			if (!pcl::isFinite(cloud[j])) { continue; }
+			if (!pcl::computePairFeatures(cloud[i].getVector4fMap(), normals[i].getNormalVector4fMap(), cloud[j].getVector4fMap(), normals[j].getNormalVector4fMap(), f1, f2, f3, f4)) { continue; }
+
+			int f_index_0 = std::min(std::max(static_cast<int>(std::floor(nr_split * ((f1 + M_PI) * this->d_pi_))), 0), nr_split - 1);
+			int f_index_1 = std::min(std::max(static_cast<int>(std::floor(nr_split * ((f2 + 1.0) * 0.5))), 0), nr_split - 1);
+			int f_index_2 = std::min(std::max(static_cast<int>(std::floor(nr_split * ((f3 + 1.0) * 0.5))), 0), nr_split - 1);
+			pfh_histogram[f_index_0 + nr_split * (f_index_1 + nr_split * f_index_2)] += hist_incr;
+		}
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PFHEstimationOMP-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PFH-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT, typename FeatureT>
 void PFH<PointT, FeatureT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
-	typename pcl::PFHEstimation<PointT, PointT, FeatureT>::Ptr feature_descriptor(new pcl::PFHEstimation<PointT, PointT, FeatureT>());
+	int number_of_threads;
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads, 0);
+
+	typename pcl::PFHEstimation<PointT, PointT, FeatureT>::Ptr feature_descriptor;
+	if (number_of_threads == 1) {
+		feature_descriptor.reset(new pcl::PFHEstimation<PointT, PointT, FeatureT>());
+	} else {
+		feature_descriptor.reset(new PFHEstimationOMP<PointT, PointT, FeatureT>(number_of_threads));
+	}
 
 	bool use_internal_cache;
 	private_node_handle->param(configuration_namespace + "use_internal_cache", use_internal_cache, true);
@@ -9,8 +9,16 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <typeinfo>
+#include <vector>
 
 // ROS includes
 #include <ros/ros.h>
@@ -28,7 +36,9 @@
 namespace dynamic_robot_localization {
 // #########################################################################   keypoint_descriptor   ###########################################################################
 /**
- * \brief Description...
+ * \brief Base class of the keypoint descriptors.
+ * Descriptors with the same configuration are shared between feature matchers (s_getSharedKeypointDescriptor), and the last computed descriptors are reused
+ * while the keypoints and the search surface remain the same, which avoids recomputing the reference and ambient descriptors in each feature matcher.
  */
 template <typename PointT, typename FeatureT>
 class KeypointDescriptor : public ConfigurableObject {
@@ -40,7 +50,7 @@ class KeypointDescriptor : public ConfigurableObject {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		KeypointDescriptor() {}
+		KeypointDescriptor() : configuration_hash_(0), maximum_number_of_cached_descriptors_(2) {}
 		virtual ~KeypointDescriptor() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -49,20 +59,36 @@ class KeypointDescriptor : public ConfigurableObject {
 		virtual typename pcl::PointCloud<FeatureT>::Ptr computeKeypointsDescriptors(typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
 				typename pcl::PointCloud<PointT>::Ptr& surface,
 				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method);
+
+		/** Returns a previously registered descriptor with the same configuration hash (or registers keypoint_descriptor and returns it) */
+		static typename KeypointDescriptor<PointT, FeatureT>::Ptr s_getSharedKeypointDescriptor(const typename KeypointDescriptor<PointT, FeatureT>::Ptr& keypoint_descriptor);
+		static size_t s_computePointCloudHash(const pcl::PointCloud<PointT>& pointcloud);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </KeypointDescriptor-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		const typename pcl::Feature<PointT, FeatureT>::Ptr getFeatureDescriptor() { return feature_descriptor_; }
+		size_t getConfigurationHash() const { return configuration_hash_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		void setFeatureDescriptor(const typename pcl::Feature<PointT, FeatureT>::Ptr& feature_descriptor) { feature_descriptor_ = feature_descriptor; }
+		void setMaximumNumberOfCachedDescriptors(size_t maximum_number_of_cached_descriptors) { maximum_number_of_cached_descriptors_ = maximum_number_of_cached_descriptors; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		struct CachedDescriptors {
+			size_t keypoints_hash;
+			size_t surface_hash;
+			typename pcl::PointCloud<FeatureT>::Ptr descriptors;
+		};
+
 		typename pcl::Feature<PointT, FeatureT>::Ptr feature_descriptor_;
+		size_t configuration_hash_;
+		size_t maximum_number_of_cached_descriptors_;
+		std::vector<CachedDescriptors> cached_descriptors_; // most recent last
+		std::mutex cached_descriptors_mutex_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
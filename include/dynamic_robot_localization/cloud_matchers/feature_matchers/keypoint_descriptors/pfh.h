@@ -9,8 +9,12 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 // ROS includes
 #include <ros/ros.h>
@@ -24,11 +28,43 @@
 // external libs includes
 #include <Eigen/Core>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // project includes
+#include <dynamic_robot_localization/common/parallel_utils.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/keypoint_descriptors/keypoint_descriptor_from_normals.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
+// ############################################################################   pfh_estimation_omp   ##########################################################################
+/**
+ * \brief Multi-threaded version of pcl::PFHEstimation.
+ * Each keypoint is processed by a single thread (using its own neighbors and histogram buffers) and its signature is stored at the keypoint index,
+ * which gives the same output as the serial estimation regardless of the number of threads (the pair features cache of pcl::PFHEstimation is not used, because it is not thread safe).
+ */
+template <typename PointInT, typename PointNT, typename PointOutT = pcl::PFHSignature125>
+class PFHEstimationOMP : public pcl::PFHEstimation<PointInT, PointNT, PointOutT> {
+	public:
+		using Ptr = std::shared_ptr< PFHEstimationOMP<PointInT, PointNT, PointOutT> >;
+		using ConstPtr = std::shared_ptr< const PFHEstimationOMP<PointInT, PointNT, PointOutT> >;
+		using PointCloudOut = typename pcl::Feature<PointInT, PointOutT>::PointCloudOut;
+
+		PFHEstimationOMP(int number_of_threads = 0) : number_of_threads_(number_of_threads) { pcl::Feature<PointInT, PointOutT>::feature_name_ = "PFHEstimationOMP"; }
+		virtual ~PFHEstimationOMP() {}
+
+		/** Number of OpenMP threads (<= 0 -> number of processors) */
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+
+	protected:
+		virtual void computeFeature(PointCloudOut &output);
+		void computePointPFHSignature(const std::vector<int>& neighbors_indices, Eigen::VectorXf& pfh_histogram) const;
+
+		int number_of_threads_;
+};
+
+
 // ##################################################################################   pfh   ##################################################################################
 /**
  * \brief Description...
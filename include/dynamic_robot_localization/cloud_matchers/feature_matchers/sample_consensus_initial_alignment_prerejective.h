@@ -48,6 +48,8 @@ class SampleConsensusInitialAlignmentPrerejective : public FeatureMatcher<PointT
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
 		virtual void setMatcherReferenceDescriptors(typename pcl::PointCloud<FeatureT>::Ptr& reference_descriptors);
 		virtual void setMatcherAmbientDescriptors(typename pcl::PointCloud<FeatureT>::Ptr& ambient_descriptors);
+		virtual void setMatcherDescriptorsSearchMethod(typename pcl::KdTree<FeatureT>::Ptr descriptors_search_method);
+		virtual void setMatcherHypothesisValidator(const std::function<bool (const Eigen::Matrix4f&)>& hypothesis_validator);
 		virtual std::shared_ptr< std::vector< typename pcl::Registration<PointT, PointT>::Matrix4> > getAcceptedTransformations() { return matcher_scia_->getAcceptedTransformations(); }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </SampleConsensusInitialAlignmentPrerejective-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
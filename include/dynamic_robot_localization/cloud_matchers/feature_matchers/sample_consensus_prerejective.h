@@ -42,9 +42,15 @@
 #define PCL_REGISTRATION_SAMPLE_CONSENSUS_PREREJECTIVE_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <random>
 #include <pcl/registration/registration.h>
+#include <pcl/kdtree/kdtree.h>
+#include <pcl/kdtree/kdtree_flann.h>
 #include <pcl/registration/transformation_estimation_svd.h>
 #include <pcl/registration/transformation_validation.h>
 #include <pcl/features/board.h>
@@ -65,6 +71,7 @@
 #include <pcl/common/point_tests.h>
 #include <pcl/common/time.h>
 #include <Eigen/Core>
+#include <dynamic_robot_localization/common/parallel_utils.h>
 
 
 #ifdef _OPENMP
@@ -135,7 +142,8 @@ namespace dynamic_robot_localization
       using Ptr = std::shared_ptr<SampleConsensusPrerejective<PointSource, PointTarget, FeatureT> >;
       using ConstPtr = std::shared_ptr<const SampleConsensusPrerejective<PointSource, PointTarget, FeatureT> >;
 
-      using FeatureKdTreePtr = typename pcl::KdTreeFLANN<FeatureT>::Ptr;
+      using FeatureKdTreePtr = typename pcl::KdTree<FeatureT>::Ptr;
+      using HypothesisValidator = std::function<bool (const Matrix4&)>;
 
       using CorrespondenceRejectorPoly = pcl::registration::CorrespondenceRejectorPoly<PointSource, PointTarget>;
       using CorrespondenceRejectorPolyPtr = typename CorrespondenceRejectorPoly::Ptr;
@@ -153,6 +161,12 @@ namespace dynamic_robot_localization
         , inlier_rmse_(0.0f)
         , accepted_transformations_(new std::vector<Matrix4>())
         , convergence_time_limit_seconds_(std::numeric_limits<double>::max())
+        , number_of_threads_(0)
+        , random_seed_(0)
+        , confidence_(-1.0)
+        , early_termination_inlier_fraction_(-1.0)
+        , number_of_generated_hypotheses_(0)
+        , similar_features_table_k_(0)
       {
         reg_name_ = "SampleConsensusPrerejective";
         correspondence_rejector_poly_->setSimilarityThreshold (0.6f);
@@ -224,6 +238,23 @@ namespace dynamic_robot_localization
         return (k_correspondences_);
       }
 
+      /** \brief Provide the search method used to find the most similar target feature descriptors (pcl::KdTreeFLANN by default)
+        * \param feature_tree the search method (its input cloud is set to the target features, unless it was already built for them)
+        */
+      inline void
+      setFeatureSearchMethod (const FeatureKdTreePtr &feature_tree)
+      {
+        feature_tree_ = feature_tree;
+        if (target_features_ && feature_tree_->getInputCloud () != target_features_)
+          feature_tree_->setInputCloud (target_features_);
+      }
+
+      /** \brief Provide a function that rejects pose hypotheses before their evaluation (for example, hypotheses inconsistent with a pose prior)
+        * \param hypothesis_validator returns false for rejected hypotheses (an empty function accepts all hypotheses)
+        */
+      inline void
+      setHypothesisValidator (const HypothesisValidator &hypothesis_validator) { hypothesis_validator_ = hypothesis_validator; }
+
       /** \brief Set the similarity threshold in [0,1[ between edge lengths of the underlying polygonal correspondence rejector object,
        * where 1 is a perfect match
        * \param similarity_threshold edge length similarity threshold
@@ -282,34 +313,63 @@ namespace dynamic_robot_localization
 
       inline void setConvergenceTimeLimitSeconds(double convergence_time_limit_seconds) { convergence_time_limit_seconds_ = convergence_time_limit_seconds; }
 
+      /** \brief Set the number of threads that generate and score pose hypotheses (<= 0 -> number of processors) */
+      inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+
+      /** \brief Set the seed of the random number generators (each hypothesis uses its own generator, seeded with random_seed + hypothesis index,
+        * which makes the generated hypotheses independent of the number of threads)
+        */
+      inline void setRandomSeed(unsigned int random_seed) { random_seed_ = random_seed; }
+
+      /** \brief Set the probability [0,1[ of generating at least one hypothesis from inliers, used to adapt the number of iterations to the best inlier fraction found so far (<= 0 -> disabled) */
+      inline void setConfidence(double confidence) { confidence_ = confidence; }
+
+      /** \brief Stop generating hypotheses once an accepted hypothesis reaches this inlier fraction (<= 0 -> disabled) */
+      inline void setEarlyTerminationInlierFraction(double early_termination_inlier_fraction) { early_termination_inlier_fraction_ = early_termination_inlier_fraction; }
+
+      /** \brief Number of pose hypotheses generated in the last alignment */
+      inline int getNumberOfGeneratedHypotheses() const { return number_of_generated_hypotheses_; }
+
     protected:
       /** \brief Choose a random index between 0 and n-1
         * \param n the number of possible indices to choose from
         */
       inline int 
-      getRandomIndex (int n) const
+      getRandomIndex (int n, std::mt19937 &random_number_generator) const
       {
-        return (static_cast<int> (n * (rand () / (RAND_MAX + 1.0))));
+        return (std::uniform_int_distribution<int> (0, n - 1) (random_number_generator));
       };
 
-      /** \brief Select \a nr_samples sample points from cloud while making sure that their pairwise distances are 
-        * greater than a user-defined minimum distance, \a min_sample_distance.
+      /** \brief Select \a nr_samples distinct random sample points from cloud.
         * \param cloud the input point cloud
         * \param nr_samples the number of samples to select
         * \param sample_indices the resulting sample indices
+        * \param selected_points_flags per thread workspace with cloud.size() elements set to 0 (it is restored before returning)
+        * \param random_number_generator the generator of the current hypothesis
         */
       void 
-      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices);
+      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices,
+              std::vector<char> &selected_points_flags, std::mt19937 &random_number_generator);
 
-      /** \brief For each of the sample points, find a list of points in the target cloud whose features are similar to 
-        * the sample points' features. From these, select one randomly which will be considered that sample point's 
+      /** \brief For each of the sample points, select randomly one of the points in the target cloud whose features are the most similar
+        * to the sample points' features (from the table filled by computeSimilarFeaturesTable), which will be considered that sample point's
         * correspondence.
         * \param sample_indices the indices of each sample point
         * \param corresponding_indices the resulting indices of each sample's corresponding point in the target cloud
         */
       void 
       findSimilarFeatures (const std::vector<int> &sample_indices,
-              std::vector<int> &corresponding_indices);
+              std::vector<int> &corresponding_indices, std::mt19937 &random_number_generator);
+
+      /** \brief Searches (in parallel) the k_correspondences_ most similar target features of every source feature, filling the
+        * table indexed by the RANSAC iterations (avoids repeating the same feature kd-tree queries in every hypothesis)
+        */
+      void
+      computeSimilarFeaturesTable ();
+
+      /** \brief Number of iterations required to draw at least one hypothesis from inliers with probability confidence_, given the inlier fraction of the best hypothesis (samples of nr_samples_ correspondences) */
+      int
+      computeAdaptiveNumberOfIterations (double inlier_fraction) const;
 
       /** \brief Rigid transformation computation method.
         * \param output the transformed input point cloud dataset using the rigid transformation found
@@ -344,6 +404,9 @@ namespace dynamic_robot_localization
       /** \brief The KdTree used to compare feature descriptors. */
       FeatureKdTreePtr feature_tree_;
 
+      /** \brief Optional function that rejects pose hypotheses before their evaluation */
+      HypothesisValidator hypothesis_validator_;
+
       /** \brief The polygonal correspondence rejector used for prerejection */
       CorrespondenceRejectorPolyPtr correspondence_rejector_poly_;
 
@@ -359,6 +422,17 @@ namespace dynamic_robot_localization
 
       pcl::StopWatch convergence_timer_;
       double convergence_time_limit_seconds_;
+
+      int number_of_threads_;
+      unsigned int random_seed_;
+      double confidence_;
+      double early_termination_inlier_fraction_;
+      int number_of_generated_hypotheses_;
+
+      /** \brief Row major table with the indices of the similar_features_table_k_ most similar target features of each source feature */
+      std::vector<int> similar_features_table_;
+      std::vector<int> number_of_similar_features_;
+      int similar_features_table_k_;
   };
 
 } /* namespace dynamic_robot_localization */
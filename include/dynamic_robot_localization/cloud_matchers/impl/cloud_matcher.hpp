@@ -153,6 +153,10 @@ void CloudMatcher<PointT>::setupConfigurationFromParameterServer(ros::NodeHandle
 
 		std::string transformation_estimation_method;
 		if (ros::param::search(search_namespace, "transformation_estimation_approach", final_param_name)) { private_node_handle->param(final_param_name, transformation_estimation_method, std::string("")); }
+		int transformation_estimation_number_of_threads = 0;
+		if (ros::param::search(search_namespace, "transformation_estimation_number_of_threads", final_param_name)) { private_node_handle->param(final_param_name, transformation_estimation_number_of_threads, 0); }
+		int transformation_estimation_lm_max_number_of_iterations = 20;
+		if (ros::param::search(search_namespace, "transformation_estimation_lm_max_number_of_iterations", final_param_name)) { private_node_handle->param(final_param_name, transformation_estimation_lm_max_number_of_iterations, 20); }
 		if (transformation_estimation_method == "TransformationEstimation2D") {
 			transformation_estimation_approach_ = TransformationEstimation2D;
 			transformation_estimation_ptr_ = typename pcl::registration::TransformationEstimation<PointT, PointT, float>::Ptr(new TransformationEstimation2DTimed<PointT, PointT, float>());
@@ -162,6 +166,12 @@ void CloudMatcher<PointT>::setupConfigurationFromParameterServer(ros::NodeHandle
 		} else if (transformation_estimation_method == "TransformationEstimationLM") {
 			transformation_estimation_approach_ = TransformationEstimationLM;
 			transformation_estimation_ptr_ = typename pcl::registration::TransformationEstimation<PointT, PointT, float>::Ptr(new TransformationEstimationLMTimed<PointT, PointT, float>());
+		} else if (transformation_estimation_method == "TransformationEstimationLMAnalytic") {
+			transformation_estimation_approach_ = TransformationEstimationLMAnalytic;
+			typename TransformationEstimationLMAnalyticTimed<PointT, PointT, float>::Ptr estimator(new TransformationEstimationLMAnalyticTimed<PointT, PointT, float>());
+			estimator->setNumberOfThreads(transformation_estimation_number_of_threads);
+			estimator->setMaximumIterations(transformation_estimation_lm_max_number_of_iterations);
+			transformation_estimation_ptr_ = estimator;
 		} else if (transformation_estimation_method == "TransformationEstimationPointToPlane") {
 			transformation_estimation_approach_ = TransformationEstimationPointToPlane;
 			transformation_estimation_ptr_ = typename pcl::registration::TransformationEstimation<PointT, PointT, float>::Ptr(new TransformationEstimationPointToPlaneTimed<PointT, PointT, float>());
@@ -171,9 +181,31 @@ void CloudMatcher<PointT>::setupConfigurationFromParameterServer(ros::NodeHandle
 		} else if (transformation_estimation_method == "TransformationEstimationPointToPlaneLLSWeighted") {
 			transformation_estimation_approach_ = TransformationEstimationPointToPlaneLLSWeighted;
 			transformation_estimation_ptr_ = typename pcl::registration::TransformationEstimation<PointT, PointT, float>::Ptr(new TransformationEstimationPointToPlaneLLSWeightedTimed<PointT, PointT, float>());
+		} else if (transformation_estimation_method == "TransformationEstimationPointToPlaneLLSParallel") {
+			transformation_estimation_approach_ = TransformationEstimationPointToPlaneLLSParallel;
+			typename TransformationEstimationPointToPlaneLLSParallelTimed<PointT, PointT, float>::Ptr estimator(new TransformationEstimationPointToPlaneLLSParallelTimed<PointT, PointT, float>());
+			estimator->setNumberOfThreads(transformation_estimation_number_of_threads);
+			transformation_estimation_ptr_ = estimator;
+		} else if (transformation_estimation_method == "TransformationEstimationPointToPlaneLLSWeightedParallel") {
+			transformation_estimation_approach_ = TransformationEstimationPointToPlaneLLSWeightedParallel;
+			typename TransformationEstimationPointToPlaneLLSWeightedParallelTimed<PointT, PointT, float>::Ptr estimator(new TransformationEstimationPointToPlaneLLSWeightedParallelTimed<PointT, PointT, float>());
+			estimator->setNumberOfThreads(transformation_estimation_number_of_threads);
+			transformation_estimation_ptr_ = estimator;
+		} else if (transformation_estimation_method == "TransformationEstimationPointToPlaneLMAnalytic") {
+			transformation_estimation_approach_ = TransformationEstimationPointToPlaneLMAnalytic;
+			typename TransformationEstimationPointToPlaneLMAnalyticTimed<PointT, PointT, float>::Ptr estimator(new TransformationEstimationPointToPlaneLMAnalyticTimed<PointT, PointT, float>());
+			estimator->setNumberOfThreads(transformation_estimation_number_of_threads);
+			estimator->setMaximumIterations(transformation_estimation_lm_max_number_of_iterations);
+			transformation_estimation_ptr_ = estimator;
 		} else if (transformation_estimation_method == "TransformationEstimationPointToPlaneWeighted") {
 			transformation_estimation_approach_ = TransformationEstimationPointToPlaneWeighted;
 			transformation_estimation_ptr_ = typename pcl::registration::TransformationEstimation<PointT, PointT, float>::Ptr(new TransformationEstimationPointToPlaneWeightedTimed<PointT, PointT, float>());
+		} else if (transformation_estimation_method == "TransformationEstimationPointToPlaneWeightedLMAnalytic") {
+			transformation_estimation_approach_ = TransformationEstimationPointToPlaneWeightedLMAnalytic;
+			typename TransformationEstimationPointToPlaneWeightedLMAnalyticTimed<PointT, PointT, float>::Ptr estimator(new TransformationEstimationPointToPlaneWeightedLMAnalyticTimed<PointT, PointT, float>());
+			estimator->setNumberOfThreads(transformation_estimation_number_of_threads);
+			estimator->setMaximumIterations(transformation_estimation_lm_max_number_of_iterations);
+			transformation_estimation_ptr_ = estimator;
 		} else if (transformation_estimation_method == "TransformationEstimationSVD") {
 			transformation_estimation_approach_ = TransformationEstimationSVD;
 			transformation_estimation_ptr_ = typename pcl::registration::TransformationEstimation<PointT, PointT, float>::Ptr(new TransformationEstimationSVDTimed<PointT, PointT, float>());
@@ -300,7 +332,9 @@ bool CloudMatcher<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr&
 	cloud_align_time_ms_ = 0;
 	PerformanceTimer performance_timer;
 	performance_timer.start();
-	cloud_matcher_->align(*pointcloud_registered_out);
+	Eigen::Matrix4f initial_guess = Eigen::Matrix4f::Identity();
+	computeRegistrationInitialGuess(initial_guess);
+	cloud_matcher_->align(*pointcloud_registered_out, initial_guess);
 	cloud_align_time_ms_ = performance_timer.getElapsedTimeInMilliSec();
 
 	Eigen::Matrix4f final_transformation = cloud_matcher_->getFinalTransformation();
@@ -356,8 +390,7 @@ bool CloudMatcher<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr&
 template<typename PointT>
 bool CloudMatcher<PointT>::postProcessRegistrationMatrix(typename pcl::PointCloud<PointT>::Ptr &ambient_pointcloud, const Eigen::Matrix4f &final_transformation,
                                                          tf2::Transform &best_pose_correction_out) {
-	std::string final_transform_str = math_utils::convertTransformToString(final_transformation);
-	ROS_DEBUG_STREAM("Cloud matcher [" << getCloudMatcherName() << "] transform:" << final_transform_str << "\n");
+	ROS_DEBUG_STREAM("Cloud matcher [" << getCloudMatcherName() << "] transform:" << math_utils::formatTransform(final_transformation) << "\n");
 
 	if (!math_utils::isTransformValid<float>(final_transformation)) {
 		ROS_WARN("Rejected estimated transformation with NaN values!");
@@ -386,6 +419,28 @@ bool CloudMatcher<PointT>::postProcessRegistrationMatrix(typename pcl::PointClou
 	return true;
 }
 
+template<typename PointT>
+float CloudMatcher<PointT>::computeInlierFraction(const pcl::PointCloud<PointT>& pointcloud, const Eigen::Matrix4f& transformation, double inlier_distance, int maximum_number_of_points) const {
+	if (!search_method_ || pointcloud.empty()) { return 0.0f; }
+
+	size_t step = (maximum_number_of_points > 0) ? std::max((size_t)1, pointcloud.size() / (size_t)maximum_number_of_points) : 1;
+	float maximum_squared_distance = (float)(inlier_distance * inlier_distance);
+	std::vector<int> indices(1);
+	std::vector<float> squared_distances(1);
+	size_t number_of_inliers = 0;
+	size_t number_of_evaluated_points = 0;
+	for (size_t i = 0; i < pointcloud.size(); i += step) {
+		PointT point = pointcloud[i];
+		point.getVector3fMap() = transformation.block<3, 3>(0, 0) * point.getVector3fMap() + transformation.block<3, 1>(0, 3);
+		if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z)) { continue; }
+		++number_of_evaluated_points;
+		if (search_method_->nearestKSearch(point, 1, indices, squared_distances) > 0 && squared_distances[0] <= maximum_squared_distance) { ++number_of_inliers; }
+	}
+
+	return (number_of_evaluated_points > 0) ? (float)number_of_inliers / (float)number_of_evaluated_points : 0.0f;
+}
+
+
 template<typename PointT>
 void CloudMatcher<PointT>::setupRegistrationVisualizer() {
 	if (cloud_matcher_ && !registration_visualizer_ && display_cloud_aligment_) {
@@ -502,6 +557,14 @@ double CloudMatcher<PointT>::getTransformationEstimationElapsedTimeMS() {
 				break;
 			}
 
+			case TransformationEstimationLMAnalytic:
+			case TransformationEstimationPointToPlaneLMAnalytic:
+			case TransformationEstimationPointToPlaneWeightedLMAnalytic: {
+				typename TransformationEstimationLMAnalyticTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationLMAnalyticTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
+				if (estimator) { return estimator->getTransformationEstimationElapsedTime(); }
+				break;
+			}
+
 			case TransformationEstimationPointToPlane: {
 				typename TransformationEstimationPointToPlaneTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationPointToPlaneTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
 				if (estimator) { return estimator->getTransformationEstimationElapsedTime(); }
@@ -520,6 +583,13 @@ double CloudMatcher<PointT>::getTransformationEstimationElapsedTimeMS() {
 				break;
 			}
 
+			case TransformationEstimationPointToPlaneLLSParallel:
+			case TransformationEstimationPointToPlaneLLSWeightedParallel: {
+				typename TransformationEstimationPointToPlaneLLSParallelTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationPointToPlaneLLSParallelTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
+				if (estimator) { return estimator->getTransformationEstimationElapsedTime(); }
+				break;
+			}
+
 			case TransformationEstimationPointToPlaneWeighted: {
 				typename TransformationEstimationPointToPlaneWeightedTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationPointToPlaneWeightedTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
 				if (estimator) { return estimator->getTransformationEstimationElapsedTime(); }
@@ -568,6 +638,14 @@ void CloudMatcher<PointT>::resetTransformationEstimationElapsedTime() {
 				break;
 			}
 
+			case TransformationEstimationLMAnalytic:
+			case TransformationEstimationPointToPlaneLMAnalytic:
+			case TransformationEstimationPointToPlaneWeightedLMAnalytic: {
+				typename TransformationEstimationLMAnalyticTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationLMAnalyticTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
+				if (estimator) { estimator->resetTransformationEstimationElapsedTime(); }
+				break;
+			}
+
 			case TransformationEstimationPointToPlane: {
 				typename TransformationEstimationPointToPlaneTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationPointToPlaneTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
 				if (estimator) { estimator->resetTransformationEstimationElapsedTime(); }
@@ -586,6 +664,13 @@ void CloudMatcher<PointT>::resetTransformationEstimationElapsedTime() {
 				break;
 			}
 
+			case TransformationEstimationPointToPlaneLLSParallel:
+			case TransformationEstimationPointToPlaneLLSWeightedParallel: {
+				typename TransformationEstimationPointToPlaneLLSParallelTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationPointToPlaneLLSParallelTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
+				if (estimator) { estimator->resetTransformationEstimationElapsedTime(); }
+				break;
+			}
+
 			case TransformationEstimationPointToPlaneWeighted: {
 				typename TransformationEstimationPointToPlaneWeightedTimed<PointT, PointT, float>::Ptr estimator = std::dynamic_pointer_cast< TransformationEstimationPointToPlaneWeightedTimed<PointT, PointT, float> >(transformation_estimation_ptr_);
 				if (estimator) { estimator->resetTransformationEstimationElapsedTime(); }
@@ -0,0 +1,264 @@
+/**\file transformation_estimation_lm_analytic.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/transformation_estimation_lm_analytic.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <TransformationEstimationLMAnalyticTimed-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt, Matrix4 &transformation_matrix) const {
+	if (cloud_src.size() != cloud_tgt.size()) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Number of points in source (%zu) differs than target (%zu)!\n", cloud_src.size(), cloud_tgt.size());
+		return;
+	}
+
+	if (use_weights_ && !use_correspondence_weights_ && weights_.size() != cloud_src.size()) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Number of weights (%zu) differs than number of points (%zu)!\n", weights_.size(), cloud_src.size());
+		return;
+	}
+
+	PerformanceTimer timer;
+	timer.start();
+	fillWorkspace(cloud_src, cloud_tgt, cloud_src.size(),
+			[&](size_t i, int& source_index, int& target_index, double& weight) {
+				source_index = (int)i;
+				target_index = (int)i;
+				weight = (use_weights_ && !use_correspondence_weights_) ? weights_[i] : 1.0;
+			});
+	estimateRigidTransformationFromWorkspace(transformation_matrix);
+	transformation_estimation_elapsed_time_ += timer.getElapsedTimeInMilliSec();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const std::vector<int> &indices_src,
+		const pcl::PointCloud<PointTarget> &cloud_tgt, Matrix4 &transformation_matrix) const {
+	if (indices_src.size() != cloud_tgt.size()) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Number of points in source (%zu) differs than target (%zu)!\n", indices_src.size(), cloud_tgt.size());
+		return;
+	}
+
+	if (use_weights_ && !use_correspondence_weights_ && weights_.size() != indices_src.size()) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Number of weights (%zu) differs than number of points (%zu)!\n", weights_.size(), indices_src.size());
+		return;
+	}
+
+	PerformanceTimer timer;
+	timer.start();
+	fillWorkspace(cloud_src, cloud_tgt, indices_src.size(),
+			[&](size_t i, int& source_index, int& target_index, double& weight) {
+				source_index = indices_src[i];
+				target_index = (int)i;
+				weight = (use_weights_ && !use_correspondence_weights_) ? weights_[i] : 1.0;
+			});
+	estimateRigidTransformationFromWorkspace(transformation_matrix);
+	transformation_estimation_elapsed_time_ += timer.getElapsedTimeInMilliSec();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const std::vector<int> &indices_src,
+		const pcl::PointCloud<PointTarget> &cloud_tgt, const std::vector<int> &indices_tgt, Matrix4 &transformation_matrix) const {
+	if (indices_src.size() != indices_tgt.size()) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Number of points in source (%zu) differs than target (%zu)!\n", indices_src.size(), indices_tgt.size());
+		return;
+	}
+
+	if (use_weights_ && !use_correspondence_weights_ && weights_.size() != indices_src.size()) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Number of weights (%zu) differs than number of points (%zu)!\n", weights_.size(), indices_src.size());
+		return;
+	}
+
+	PerformanceTimer timer;
+	timer.start();
+	fillWorkspace(cloud_src, cloud_tgt, indices_src.size(),
+			[&](size_t i, int& source_index, int& target_index, double& weight) {
+				source_index = indices_src[i];
+				target_index = indices_tgt[i];
+				weight = (use_weights_ && !use_correspondence_weights_) ? weights_[i] : 1.0;
+			});
+	estimateRigidTransformationFromWorkspace(transformation_matrix);
+	transformation_estimation_elapsed_time_ += timer.getElapsedTimeInMilliSec();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt,
+		const pcl::Correspondences &correspondences, Matrix4 &transformation_matrix) const {
+	if (use_weights_ && !use_correspondence_weights_ && weights_.size() != correspondences.size()) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Number of weights (%zu) differs than number of correspondences (%zu)!\n", weights_.size(), correspondences.size());
+		return;
+	}
+
+	PerformanceTimer timer;
+	timer.start();
+	fillWorkspace(cloud_src, cloud_tgt, correspondences.size(),
+			[&](size_t i, int& source_index, int& target_index, double& weight) {
+				source_index = correspondences[i].index_query;
+				target_index = correspondences[i].index_match;
+				weight = use_weights_ ? (use_correspondence_weights_ ? correspondences[i].weight : weights_[i]) : 1.0;
+			});
+	estimateRigidTransformationFromWorkspace(transformation_matrix);
+	transformation_estimation_elapsed_time_ += timer.getElapsedTimeInMilliSec();
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </TransformationEstimationLMAnalyticTimed-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template <typename PointSource, typename PointTarget, typename Scalar>
+template <typename CorrespondenceAccessor>
+void TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::fillWorkspace(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt,
+		size_t number_of_correspondences, CorrespondenceAccessor correspondence_accessor) const {
+	// the workspaces only grow, so after the first registrations no memory is allocated
+	if ((size_t)workspace_source_points_.cols() < number_of_correspondences) {
+		workspace_source_points_.resize(Eigen::NoChange, number_of_correspondences);
+		workspace_target_points_.resize(Eigen::NoChange, number_of_correspondences);
+		workspace_target_normals_.resize(Eigen::NoChange, number_of_correspondences);
+		workspace_weights_.resize(number_of_correspondences);
+		workspace_transformed_points_.resize(Eigen::NoChange, number_of_correspondences);
+	}
+
+	size_t number_of_valid_correspondences = 0;
+	int source_index, target_index;
+	double weight;
+	for (size_t i = 0; i < number_of_correspondences; ++i) {
+		correspondence_accessor(i, source_index, target_index, weight);
+		if (!(weight > 0.0)) { continue; }
+
+		const PointSource& source_point = cloud_src[source_index];
+		const PointTarget& target_point = cloud_tgt[target_index];
+		if (error_metric_ == PointToPlane) {
+			Eigen::Vector3d target_normal(target_point.normal_x, target_point.normal_y, target_point.normal_z);
+			if (!target_normal.allFinite()) { continue; }
+			workspace_target_normals_.col(number_of_valid_correspondences) = target_normal;
+		}
+
+		workspace_source_points_.col(number_of_valid_correspondences) << source_point.x, source_point.y, source_point.z;
+		workspace_target_points_.col(number_of_valid_correspondences) << target_point.x, target_point.y, target_point.z;
+		workspace_weights_(number_of_valid_correspondences) = weight;
+		++number_of_valid_correspondences;
+	}
+
+	workspace_size_ = number_of_valid_correspondences;
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformationFromWorkspace(Matrix4 &transformation_matrix) const {
+	transformation_matrix.setIdentity();
+	size_t minimum_number_of_correspondences = (error_metric_ == PointToPlane ? 6 : 3);
+	if (workspace_size_ < minimum_number_of_correspondences) {
+		PCL_ERROR("[TransformationEstimationLMAnalyticTimed::estimateRigidTransformation] Need at least %zu valid correspondences (only %zu given)!\n", minimum_number_of_correspondences, workspace_size_);
+		return;
+	}
+
+	Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity();
+	Eigen::Vector3d translation = Eigen::Vector3d::Zero();
+	double cost = computeCost(rotation, translation);
+	double damping = initial_damping_;
+	NormalEquations normal_equations;
+
+	for (int iteration = 0; iteration < max_iterations_ && cost > 0.0; ++iteration) {
+		computeNormalEquations(rotation, translation, normal_equations);
+		Eigen::Matrix<double, 6, 6> jtj = normal_equations.template block<6, 6>(0, 0);
+		Eigen::Matrix<double, 6, 1> jtr = normal_equations.template block<6, 1>(0, 6);
+		Eigen::Matrix<double, 6, 1> jtj_diagonal = jtj.diagonal().cwiseMax(1e-12);
+
+		bool step_accepted = false;
+		Eigen::Matrix<double, 6, 1> parameters_update = Eigen::Matrix<double, 6, 1>::Zero();
+		while (!step_accepted && damping < 1e10) {
+			Eigen::Matrix<double, 6, 6> damped_jtj = jtj;
+			damped_jtj.diagonal() += damping * jtj_diagonal;
+			parameters_update = damped_jtj.ldlt().solve(-jtr);
+
+			// left perturbation: T = [exp(rotation_vector) | translation_update] * T
+			Eigen::Vector3d rotation_vector = parameters_update.template head<3>();
+			double rotation_angle = rotation_vector.norm();
+			Eigen::Matrix3d rotation_update = (rotation_angle > 0.0 ? Eigen::Matrix3d(Eigen::AngleAxisd(rotation_angle, rotation_vector / rotation_angle)) : Eigen::Matrix3d::Identity());
+			Eigen::Matrix3d candidate_rotation = rotation_update * rotation;
+			Eigen::Vector3d candidate_translation = rotation_update * translation + parameters_update.template tail<3>();
+
+			double candidate_cost = computeCost(candidate_rotation, candidate_translation);
+			if (candidate_cost < cost) {
+				rotation = candidate_rotation;
+				translation = candidate_translation;
+				cost = candidate_cost;
+				damping = std::max(damping * 0.1, 1e-12);
+				step_accepted = true;
+			} else {
+				damping *= 10.0;
+			}
+		}
+
+		if (!step_accepted || parameters_update.squaredNorm() < parameters_update_epsilon_) { break; }
+	}
+
+	transformation_matrix.template block<3, 3>(0, 0) = rotation.template cast<Scalar>();
+	transformation_matrix.template block<3, 1>(0, 3) = translation.template cast<Scalar>();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+double TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::computeCost(const Eigen::Matrix3d& rotation, const Eigen::Vector3d& translation) const {
+	auto residuals = workspace_transformed_points_.leftCols(workspace_size_);
+	residuals.noalias() = rotation * workspace_source_points_.leftCols(workspace_size_);
+	residuals.colwise() += translation;
+	residuals -= workspace_target_points_.leftCols(workspace_size_);
+
+	if (error_metric_ == PointToPlane) {
+		return residuals.cwiseProduct(workspace_target_normals_.leftCols(workspace_size_)).colwise().sum().array().square().matrix().dot(workspace_weights_.head(workspace_size_));
+	} else {
+		return residuals.colwise().squaredNorm().dot(workspace_weights_.head(workspace_size_));
+	}
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::computeNormalEquations(const Eigen::Matrix3d& rotation, const Eigen::Vector3d& translation, NormalEquations& normal_equations) const {
+	normal_equations = parallel_utils::computeDeterministicBlockReduction(workspace_size_, NormalEquations(NormalEquations::Zero()),
+			[&](size_t block_start, size_t block_end, NormalEquations& block_normal_equations) {
+				if (error_metric_ == PointToPlane) {
+					// r = n . (p - q) | J = [(p x n)^T, n^T]
+					Eigen::Matrix<double, 6, 1> jacobian_row;
+					for (size_t i = block_start; i < block_end; ++i) {
+						Eigen::Vector3d transformed_point = rotation * workspace_source_points_.col(i) + translation;
+						Eigen::Vector3d target_normal = workspace_target_normals_.col(i);
+						double weight = workspace_weights_(i);
+						double residual = target_normal.dot(transformed_point - workspace_target_points_.col(i));
+						jacobian_row.template head<3>() = transformed_point.cross(target_normal);
+						jacobian_row.template tail<3>() = target_normal;
+						block_normal_equations.template block<6, 6>(0, 0).noalias() += (weight * jacobian_row) * jacobian_row.transpose();
+						block_normal_equations.template block<6, 1>(0, 6).noalias() += (weight * residual) * jacobian_row;
+					}
+				} else {
+					// r = p - q | J = [-[p]x, I]
+					Eigen::Matrix<double, 3, 6> jacobian;
+					jacobian.template block<3, 3>(0, 3).setIdentity();
+					for (size_t i = block_start; i < block_end; ++i) {
+						Eigen::Vector3d transformed_point = rotation * workspace_source_points_.col(i) + translation;
+						double weight = workspace_weights_(i);
+						Eigen::Vector3d residual = transformed_point - workspace_target_points_.col(i);
+						jacobian.template block<3, 3>(0, 0) <<
+								0.0, transformed_point.z(), -transformed_point.y(),
+								-transformed_point.z(), 0.0, transformed_point.x(),
+								transformed_point.y(), -transformed_point.x(), 0.0;
+						block_normal_equations.template block<6, 6>(0, 0).noalias() += (weight * jacobian.transpose()) * jacobian;
+						block_normal_equations.template block<6, 1>(0, 6).noalias() += (weight * jacobian.transpose()) * residual;
+					}
+				}
+			}, number_of_threads_, block_size_);
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
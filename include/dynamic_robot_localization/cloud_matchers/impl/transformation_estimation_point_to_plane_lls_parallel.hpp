@@ -0,0 +1,97 @@
+/**\file transformation_estimation_point_to_plane_lls_parallel.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/transformation_estimation_point_to_plane_lls_parallel.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <TransformationEstimationPointToPlaneLLSParallelTimed-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const std::vector<int> &indices_src,
+		const pcl::PointCloud<PointTarget> &cloud_tgt, const std::vector<int> &indices_tgt, Matrix4 &transformation_matrix) const {
+	if (indices_src.size() != indices_tgt.size()) {
+		PCL_ERROR("[TransformationEstimationPointToPlaneLLSParallelTimed::estimateRigidTransformation] Number of points in source (%zu) differs than target (%zu)!\n", indices_src.size(), indices_tgt.size());
+		return;
+	}
+
+	if (use_weights_ && !use_correspondence_weights_ && weights_.size() != indices_src.size()) {
+		PCL_ERROR("[TransformationEstimationPointToPlaneLLSWeightedParallelTimed::estimateRigidTransformation] Number of weights (%zu) differs than number of points (%zu)!\n", weights_.size(), indices_src.size());
+		return;
+	}
+
+	estimateRigidTransformationParallel(cloud_src, cloud_tgt, indices_src.size(),
+			[&](size_t i, int& source_index, int& target_index, double& weight) {
+				source_index = indices_src[i];
+				target_index = indices_tgt[i];
+				weight = (use_weights_ && !use_correspondence_weights_) ? weights_[i] : 1.0;
+			}, transformation_matrix);
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt,
+		const pcl::Correspondences &correspondences, Matrix4 &transformation_matrix) const {
+	if (use_weights_ && !use_correspondence_weights_ && weights_.size() != correspondences.size()) {
+		PCL_ERROR("[TransformationEstimationPointToPlaneLLSWeightedParallelTimed::estimateRigidTransformation] Number of weights (%zu) differs than number of correspondences (%zu)!\n", weights_.size(), correspondences.size());
+		return;
+	}
+
+	estimateRigidTransformationParallel(cloud_src, cloud_tgt, correspondences.size(),
+			[&](size_t i, int& source_index, int& target_index, double& weight) {
+				source_index = correspondences[i].index_query;
+				target_index = correspondences[i].index_match;
+				weight = use_weights_ ? (use_correspondence_weights_ ? correspondences[i].weight : weights_[i]) : 1.0;
+			}, transformation_matrix);
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </TransformationEstimationPointToPlaneLLSParallelTimed-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template <typename PointSource, typename PointTarget, typename Scalar>
+template <typename CorrespondenceAccessor>
+void TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar>::estimateRigidTransformationParallel(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt,
+		size_t number_of_correspondences, CorrespondenceAccessor correspondence_accessor, Matrix4 &transformation_matrix) const {
+	PerformanceTimer timer;
+	timer.start();
+
+	transformation_matrix.setIdentity();
+
+	NormalEquations normal_equations = parallel_utils::computeDeterministicBlockReduction(number_of_correspondences, NormalEquations(NormalEquations::Zero()),
+			[&](size_t block_start, size_t block_end, NormalEquations& block_normal_equations) {
+				Eigen::Matrix<double, 6, 1> jacobian_row;
+				int source_index, target_index;
+				double weight;
+				for (size_t i = block_start; i < block_end; ++i) {
+					correspondence_accessor(i, source_index, target_index, weight);
+					const PointTarget& target_point = cloud_tgt[target_index];
+					Eigen::Vector3d target_normal = target_point.getNormalVector3fMap().template cast<double>();
+					if (!target_normal.allFinite() || !(weight > 0.0)) { continue; }
+
+					Eigen::Vector3d source = cloud_src[source_index].getVector3fMap().template cast<double>();
+					jacobian_row.head<3>() = source.cross(target_normal);
+					jacobian_row.tail<3>() = target_normal;
+					double residual = target_normal.dot(target_point.getVector3fMap().template cast<double>() - source);
+
+					block_normal_equations.template block<6, 6>(0, 0).noalias() += (weight * jacobian_row) * jacobian_row.transpose();
+					block_normal_equations.template block<6, 1>(0, 6).noalias() += (weight * residual) * jacobian_row;
+				}
+			}, number_of_threads_, block_size_);
+
+	Eigen::Matrix<double, 6, 1> x = normal_equations.template block<6, 6>(0, 0).ldlt().solve(normal_equations.template block<6, 1>(0, 6));
+	pcl::registration::TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::constructTransformationMatrix(x(0), x(1), x(2), x(3), x(4), x(5), transformation_matrix);
+
+	transformation_estimation_elapsed_time_ += timer.getElapsedTimeInMilliSec();
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
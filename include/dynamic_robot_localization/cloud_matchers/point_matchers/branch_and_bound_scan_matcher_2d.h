@@ -0,0 +1,140 @@
+#pragma once
+
+/**\file branch_and_bound_scan_matcher_2d.h
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// PCL includes
+#include <pcl/common/centroid.h>
+#include <pcl/common/common.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// project includes
+#include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ####################################################################   BranchAndBoundScanMatcher2D   #####################################################################
+/**
+ * \brief 2D correlative scan matcher that finds the pose with the highest likelihood score within a search window (xy translation and yaw) around the pose prior.
+ * The reference point cloud (which can come from an OccupancyGrid) is rasterized into a likelihood grid and a pyramid of precomputation grids
+ * (in which each cell has the maximum likelihood of a 2^depth x 2^depth window) is used for bounding the score of each group of translations,
+ * allowing a depth first branch and bound search that gives the same result as the exhaustive search over the discretized window.
+ * The ambient point cloud must be in the map frame and its z coordinates are ignored.
+ */
+template <typename PointT>
+class BranchAndBoundScanMatcher2D : public CloudMatcher<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< BranchAndBoundScanMatcher2D<PointT> >;
+		using ConstPtr = std::shared_ptr< const BranchAndBoundScanMatcher2D<PointT> >;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <structs>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** Grid in which the cell j (in each axis) has the maximum likelihood of the base grid cells [j - window_size + 1, j] (cells outside the base grid have 0 likelihood) */
+		struct PrecomputationGrid {
+			int window_size = 1;
+			int width = 0;
+			int height = 0;
+			std::vector<uint8_t> cells; // row major, likelihood quantized to [0, 255]
+
+			inline uint8_t getCell(int x, int y) const { return (x < 0 || y < 0 || x >= width || y >= height) ? (uint8_t)0 : cells[(size_t)y * width + x]; }
+		};
+
+		/** Ambient point cloud rotated by one of the search angles and discretized into base grid cells */
+		struct DiscretizedScan {
+			float angle = 0.0f;
+			std::vector<int> cells_x;
+			std::vector<int> cells_y;
+		};
+
+		struct Candidate {
+			int scan_index = 0;
+			int x_offset = 0;
+			int y_offset = 0;
+			float score = 0.0f;
+
+			inline bool operator>(const Candidate& other) const { return score > other.score; }
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </structs>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		BranchAndBoundScanMatcher2D() :
+			grid_resolution_(0.05), likelihood_standard_deviation_(0.1), branch_and_bound_depth_(7),
+			linear_search_window_(3.0), angular_search_window_(M_PI), angular_search_step_(0.0), minimum_score_(0.5), number_of_threads_(0),
+			pose_prior_available_(false), pose_prior_position_(Eigen::Vector3f::Zero()), grid_origin_x_(0.0f), grid_origin_y_(0.0f) {}
+		virtual ~BranchAndBoundScanMatcher2D() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <BranchAndBoundScanMatcher2D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
+		virtual void setPosePrior(const tf2::Transform& pose_prior);
+		virtual bool registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints, tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints = false);
+
+		/** Builds the likelihood grid of the reference point cloud and its precomputation grids pyramid */
+		bool computePrecomputationGrids(const pcl::PointCloud<PointT>& reference_cloud);
+		void computeDiscretizedScans(const pcl::PointCloud<PointT>& ambient_pointcloud, const Eigen::Vector2f& rotation_center, std::vector<DiscretizedScan>& discretized_scans_out) const;
+		/** Mean likelihood (in [0, 1]) of the scan cells shifted by the candidate offset, which is an upper bound of the scores of all the candidates of the lower depths that it contains */
+		float computeCandidateScore(const DiscretizedScan& discretized_scan, const Candidate& candidate, int depth) const;
+		Candidate searchBranchAndBound(const std::vector<DiscretizedScan>& discretized_scans, std::vector<Candidate>& candidates, int depth, int linear_search_window_in_cells, float minimum_score) const;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </BranchAndBoundScanMatcher2D-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual std::string getCloudMatcherName() { return "BranchAndBoundScanMatcher2D"; }
+		virtual bool registrationRequiresNormalsOnAmbientPointCloud() { return false; }
+		inline const std::vector<PrecomputationGrid>& getPrecomputationGrids() const { return precomputation_grids_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		double grid_resolution_;
+		double likelihood_standard_deviation_;
+		int branch_and_bound_depth_;
+		double linear_search_window_;
+		double angular_search_window_;
+		double angular_search_step_;
+		double minimum_score_;
+		int number_of_threads_;
+
+		bool pose_prior_available_;
+		Eigen::Vector3f pose_prior_position_;
+
+		float grid_origin_x_;
+		float grid_origin_y_;
+		std::vector<PrecomputationGrid> precomputation_grids_; // index = depth (window size of 2^depth)
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/impl/branch_and_bound_scan_matcher_2d.hpp>
+#endif
@@ -0,0 +1,324 @@
+/**\file branch_and_bound_scan_matcher_2d.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/branch_and_bound_scan_matcher_2d.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <BranchAndBoundScanMatcher2D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void BranchAndBoundScanMatcher2D<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	CloudMatcher<PointT>::setupTFConfigurationsFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+	CloudMatcher<PointT>::setupReferencePointCloudPublisher(node_handle, private_node_handle, configuration_namespace);
+	CloudMatcher<PointT>::setupAlignedPointCloudPublisher(node_handle, private_node_handle, configuration_namespace);
+
+	private_node_handle->param(configuration_namespace + "grid_resolution", grid_resolution_, 0.05);
+	private_node_handle->param(configuration_namespace + "likelihood_standard_deviation", likelihood_standard_deviation_, 0.1);
+	private_node_handle->param(configuration_namespace + "branch_and_bound_depth", branch_and_bound_depth_, 7);
+	private_node_handle->param(configuration_namespace + "linear_search_window", linear_search_window_, 3.0);
+	private_node_handle->param(configuration_namespace + "angular_search_window", angular_search_window_, M_PI);
+	private_node_handle->param(configuration_namespace + "angular_search_step", angular_search_step_, 0.0);
+	private_node_handle->param(configuration_namespace + "minimum_score", minimum_score_, 0.5);
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
+	branch_and_bound_depth_ = std::min(std::max(branch_and_bound_depth_, 1), 16);
+}
+
+
+template<typename PointT>
+void BranchAndBoundScanMatcher2D<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	CloudMatcher<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+	if (!reference_cloud || !computePrecomputationGrids(*reference_cloud)) {
+		ROS_WARN("Failed to compute the precomputation grids of the branch and bound scan matcher");
+		return;
+	}
+	ROS_DEBUG_STREAM("Computed " << precomputation_grids_.size() << " branch and bound precomputation grids with " << precomputation_grids_.front().width << "x" << precomputation_grids_.front().height
+			<< " cells in " << performance_timer.getElapsedTimeFormated());
+}
+
+
+template<typename PointT>
+void BranchAndBoundScanMatcher2D<PointT>::setPosePrior(const tf2::Transform& pose_prior) {
+	pose_prior_position_ = Eigen::Vector3f((float)pose_prior.getOrigin().getX(), (float)pose_prior.getOrigin().getY(), (float)pose_prior.getOrigin().getZ());
+	pose_prior_available_ = true;
+}
+
+
+template<typename PointT>
+bool BranchAndBoundScanMatcher2D<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+		typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+		tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints) {
+	CloudMatcher<PointT>::cloud_align_time_ms_ = 0;
+	if (precomputation_grids_.empty()) {
+		ROS_WARN("Discarded ambient cloud because the branch and bound scan matcher does not have a reference point cloud");
+		return false;
+	}
+
+	if (ambient_pointcloud->empty()) { return false; }
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+
+	// the ambient point cloud is in the map frame, and as such, the search window is centered in the sensor position given by the pose prior
+	Eigen::Vector2f rotation_center;
+	if (pose_prior_available_) {
+		rotation_center = pose_prior_position_.head<2>();
+	} else {
+		Eigen::Vector4f centroid;
+		pcl::compute3DCentroid(*ambient_pointcloud, centroid);
+		rotation_center = centroid.head<2>();
+	}
+
+	std::vector<DiscretizedScan> discretized_scans;
+	computeDiscretizedScans(*ambient_pointcloud, rotation_center, discretized_scans);
+	if (discretized_scans.empty() || discretized_scans.front().cells_x.empty()) { return false; }
+
+	int linear_search_window_in_cells = std::max(0, (int)std::ceil(linear_search_window_ / grid_resolution_));
+	int lowest_resolution_depth = (int)precomputation_grids_.size() - 1;
+	int lowest_resolution_window_size = 1 << lowest_resolution_depth;
+
+	std::vector<Candidate> candidates;
+	for (int scan_index = 0; scan_index < (int)discretized_scans.size(); ++scan_index) {
+		for (int x_offset = -linear_search_window_in_cells; x_offset <= linear_search_window_in_cells; x_offset += lowest_resolution_window_size) {
+			for (int y_offset = -linear_search_window_in_cells; y_offset <= linear_search_window_in_cells; y_offset += lowest_resolution_window_size) {
+				Candidate candidate;
+				candidate.scan_index = scan_index;
+				candidate.x_offset = x_offset;
+				candidate.y_offset = y_offset;
+				candidates.push_back(candidate);
+			}
+		}
+	}
+
+	#pragma omp parallel for schedule(static) num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	for (long i = 0; i < (long)candidates.size(); ++i) {
+		candidates[i].score = computeCandidateScore(discretized_scans[candidates[i].scan_index], candidates[i], lowest_resolution_depth);
+	}
+	std::stable_sort(candidates.begin(), candidates.end(), std::greater<Candidate>());
+
+	Candidate best_candidate = searchBranchAndBound(discretized_scans, candidates, lowest_resolution_depth, linear_search_window_in_cells, (float)minimum_score_);
+	CloudMatcher<PointT>::cloud_align_time_ms_ = performance_timer.getElapsedTimeInMilliSec();
+	if (best_candidate.scan_index < 0) {
+		ROS_DEBUG_STREAM("Branch and bound scan matcher did not find a pose with a score higher than " << minimum_score_ << " (" << discretized_scans.size() << " rotations and "
+				<< candidates.size() << " lowest resolution candidates searched in " << CloudMatcher<PointT>::cloud_align_time_ms_ << " ms)");
+		return false;
+	}
+
+	ROS_DEBUG_STREAM("Branch and bound scan matcher found a pose with score " << best_candidate.score << " in " << CloudMatcher<PointT>::cloud_align_time_ms_ << " ms");
+
+	Eigen::Matrix4f final_transformation = Eigen::Matrix4f::Identity();
+	Eigen::Matrix2f rotation = Eigen::Rotation2Df(discretized_scans[best_candidate.scan_index].angle).toRotationMatrix();
+	final_transformation.block<2, 2>(0, 0) = rotation;
+	final_transformation.block<2, 1>(0, 3) = rotation_center - rotation * rotation_center + Eigen::Vector2f((float)(best_candidate.x_offset * grid_resolution_), (float)(best_candidate.y_offset * grid_resolution_));
+
+	tf2::Transform pose_correction;
+	laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformMatrixToTF2(final_transformation, pose_correction);
+	accepted_pose_corrections_out.push_back(pose_correction);
+
+	pcl::transformPointCloudWithNormals(*ambient_pointcloud, *pointcloud_registered_out, final_transformation);
+
+	if (CloudMatcher<PointT>::postProcessRegistrationMatrix(ambient_pointcloud, final_transformation, best_pose_correction_out)) {
+		pointcloud_registered_out->header = ambient_pointcloud->header;
+
+		if (pointcloud_keypoints && !pointcloud_keypoints->empty()) {
+			pcl::transformPointCloudWithNormals(*pointcloud_keypoints, *pointcloud_keypoints, final_transformation);
+		}
+
+		if (CloudMatcher<PointT>::cloud_publisher_ && pointcloud_registered_out) {
+			CloudMatcher<PointT>::cloud_publisher_->publishPointCloud(*pointcloud_registered_out);
+		}
+
+		if (CloudMatcher<PointT>::reference_cloud_publisher_ && CloudMatcher<PointT>::reference_cloud_) {
+			CloudMatcher<PointT>::reference_cloud_publisher_->setCloudPublishStamp(ambient_pointcloud->header.stamp);
+			CloudMatcher<PointT>::reference_cloud_publisher_->publishPointCloud(*CloudMatcher<PointT>::reference_cloud_);
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+
+template<typename PointT>
+bool BranchAndBoundScanMatcher2D<PointT>::computePrecomputationGrids(const pcl::PointCloud<PointT>& reference_cloud) {
+	precomputation_grids_.clear();
+	if (reference_cloud.empty() || grid_resolution_ <= 0.0) { return false; }
+
+	float resolution = (float)grid_resolution_;
+	float standard_deviation = (likelihood_standard_deviation_ > 0.0) ? (float)likelihood_standard_deviation_ : resolution;
+	float inverse_two_variance = 1.0f / (2.0f * standard_deviation * standard_deviation);
+	int kernel_radius = std::max(1, (int)std::ceil(3.0f * standard_deviation / resolution));
+
+	PointT minimum_point, maximum_point;
+	pcl::getMinMax3D(reference_cloud, minimum_point, maximum_point);
+	grid_origin_x_ = minimum_point.x - (float)kernel_radius * resolution;
+	grid_origin_y_ = minimum_point.y - (float)kernel_radius * resolution;
+
+	PrecomputationGrid likelihood_grid;
+	likelihood_grid.window_size = 1;
+	likelihood_grid.width = (int)std::floor((maximum_point.x - grid_origin_x_) / resolution) + kernel_radius + 1;
+	likelihood_grid.height = (int)std::floor((maximum_point.y - grid_origin_y_) / resolution) + kernel_radius + 1;
+	likelihood_grid.cells.assign((size_t)likelihood_grid.width * (size_t)likelihood_grid.height, 0);
+
+	for (size_t i = 0; i < reference_cloud.size(); ++i) {
+		const PointT& point = reference_cloud[i];
+		if (!std::isfinite(point.x) || !std::isfinite(point.y)) { continue; }
+		int point_cell_x = (int)std::floor((point.x - grid_origin_x_) / resolution);
+		int point_cell_y = (int)std::floor((point.y - grid_origin_y_) / resolution);
+
+		for (int y = std::max(0, point_cell_y - kernel_radius); y <= std::min(likelihood_grid.height - 1, point_cell_y + kernel_radius); ++y) {
+			float dy = grid_origin_y_ + ((float)y + 0.5f) * resolution - point.y;
+			for (int x = std::max(0, point_cell_x - kernel_radius); x <= std::min(likelihood_grid.width - 1, point_cell_x + kernel_radius); ++x) {
+				float dx = grid_origin_x_ + ((float)x + 0.5f) * resolution - point.x;
+				uint8_t likelihood = (uint8_t)std::lround(255.0f * std::exp(-(dx * dx + dy * dy) * inverse_two_variance));
+				uint8_t& cell = likelihood_grid.cells[(size_t)y * likelihood_grid.width + x];
+				cell = std::max(cell, likelihood);
+			}
+		}
+	}
+
+	precomputation_grids_.push_back(likelihood_grid);
+
+	// each grid is the maximum of 4 cells of the previous grid, spaced by half of its window size
+	for (int depth = 1; depth < branch_and_bound_depth_; ++depth) {
+		const PrecomputationGrid& previous_grid = precomputation_grids_[depth - 1];
+		int half_window_size = previous_grid.window_size;
+		PrecomputationGrid grid;
+		grid.window_size = half_window_size * 2;
+		grid.width = likelihood_grid.width + grid.window_size - 1;
+		grid.height = likelihood_grid.height + grid.window_size - 1;
+		grid.cells.resize((size_t)grid.width * (size_t)grid.height);
+
+		#pragma omp parallel for schedule(static) num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+		for (int y = 0; y < grid.height; ++y) {
+			for (int x = 0; x < grid.width; ++x) {
+				grid.cells[(size_t)y * grid.width + x] = std::max(
+						std::max(previous_grid.getCell(x, y), previous_grid.getCell(x - half_window_size, y)),
+						std::max(previous_grid.getCell(x, y - half_window_size), previous_grid.getCell(x - half_window_size, y - half_window_size)));
+			}
+		}
+
+		precomputation_grids_.push_back(grid);
+	}
+
+	return true;
+}
+
+
+template<typename PointT>
+void BranchAndBoundScanMatcher2D<PointT>::computeDiscretizedScans(const pcl::PointCloud<PointT>& ambient_pointcloud, const Eigen::Vector2f& rotation_center, std::vector<DiscretizedScan>& discretized_scans_out) const {
+	float resolution = (float)grid_resolution_;
+	float maximum_range = 0.0f;
+	for (size_t i = 0; i < ambient_pointcloud.size(); ++i) {
+		float dx = ambient_pointcloud[i].x - rotation_center(0);
+		float dy = ambient_pointcloud[i].y - rotation_center(1);
+		float range = std::sqrt(dx * dx + dy * dy);
+		if (std::isfinite(range)) { maximum_range = std::max(maximum_range, range); }
+	}
+
+	// by default, the angular step moves the farthest point by at most one cell
+	float angular_step = (float)angular_search_step_;
+	if (angular_step <= 0.0f) {
+		angular_step = (maximum_range > resolution) ? std::acos(1.0f - (resolution * resolution) / (2.0f * maximum_range * maximum_range)) : (float)M_PI;
+	}
+	int number_of_steps_per_side = (angular_search_window_ > 0.0) ? (int)std::ceil(angular_search_window_ / angular_step) : 0;
+	number_of_steps_per_side = std::min(number_of_steps_per_side, (int)std::floor(M_PI / angular_step));
+
+	discretized_scans_out.resize((size_t)(2 * number_of_steps_per_side + 1));
+	#pragma omp parallel for schedule(static) num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	for (int scan_index = 0; scan_index < (int)discretized_scans_out.size(); ++scan_index) {
+		DiscretizedScan& discretized_scan = discretized_scans_out[scan_index];
+		discretized_scan.angle = (float)(scan_index - number_of_steps_per_side) * angular_step;
+		discretized_scan.cells_x.clear();
+		discretized_scan.cells_y.clear();
+		discretized_scan.cells_x.reserve(ambient_pointcloud.size());
+		discretized_scan.cells_y.reserve(ambient_pointcloud.size());
+		float cos_angle = std::cos(discretized_scan.angle);
+		float sin_angle = std::sin(discretized_scan.angle);
+
+		for (size_t i = 0; i < ambient_pointcloud.size(); ++i) {
+			const PointT& point = ambient_pointcloud[i];
+			if (!std::isfinite(point.x) || !std::isfinite(point.y)) { continue; }
+			float dx = point.x - rotation_center(0);
+			float dy = point.y - rotation_center(1);
+			float x = rotation_center(0) + cos_angle * dx - sin_angle * dy;
+			float y = rotation_center(1) + sin_angle * dx + cos_angle * dy;
+			discretized_scan.cells_x.push_back((int)std::floor((x - grid_origin_x_) / resolution));
+			discretized_scan.cells_y.push_back((int)std::floor((y - grid_origin_y_) / resolution));
+		}
+	}
+}
+
+
+template<typename PointT>
+float BranchAndBoundScanMatcher2D<PointT>::computeCandidateScore(const DiscretizedScan& discretized_scan, const Candidate& candidate, int depth) const {
+	if (discretized_scan.cells_x.empty()) { return 0.0f; }
+	const PrecomputationGrid& grid = precomputation_grids_[depth];
+	int x_shift = candidate.x_offset + grid.window_size - 1;
+	int y_shift = candidate.y_offset + grid.window_size - 1;
+	uint64_t sum = 0;
+	for (size_t i = 0; i < discretized_scan.cells_x.size(); ++i) {
+		sum += grid.getCell(discretized_scan.cells_x[i] + x_shift, discretized_scan.cells_y[i] + y_shift);
+	}
+	return (float)sum / (255.0f * (float)discretized_scan.cells_x.size());
+}
+
+
+template<typename PointT>
+typename BranchAndBoundScanMatcher2D<PointT>::Candidate BranchAndBoundScanMatcher2D<PointT>::searchBranchAndBound(const std::vector<DiscretizedScan>& discretized_scans,
+		std::vector<Candidate>& candidates, int depth, int linear_search_window_in_cells, float minimum_score) const {
+	Candidate best_candidate;
+	best_candidate.scan_index = -1;
+	best_candidate.score = minimum_score;
+
+	// candidates are sorted by score, and at the highest resolution their scores are exact
+	if (depth == 0) { return (!candidates.empty() && candidates.front().score > minimum_score) ? candidates.front() : best_candidate; }
+
+	int half_window_size = 1 << (depth - 1);
+	std::vector<Candidate> children;
+
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		// the scores are upper bounds of the scores of the children, and as such, the remaining candidates cannot improve the best candidate
+		if (candidates[i].score <= best_candidate.score) { break; }
+
+		children.clear();
+		for (int x_offset = candidates[i].x_offset; x_offset <= std::min(candidates[i].x_offset + half_window_size, linear_search_window_in_cells); x_offset += half_window_size) {
+			for (int y_offset = candidates[i].y_offset; y_offset <= std::min(candidates[i].y_offset + half_window_size, linear_search_window_in_cells); y_offset += half_window_size) {
+				Candidate child;
+				child.scan_index = candidates[i].scan_index;
+				child.x_offset = x_offset;
+				child.y_offset = y_offset;
+				child.score = computeCandidateScore(discretized_scans[child.scan_index], child, depth - 1);
+				children.push_back(child);
+			}
+		}
+		std::sort(children.begin(), children.end(), std::greater<Candidate>());
+
+		Candidate best_child = searchBranchAndBound(discretized_scans, children, depth - 1, linear_search_window_in_cells, best_candidate.score);
+		if (best_child.score > best_candidate.score) { best_candidate = best_child; }
+	}
+
+	return best_candidate;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </BranchAndBoundScanMatcher2D-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
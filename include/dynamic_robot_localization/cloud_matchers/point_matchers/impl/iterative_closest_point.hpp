@@ -28,6 +28,14 @@ void IterativeClosestPoint<PointT>::setupConfigurationFromParameterServer(ros::N
 	private_node_handle->param(configuration_namespace + "convergence_time_limit_seconds", convergence_time_limit_seconds, -1.0);
 	private_node_handle->param(configuration_namespace + "convergence_time_limit_seconds_as_mean_convergence_time_percentage", convergence_time_limit_seconds_as_mean_convergence_time_percentage_, 3.0);
 	private_node_handle->param(configuration_namespace + "minimum_number_of_convergence_time_measurements_to_adjust_convergence_time_limit", minimum_number_of_convergence_time_measurements_to_adjust_convergence_time_limit_, 25);
+	int convergence_stall_window_size;
+	private_node_handle->param(configuration_namespace + "convergence_stall_window_size", convergence_stall_window_size, 0);
+	double convergence_stall_relative_mse_improvement_threshold;
+	private_node_handle->param(configuration_namespace + "convergence_stall_relative_mse_improvement_threshold", convergence_stall_relative_mse_improvement_threshold, 0.001);
+	std::string convergence_telemetry_publish_topic;
+	private_node_handle->param(configuration_namespace + "convergence_telemetry_publish_topic", convergence_telemetry_publish_topic, std::string(""));
+	int convergence_telemetry_buffer_size;
+	private_node_handle->param(configuration_namespace + "convergence_telemetry_buffer_size", convergence_telemetry_buffer_size, 100);
 
 	convergence_time_limit_seconds_ = convergence_time_limit_seconds;
 
@@ -45,8 +53,16 @@ void IterativeClosestPoint<PointT>::setupConfigurationFromParameterServer(ros::N
 		convergence_criteria->setAbsoluteMSE(convergence_absolute_mse_threshold_);
 		convergence_criteria->setConvergenceRotationThreshold(convergence_rotation_threshold_);
 		convergence_criteria->setMaximumIterationsSimilarTransforms(convergence_max_iterations_similar_transforms_);
+		convergence_criteria->setConvergenceStallWindowSize(convergence_stall_window_size);
+		convergence_criteria->setConvergenceStallRelativeMSEImprovementThreshold(convergence_stall_relative_mse_improvement_threshold);
+		convergence_criteria->setTelemetryBufferSize(convergence_telemetry_publish_topic.empty() ? 0 : (size_t)std::max(0, convergence_telemetry_buffer_size));
 	}
 
+	if (!convergence_telemetry_publish_topic.empty())
+		convergence_telemetry_publisher_ = node_handle->advertise<dynamic_robot_localization::RegistrationConvergenceTelemetry>(convergence_telemetry_publish_topic, 5, true);
+	else
+		convergence_telemetry_publisher_.shutdown();
+
 	ROS_DEBUG_STREAM("Setting a registration time limit of " << convergence_time_limit_seconds << " seconds to " << CloudMatcher<PointT>::getCloudMatcherName() << " algorithm");
 
 	bool use_reciprocal_correspondences;
@@ -70,7 +86,10 @@ bool IterativeClosestPoint<PointT>::registerCloud(typename pcl::PointCloud<Point
 		convergence_criteria->resetConvergenceTimer();
 	}
 
-	if (CloudMatcher<PointT>::registerCloud(ambient_pointcloud, ambient_pointcloud_search_method, pointcloud_keypoints, best_pose_correction_out, accepted_pose_corrections_out, pointcloud_registered_out, return_aligned_keypoints)) {
+	bool registration_successful = CloudMatcher<PointT>::registerCloud(ambient_pointcloud, ambient_pointcloud_search_method, pointcloud_keypoints, best_pose_correction_out, accepted_pose_corrections_out, pointcloud_registered_out, return_aligned_keypoints);
+	publishConvergenceTelemetry(ambient_pointcloud);
+
+	if (registration_successful) {
 		if (convergence_criteria)
 			cumulative_sum_of_convergence_time_ += convergence_criteria->getConvergenceElaspedTime();
 
@@ -147,6 +166,35 @@ std::string IterativeClosestPoint<PointT>::getMatcherConvergenceState() {
 	}
 }
 
+template<typename PointT>
+void IterativeClosestPoint<PointT>::publishConvergenceTelemetry(const typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud) {
+	if (convergence_telemetry_publisher_.getTopic().empty()) { return; }
+	typename DefaultConvergenceCriteriaWithTime<float>::Ptr convergence_criteria = getConvergenceCriteria();
+	if (!convergence_criteria) { return; }
+
+	std::vector<typename DefaultConvergenceCriteriaWithTime<float>::IterationTelemetry> iterations_telemetry;
+	convergence_criteria->getIterationsTelemetry(iterations_telemetry);
+
+	dynamic_robot_localization::RegistrationConvergenceTelemetry telemetry_msg;
+	if (ambient_pointcloud) {
+		telemetry_msg.header.frame_id = ambient_pointcloud->header.frame_id;
+		pcl_conversions::fromPCL(ambient_pointcloud->header.stamp, telemetry_msg.header.stamp);
+	}
+	telemetry_msg.matcher_name = CloudMatcher<PointT>::getCloudMatcherName();
+	telemetry_msg.convergence_state = convergence_criteria->getConvergenceStateString();
+	telemetry_msg.number_of_iterations = convergence_criteria->getNumberOfRegistrationIterations();
+	for (size_t i = 0; i < iterations_telemetry.size(); ++i) {
+		telemetry_msg.iteration.push_back(iterations_telemetry[i].iteration);
+		telemetry_msg.elapsed_time.push_back(iterations_telemetry[i].elapsed_time);
+		telemetry_msg.correspondences_mean_square_error.push_back(iterations_telemetry[i].correspondences_mean_square_error);
+		telemetry_msg.translation_delta.push_back(iterations_telemetry[i].translation_delta);
+		telemetry_msg.rotation_delta.push_back(iterations_telemetry[i].rotation_delta);
+		telemetry_msg.number_of_correspondences.push_back(iterations_telemetry[i].number_of_correspondences);
+	}
+	convergence_telemetry_publisher_.publish(telemetry_msg);
+}
+
+
 template<typename PointT>
 double IterativeClosestPoint<PointT>::getTransformCloudElapsedTimeMS() {
 	typename IterativeClosestPointTimeConstrained<PointT, PointT>::Ptr matcher = std::dynamic_pointer_cast< IterativeClosestPointTimeConstrained<PointT, PointT> >(CloudMatcher<PointT>::cloud_matcher_);
@@ -15,6 +15,61 @@ namespace dynamic_robot_localization {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPointGeneralizedTimeConstrained-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template <typename PointSource, typename PointTarget>
+template <typename PointT>
+bool IterativeClosestPointGeneralizedTimeConstrained<PointSource, PointTarget>::computeCovariancesParallel(const typename pcl::PointCloud<PointT>::ConstPtr& cloud, const typename pcl::search::KdTree<PointT>::Ptr& kdtree,
+		MatricesVector& cloud_covariances, std::vector<float>& farthest_neighbor_squared_distances, const std::vector<int>* indices) {
+	int number_of_neighbors = pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::k_correspondences_;
+	if (!cloud || !kdtree || number_of_neighbors <= 0 || (size_t)number_of_neighbors > cloud->size()) {
+		PCL_ERROR("[IterativeClosestPointGeneralizedTimeConstrained::computeCovariancesParallel] Number of points in cloud (%zu) is less than the number of neighbors (%d)!\n", (cloud ? cloud->size() : (size_t)0), number_of_neighbors);
+		return false;
+	}
+
+	cloud_covariances.resize(cloud->size(), Eigen::Matrix3d::Identity());
+	farthest_neighbor_squared_distances.resize(cloud->size(), 0.0f);
+	int number_of_points_to_update = (indices ? (int)indices->size() : (int)cloud->size());
+	double gicp_epsilon = pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::gicp_epsilon_;
+
+	#pragma omp parallel num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	{
+		std::vector<int> nn_indices(number_of_neighbors);
+		std::vector<float> nn_squared_distances(number_of_neighbors);
+
+		#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < number_of_points_to_update; ++i) {
+			int point_index = (indices ? (*indices)[i] : i);
+			Eigen::Matrix3d& covariance = cloud_covariances[point_index];
+			int number_of_neighbors_found = kdtree->nearestKSearch((*cloud)[point_index], number_of_neighbors, nn_indices, nn_squared_distances);
+			if (number_of_neighbors_found <= 0) {
+				covariance.setIdentity();
+				farthest_neighbor_squared_distances[point_index] = 0.0f;
+				continue;
+			}
+
+			Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+			covariance.setZero();
+			for (int j = 0; j < number_of_neighbors_found; ++j) {
+				Eigen::Vector3d neighbor = (*cloud)[nn_indices[j]].getVector3fMap().template cast<double>();
+				mean += neighbor;
+				covariance.noalias() += neighbor * neighbor.transpose();
+			}
+			mean /= (double)number_of_neighbors_found;
+			covariance /= (double)number_of_neighbors_found;
+			covariance.noalias() -= mean * mean.transpose();
+
+			// same regularization as pcl::GeneralizedIterativeClosestPoint (singular values replaced by [1, 1, gicp_epsilon])
+			Eigen::JacobiSVD<Eigen::Matrix3d> svd(covariance, Eigen::ComputeFullU);
+			Eigen::Matrix3d u = svd.matrixU();
+			covariance = u * Eigen::Vector3d(1.0, 1.0, gicp_epsilon).asDiagonal() * u.transpose();
+			farthest_neighbor_squared_distances[point_index] = nn_squared_distances[number_of_neighbors_found - 1];
+		}
+	}
+
+	return true;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPointGeneralizedTimeConstrained-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -36,10 +91,37 @@ void IterativeClosestPointGeneralized<PointT>::setupConfigurationFromParameterSe
 	private_node_handle->param(configuration_namespace + "maximum_optimizer_iterations", maximum_optimizer_iterations, 20);
 	matcher->setMaximumOptimizerIterations(maximum_optimizer_iterations);
 
+	int number_of_threads;
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads, 0);
+	matcher->setNumberOfThreads(number_of_threads);
+
+	private_node_handle->param(configuration_namespace + "cache_reference_cloud_covariances", cache_reference_cloud_covariances_, true);
+	if (!cache_reference_cloud_covariances_) {
+		reference_cloud_covariances_.reset();
+		reference_cloud_farthest_neighbor_squared_distances_.clear();
+		reference_cloud_covariances_points_.clear();
+	}
+
 	CloudMatcher<PointT>::setCloudMatcher(matcher_base);
 	IterativeClosestPoint<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
 }
 
+template<typename PointT>
+void IterativeClosestPointGeneralized<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	// setInputTarget discards the target covariances
+	IterativeClosestPoint<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+
+	typename IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT>::Ptr matcher = std::dynamic_pointer_cast< IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT> >(CloudMatcher<PointT>::cloud_matcher_);
+	if (!cache_reference_cloud_covariances_ || !matcher || !reference_cloud || reference_cloud->empty()) { return; }
+
+	updateReferenceCloudCovariances(reference_cloud, search_method, matcher);
+	if (reference_cloud_covariances_) {
+		matcher->setTargetCovariances(reference_cloud_covariances_);
+	}
+}
+
+
 template<typename PointT>
 double IterativeClosestPointGeneralized<PointT>::getTransformCloudElapsedTimeMS() {
 	typename IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT>::Ptr matcher = std::dynamic_pointer_cast< IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT> >(CloudMatcher<PointT>::cloud_matcher_);
@@ -57,6 +139,114 @@ void IterativeClosestPointGeneralized<PointT>::resetTransformCloudElapsedTime()
 // =============================================================================  </public-section>  ===========================================================================
 
 // =============================================================================   <protected-section>   =======================================================================
+template <typename PointSource, typename PointTarget>
+void IterativeClosestPointGeneralizedTimeConstrained<PointSource, PointTarget>::computeTransformation(typename pcl::Registration<PointSource, PointTarget>::PointCloudSource &output, const Eigen::Matrix4f &guess) {
+	if (!input_covariances_ || input_covariances_->empty()) {
+		typename pcl::search::KdTree<PointSource>::Ptr source_search_method = tree_reciprocal_;
+		if (!source_search_method || source_search_method->getInputCloud() != input_) {
+			source_search_method.reset(new pcl::search::KdTree<PointSource>());
+			source_search_method->setInputCloud(input_);
+		}
+
+		MatricesVectorPtr source_covariances(new MatricesVector());
+		std::vector<float> farthest_neighbor_squared_distances;
+		if (computeCovariancesParallel<PointSource>(input_, source_search_method, *source_covariances, farthest_neighbor_squared_distances)) {
+			input_covariances_ = source_covariances;
+		}
+	}
+
+	if (!target_covariances_ || target_covariances_->empty()) {
+		typename pcl::search::KdTree<PointTarget>::Ptr target_search_method = tree_;
+		if (!target_search_method || target_search_method->getInputCloud() != target_) {
+			target_search_method.reset(new pcl::search::KdTree<PointTarget>());
+			target_search_method->setInputCloud(target_);
+		}
+
+		MatricesVectorPtr target_covariances(new MatricesVector());
+		std::vector<float> farthest_neighbor_squared_distances;
+		if (computeCovariancesParallel<PointTarget>(target_, target_search_method, *target_covariances, farthest_neighbor_squared_distances)) {
+			target_covariances_ = target_covariances;
+		}
+	}
+
+	pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransformation(output, guess);
+}
+
+
+template<typename PointT>
+void IterativeClosestPointGeneralized<PointT>::updateReferenceCloudCovariances(const typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::search::KdTree<PointT>::Ptr& search_method,
+		typename IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT>::Ptr& matcher) {
+	int number_of_neighbors = matcher->getCorrespondenceRandomness();
+	size_t number_of_cached_points = reference_cloud_covariances_points_.size();
+	bool cached_points_are_prefix = reference_cloud_covariances_ && number_of_cached_points > 0 && number_of_cached_points <= reference_cloud->size() &&
+			reference_cloud_covariances_->size() == number_of_cached_points && reference_cloud_covariances_number_of_neighbors_ == number_of_neighbors;
+	for (size_t i = 0; cached_points_are_prefix && i < number_of_cached_points; ++i) {
+		if (reference_cloud_covariances_points_[i] != (*reference_cloud)[i].getVector3fMap()) { cached_points_are_prefix = false; }
+	}
+
+	if (cached_points_are_prefix && number_of_cached_points == reference_cloud->size()) {
+		ROS_DEBUG_STREAM("Reusing the " << number_of_cached_points << " cached GICP covariances of the unchanged reference point cloud");
+		return;
+	}
+
+	typename pcl::search::KdTree<PointT>::Ptr reference_search_method = search_method;
+	if (!reference_search_method || reference_search_method->getInputCloud() != reference_cloud) {
+		reference_search_method.reset(new pcl::search::KdTree<PointT>());
+		reference_search_method->setInputCloud(reference_cloud);
+	}
+
+	PerformanceTimer timer;
+	timer.start();
+
+	bool covariances_computed;
+	if (cached_points_are_prefix) {
+		// the neighborhood of a previous point only changes if an appended point is closer than its farthest neighbor
+		float max_farthest_neighbor_squared_distance = *std::max_element(reference_cloud_farthest_neighbor_squared_distances_.begin(), reference_cloud_farthest_neighbor_squared_distances_.end());
+		double search_radius = std::sqrt((double)max_farthest_neighbor_squared_distance);
+		std::vector<char> cached_point_needs_update(number_of_cached_points, 0);
+		std::vector<int> nn_indices;
+		std::vector<float> nn_squared_distances;
+		for (size_t i = number_of_cached_points; i < reference_cloud->size(); ++i) {
+			int number_of_neighbors_found = reference_search_method->radiusSearch((*reference_cloud)[i], search_radius, nn_indices, nn_squared_distances);
+			for (int j = 0; j < number_of_neighbors_found; ++j) {
+				int neighbor_index = nn_indices[j];
+				if (neighbor_index < (int)number_of_cached_points && nn_squared_distances[j] <= reference_cloud_farthest_neighbor_squared_distances_[neighbor_index]) {
+					cached_point_needs_update[neighbor_index] = 1;
+				}
+			}
+		}
+
+		std::vector<int> indices_to_update;
+		for (size_t i = 0; i < number_of_cached_points; ++i) {
+			if (cached_point_needs_update[i]) { indices_to_update.push_back((int)i); }
+		}
+		for (size_t i = number_of_cached_points; i < reference_cloud->size(); ++i) {
+			indices_to_update.push_back((int)i);
+		}
+
+		covariances_computed = matcher->template computeCovariancesParallel<PointT>(reference_cloud, reference_search_method, *reference_cloud_covariances_, reference_cloud_farthest_neighbor_squared_distances_, &indices_to_update);
+		ROS_DEBUG_STREAM("Updated " << indices_to_update.size() << " of the " << reference_cloud->size() << " GICP covariances of the reference point cloud in " << timer.getElapsedTimeFormated());
+	} else {
+		reference_cloud_covariances_.reset(new typename IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT>::MatricesVector());
+		reference_cloud_farthest_neighbor_squared_distances_.clear();
+		covariances_computed = matcher->template computeCovariancesParallel<PointT>(reference_cloud, reference_search_method, *reference_cloud_covariances_, reference_cloud_farthest_neighbor_squared_distances_);
+		ROS_DEBUG_STREAM("Computed the " << reference_cloud->size() << " GICP covariances of the reference point cloud in " << timer.getElapsedTimeFormated());
+	}
+
+	if (!covariances_computed) {
+		reference_cloud_covariances_.reset();
+		reference_cloud_farthest_neighbor_squared_distances_.clear();
+		reference_cloud_covariances_points_.clear();
+		return;
+	}
+
+	size_t first_point_to_cache = (cached_points_are_prefix ? number_of_cached_points : 0);
+	reference_cloud_covariances_points_.resize(reference_cloud->size());
+	for (size_t i = first_point_to_cache; i < reference_cloud->size(); ++i) {
+		reference_cloud_covariances_points_[i] = (*reference_cloud)[i].getVector3fMap();
+	}
+	reference_cloud_covariances_number_of_neighbors_ = number_of_neighbors;
+}
 // =============================================================================   </protected-section>  =======================================================================
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
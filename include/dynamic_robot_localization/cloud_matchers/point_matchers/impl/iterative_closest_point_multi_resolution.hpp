@@ -0,0 +1,176 @@
+/**\file iterative_closest_point_multi_resolution.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_multi_resolution.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPointMultiResolution-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void IterativeClosestPointMultiResolution<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	private_node_handle->param(configuration_namespace + "normalize_normals_of_pyramid_levels", normalize_normals_of_pyramid_levels_, true);
+
+	pyramid_levels_.clear();
+	XmlRpc::XmlRpcValue pyramid_levels;
+	std::string pyramid_levels_namespace = configuration_namespace + "pyramid_levels/";
+	if (private_node_handle->getParam(configuration_namespace + "pyramid_levels", pyramid_levels) && pyramid_levels.getType() == XmlRpc::XmlRpcValue::TypeStruct) {
+		for (XmlRpc::XmlRpcValue::iterator it = pyramid_levels.begin(); it != pyramid_levels.end(); ++it) {
+			std::string level_namespace = pyramid_levels_namespace + it->first + "/";
+			PyramidLevel pyramid_level;
+			private_node_handle->param(level_namespace + "voxel_grid_leaf_size", pyramid_level.voxel_grid_leaf_size, 0.1);
+			private_node_handle->param(level_namespace + "max_number_of_registration_iterations", pyramid_level.max_number_of_registration_iterations, 10);
+			private_node_handle->param(level_namespace + "max_correspondence_distance", pyramid_level.max_correspondence_distance, 1.0);
+			if (pyramid_level.voxel_grid_leaf_size > 0.0 && pyramid_level.max_number_of_registration_iterations > 0 && pyramid_level.max_correspondence_distance > 0.0) {
+				pyramid_levels_.push_back(pyramid_level);
+			} else {
+				ROS_WARN_STREAM("Ignoring pyramid level [" << it->first << "] of " << configuration_namespace << " because it has invalid parameters");
+			}
+		}
+	}
+
+	std::stable_sort(pyramid_levels_.begin(), pyramid_levels_.end(), [](const PyramidLevel& lhs, const PyramidLevel& rhs) { return lhs.voxel_grid_leaf_size > rhs.voxel_grid_leaf_size; });
+	ROS_DEBUG_STREAM("Using " << pyramid_levels_.size() << " coarse pyramid levels in " << configuration_namespace);
+
+	IterativeClosestPoint<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiResolution<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	IterativeClosestPoint<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+
+	// built from the finest to the coarsest level, in order to filter smaller clouds as the pyramid goes up
+	typename pcl::PointCloud<PointT>::ConstPtr level_input_cloud = reference_cloud;
+	for (int i = (int)pyramid_levels_.size() - 1; i >= 0; --i) {
+		PyramidLevel& pyramid_level = pyramid_levels_[i];
+		buildPyramidLevelCloud(level_input_cloud, pyramid_level.voxel_grid_leaf_size, pyramid_level.reference_cloud);
+		pyramid_level.reference_cloud_search_method.reset(new pcl::search::KdTree<PointT>());
+		pyramid_level.reference_cloud_search_method->setInputCloud(pyramid_level.reference_cloud);
+		level_input_cloud = pyramid_level.reference_cloud;
+		ROS_DEBUG_STREAM("Built reference pyramid level with voxel grid leaf size " << pyramid_level.voxel_grid_leaf_size << " and " << pyramid_level.reference_cloud->size() << " points");
+	}
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiResolution<PointT>::computeRegistrationInitialGuess(Eigen::Matrix4f& initial_guess_in_out) {
+	pyramid_levels_elapsed_time_ms_ = 0.0;
+	typename pcl::Registration<PointT, PointT>::Ptr& cloud_matcher = CloudMatcher<PointT>::cloud_matcher_;
+	if (!cloud_matcher || pyramid_levels_.empty() || !cloud_matcher->getInputSource()) { return; }
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+	typename DefaultConvergenceCriteriaWithTime<float>::Ptr convergence_criteria = IterativeClosestPoint<PointT>::getConvergenceCriteria();
+
+	typename pcl::PointCloud<PointT>::ConstPtr full_resolution_source = cloud_matcher->getInputSource();
+	typename pcl::search::KdTree<PointT>::Ptr full_resolution_source_search_method = cloud_matcher->getSearchMethodSource();
+	int full_resolution_max_number_of_registration_iterations = cloud_matcher->getMaximumIterations();
+	double full_resolution_max_correspondence_distance = cloud_matcher->getMaxCorrespondenceDistance();
+
+	typename pcl::PointCloud<PointT>::ConstPtr level_input_cloud = full_resolution_source;
+	for (int i = (int)pyramid_levels_.size() - 1; i >= 0; --i) {
+		PyramidLevel& pyramid_level = pyramid_levels_[i];
+		buildPyramidLevelCloud(level_input_cloud, pyramid_level.voxel_grid_leaf_size, pyramid_level.ambient_cloud);
+		pyramid_level.ambient_cloud_search_method.reset(new pcl::search::KdTree<PointT>());
+		pyramid_level.ambient_cloud_search_method->setInputCloud(pyramid_level.ambient_cloud); // setSearchMethodSource is called with force_no_recompute
+		level_input_cloud = pyramid_level.ambient_cloud;
+	}
+
+	pcl::PointCloud<PointT> pointcloud_registered;
+	for (size_t i = 0; i < pyramid_levels_.size(); ++i) {
+		PyramidLevel& pyramid_level = pyramid_levels_[i];
+		if (!pyramid_level.reference_cloud || pyramid_level.reference_cloud->size() < 3 || pyramid_level.ambient_cloud->size() < 3) { continue; }
+
+		setupRegistrationData(pyramid_level.ambient_cloud, pyramid_level.ambient_cloud_search_method, pyramid_level.reference_cloud, pyramid_level.reference_cloud_search_method,
+				pyramid_level.max_number_of_registration_iterations, pyramid_level.max_correspondence_distance);
+		cloud_matcher->align(pointcloud_registered, initial_guess_in_out);
+
+		// a level that diverged or stopped far from the solution would send the finer levels off track, so only converged and aligned levels update the initial guess
+		// (the inliers error of the last iteration is used instead of the fitness score, which would need another nearest neighbor pass and would be inflated by the outliers)
+		Eigen::Matrix4f level_transformation = cloud_matcher->getFinalTransformation();
+		double level_root_mean_square_error = (convergence_criteria && convergence_criteria->getNumberCorrespondences() >= 3) ?
+				convergence_criteria->getRootMeanSquareErrorOfLastCorrespondences() : std::numeric_limits<double>::max();
+		if (cloud_matcher->hasConverged() && math_utils::isTransformValid<float>(level_transformation) && level_root_mean_square_error <= pyramid_level.max_correspondence_distance) {
+			initial_guess_in_out = level_transformation;
+		} else {
+			ROS_DEBUG_STREAM("Rejected pyramid level with voxel grid leaf size " << pyramid_level.voxel_grid_leaf_size << " (converged: " << (cloud_matcher->hasConverged() ? "true" : "false")
+					<< " | root mean square error: " << level_root_mean_square_error << " | max correspondence distance: " << pyramid_level.max_correspondence_distance << ")");
+		}
+
+		ROS_DEBUG_STREAM("Pyramid level with voxel grid leaf size " << pyramid_level.voxel_grid_leaf_size << " registered " << pyramid_level.ambient_cloud->size() << " ambient points against "
+				<< pyramid_level.reference_cloud->size() << " reference points in " << IterativeClosestPoint<PointT>::getNumberOfRegistrationIterations() << " iterations");
+	}
+
+	setupRegistrationData(full_resolution_source, full_resolution_source_search_method, CloudMatcher<PointT>::reference_cloud_, CloudMatcher<PointT>::search_method_,
+			full_resolution_max_number_of_registration_iterations, full_resolution_max_correspondence_distance);
+
+	// the time limit (and the adaptive time limit measurements), the iterations telemetry and the elapsed times of the full resolution registration do not include the pyramid levels
+	pyramid_levels_elapsed_time_ms_ = performance_timer.getElapsedTimeInMilliSec();
+	if (convergence_criteria) {
+		convergence_criteria->resetConvergenceTimer();
+		convergence_criteria->resetIterationsHistory();
+	}
+	this->resetCorrespondenceEstimationElapsedTime();
+	this->resetTransformationEstimationElapsedTime();
+	this->resetTransformCloudElapsedTime();
+	ROS_DEBUG_STREAM("Registered " << pyramid_levels_.size() << " pyramid levels in " << pyramid_levels_elapsed_time_ms_ << " ms");
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiResolution<PointT>::buildPyramidLevelCloud(const typename pcl::PointCloud<PointT>::ConstPtr& input_cloud, double voxel_grid_leaf_size, typename pcl::PointCloud<PointT>::Ptr& level_cloud_out) {
+	if (!level_cloud_out) { level_cloud_out.reset(new pcl::PointCloud<PointT>()); }
+
+	pcl::VoxelGrid<PointT> voxel_grid;
+	voxel_grid.setLeafSize(voxel_grid_leaf_size, voxel_grid_leaf_size, voxel_grid_leaf_size);
+	voxel_grid.setDownsampleAllData(true);
+	voxel_grid.setInputCloud(input_cloud);
+	voxel_grid.filter(*level_cloud_out);
+
+	if (normalize_normals_of_pyramid_levels_) {
+		pointcloud_utils::normalizePointCloudNormals(*level_cloud_out);
+	}
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiResolution<PointT>::setupRegistrationData(const typename pcl::PointCloud<PointT>::ConstPtr& source_cloud, const typename pcl::search::KdTree<PointT>::Ptr& source_cloud_search_method,
+		const typename pcl::PointCloud<PointT>::Ptr& target_cloud, const typename pcl::search::KdTree<PointT>::Ptr& target_cloud_search_method,
+		int max_number_of_registration_iterations, double max_correspondence_distance) {
+	typename pcl::Registration<PointT, PointT>::Ptr& cloud_matcher = CloudMatcher<PointT>::cloud_matcher_;
+	cloud_matcher->setInputTarget(target_cloud);
+	cloud_matcher->setSearchMethodTarget(target_cloud_search_method, true);
+	if (cloud_matcher->getCorrespondenceEstimation())
+		cloud_matcher->getCorrespondenceEstimation()->setSearchMethodTarget(target_cloud_search_method, false);
+
+	cloud_matcher->setInputSource(source_cloud);
+	if (source_cloud_search_method)
+		cloud_matcher->setSearchMethodSource(source_cloud_search_method, CloudMatcher<PointT>::force_no_recompute_reciprocal_);
+
+	cloud_matcher->setMaximumIterations(max_number_of_registration_iterations);
+	cloud_matcher->setMaxCorrespondenceDistance(max_correspondence_distance);
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPointMultiResolution-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,213 @@
+/**\file iterative_closest_point_multi_seed.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_multi_seed.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPointMultiSeed-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void IterativeClosestPointMultiSeed<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	private_node_handle->param(configuration_namespace + "seed_position_window_x", seed_position_window_x_, 2.0);
+	private_node_handle->param(configuration_namespace + "seed_position_window_y", seed_position_window_y_, 2.0);
+	private_node_handle->param(configuration_namespace + "seed_position_window_z", seed_position_window_z_, 0.0);
+	private_node_handle->param(configuration_namespace + "seed_position_step", seed_position_step_, 1.0);
+	private_node_handle->param(configuration_namespace + "seed_yaw_window", seed_yaw_window_, M_PI);
+	private_node_handle->param(configuration_namespace + "seed_yaw_step", seed_yaw_step_, M_PI / 6.0);
+	private_node_handle->param(configuration_namespace + "seed_roll_pitch_window", seed_roll_pitch_window_, 0.0);
+	private_node_handle->param(configuration_namespace + "seed_roll_pitch_step", seed_roll_pitch_step_, 0.1);
+	private_node_handle->param(configuration_namespace + "seed_initial_number_of_points", seed_initial_number_of_points_, 100);
+	private_node_handle->param(configuration_namespace + "seed_iterations_per_round", seed_iterations_per_round_, 5);
+	private_node_handle->param(configuration_namespace + "seed_keep_fraction", seed_keep_fraction_, 0.5);
+	private_node_handle->param(configuration_namespace + "number_of_best_seeds", number_of_best_seeds_, 3);
+	private_node_handle->param(configuration_namespace + "seed_max_correspondence_distance", seed_max_correspondence_distance_, 1.0);
+	private_node_handle->param(configuration_namespace + "seed_inlier_distance", seed_inlier_distance_, 0.3);
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
+	seed_keep_fraction_ = std::min(std::max(seed_keep_fraction_, 0.0), 0.9);
+	number_of_best_seeds_ = std::max(number_of_best_seeds_, 1);
+
+	IterativeClosestPoint<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiSeed<PointT>::setPosePrior(const tf2::Transform& pose_prior) {
+	pose_prior_position_ = Eigen::Vector3f((float)pose_prior.getOrigin().getX(), (float)pose_prior.getOrigin().getY(), (float)pose_prior.getOrigin().getZ());
+	pose_prior_available_ = true;
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiSeed<PointT>::computeRegistrationInitialGuess(Eigen::Matrix4f& initial_guess_in_out) {
+	accepted_transformations_->clear();
+	typename pcl::Registration<PointT, PointT>::Ptr& cloud_matcher = CloudMatcher<PointT>::cloud_matcher_;
+	if (!cloud_matcher || !cloud_matcher->getInputSource() || cloud_matcher->getInputSource()->size() < 3 ||
+			!CloudMatcher<PointT>::reference_cloud_ || !CloudMatcher<PointT>::search_method_) { return; }
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+
+	typename pcl::PointCloud<PointT>::ConstPtr source = cloud_matcher->getInputSource();
+	Eigen::Vector3f center = pose_prior_position_;
+	if (!pose_prior_available_) {
+		Eigen::Vector4f centroid;
+		pcl::compute3DCentroid(*source, centroid);
+		center = centroid.head<3>();
+	}
+
+	SeedVector seeds;
+	generateSeeds(center, initial_guess_in_out, seeds);
+
+	// one ICP per thread, all sharing the reference cloud and its search tree
+	int number_of_threads = parallel_utils::getNumberOfThreads(number_of_threads_);
+	seed_matchers_.resize((size_t)number_of_threads);
+	for (size_t i = 0; i < seed_matchers_.size(); ++i) {
+		if (!seed_matchers_[i]) { seed_matchers_[i].reset(new IterativeClosestPointTimeConstrained<PointT, PointT, float>()); }
+		seed_matchers_[i]->setInputTarget(CloudMatcher<PointT>::reference_cloud_);
+		seed_matchers_[i]->setSearchMethodTarget(CloudMatcher<PointT>::search_method_, true);
+		seed_matchers_[i]->setMaximumIterations(std::max(seed_iterations_per_round_, 1));
+		seed_matchers_[i]->setMaxCorrespondenceDistance(seed_max_correspondence_distance_);
+		seed_matchers_[i]->setTransformationEpsilon(cloud_matcher->getTransformationEpsilon());
+		seed_matchers_[i]->setEuclideanFitnessEpsilon(cloud_matcher->getEuclideanFitnessEpsilon());
+	}
+
+	// successive halving, with the number of source points doubling in each round
+	size_t number_of_initial_seeds = seeds.size();
+	size_t number_of_points = std::min(source->size(), (size_t)std::max(seed_initial_number_of_points_, 3));
+	typename pcl::PointCloud<PointT>::Ptr source_sample(new pcl::PointCloud<PointT>());
+	int number_of_rounds = 0;
+	while (!seeds.empty()) {
+		source_sample->clear();
+		double step = (double)source->size() / (double)number_of_points;
+		for (size_t i = 0; i < number_of_points; ++i) {
+			source_sample->push_back((*source)[std::min((size_t)(i * step), source->size() - 1)]);
+		}
+
+		runSeedsRound(source_sample, seeds);
+		++number_of_rounds;
+		std::stable_sort(seeds.begin(), seeds.end(), [](const Seed& lhs, const Seed& rhs) { return lhs.score > rhs.score; });
+
+		if (seeds.size() <= (size_t)number_of_best_seeds_) { break; }
+		size_t number_of_kept_seeds = std::min(seeds.size() - 1, std::max((size_t)number_of_best_seeds_, (size_t)std::ceil((double)seeds.size() * seed_keep_fraction_)));
+		seeds.resize(number_of_kept_seeds);
+		number_of_points = std::min(source->size(), number_of_points * 2);
+	}
+
+	if (seeds.empty() || seeds.front().score <= 0.0f) {
+		ROS_DEBUG_STREAM("Multi seed ICP did not find seeds with inliers (" << number_of_initial_seeds << " seeds evaluated in " << performance_timer.getElapsedTimeFormated() << ")");
+		return;
+	}
+
+	initial_guess_in_out = seeds.front().transformation;
+	for (size_t i = 0; i < seeds.size(); ++i) {
+		accepted_transformations_->push_back(seeds[i].transformation);
+	}
+
+	ROS_DEBUG_STREAM("Multi seed ICP selected a seed with " << seeds.front().score << " inlier fraction from " << number_of_initial_seeds << " seeds in " << number_of_rounds
+			<< " rounds (" << performance_timer.getElapsedTimeFormated() << ")");
+
+	// the time limit of the full resolution registration does not include the seeds search
+	typename DefaultConvergenceCriteriaWithTime<float>::Ptr convergence_criteria = IterativeClosestPoint<PointT>::getConvergenceCriteria();
+	if (convergence_criteria) {
+		convergence_criteria->resetConvergenceTimer();
+	}
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiSeed<PointT>::generateSeeds(const Eigen::Vector3f& center, const Eigen::Matrix4f& initial_guess, SeedVector& seeds_out) const {
+	seeds_out.clear();
+	std::vector<float> yaw_angles, roll_pitch_angles;
+	s_computeAngles(seed_yaw_window_, seed_yaw_step_, yaw_angles);
+	s_computeAngles(seed_roll_pitch_window_, seed_roll_pitch_step_, roll_pitch_angles);
+
+	int number_of_steps_x = (seed_position_step_ > 0.0) ? (int)std::floor(seed_position_window_x_ / seed_position_step_) : 0;
+	int number_of_steps_y = (seed_position_step_ > 0.0) ? (int)std::floor(seed_position_window_y_ / seed_position_step_) : 0;
+	int number_of_steps_z = (seed_position_step_ > 0.0) ? (int)std::floor(seed_position_window_z_ / seed_position_step_) : 0;
+
+	// rotations around the center followed by the position offset
+	Eigen::Affine3f center_to_origin(Eigen::Translation3f(-center));
+	for (size_t yaw = 0; yaw < yaw_angles.size(); ++yaw) {
+		for (size_t pitch = 0; pitch < roll_pitch_angles.size(); ++pitch) {
+			for (size_t roll = 0; roll < roll_pitch_angles.size(); ++roll) {
+				Eigen::Matrix3f rotation = (Eigen::AngleAxisf(yaw_angles[yaw], Eigen::Vector3f::UnitZ())
+						* Eigen::AngleAxisf(roll_pitch_angles[pitch], Eigen::Vector3f::UnitY())
+						* Eigen::AngleAxisf(roll_pitch_angles[roll], Eigen::Vector3f::UnitX())).toRotationMatrix();
+				for (int z = -number_of_steps_z; z <= number_of_steps_z; ++z) {
+					for (int y = -number_of_steps_y; y <= number_of_steps_y; ++y) {
+						for (int x = -number_of_steps_x; x <= number_of_steps_x; ++x) {
+							Eigen::Vector3f offset((float)(x * seed_position_step_), (float)(y * seed_position_step_), (float)(z * seed_position_step_));
+							Eigen::Affine3f seed_transformation = Eigen::Translation3f(center + offset) * rotation * center_to_origin;
+							Seed seed;
+							seed.transformation = seed_transformation.matrix() * initial_guess;
+							seed.score = 0.0f;
+							seeds_out.push_back(seed);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiSeed<PointT>::runSeedsRound(const typename pcl::PointCloud<PointT>::Ptr& source_sample, SeedVector& seeds) {
+	#pragma omp parallel num_threads((int)seed_matchers_.size())
+	{
+		typename IterativeClosestPointTimeConstrained<PointT, PointT, float>::Ptr& seed_matcher = seed_matchers_[(size_t)parallel_utils::getThreadNumber()];
+		seed_matcher->setInputSource(source_sample);
+		pcl::PointCloud<PointT> source_registered;
+
+		#pragma omp for schedule(dynamic, 1)
+		for (long i = 0; i < (long)seeds.size(); ++i) {
+			Seed& seed = seeds[i];
+			seed_matcher->align(source_registered, seed.transformation);
+			Eigen::Matrix4f seed_transformation = seed_matcher->getFinalTransformation();
+			if (math_utils::isTransformValid<float>(seed_transformation)) {
+				seed.transformation = seed_transformation;
+				seed.score = CloudMatcher<PointT>::computeInlierFraction(*source_sample, seed.transformation, seed_inlier_distance_);
+			} else {
+				seed.score = 0.0f;
+			}
+		}
+	}
+}
+
+
+template<typename PointT>
+void IterativeClosestPointMultiSeed<PointT>::s_computeAngles(double window, double step, std::vector<float>& angles_out) {
+	angles_out.clear();
+	angles_out.push_back(0.0f);
+	if (window <= 0.0 || step <= 0.0) { return; }
+
+	int number_of_steps_per_side = (int)std::floor(std::min(window, M_PI) / step + 1e-6);
+	for (int i = 1; i <= number_of_steps_per_side; ++i) {
+		angles_out.push_back((float)(i * step));
+		// -pi and pi are the same angle
+		if (i * step < M_PI - 1e-6) { angles_out.push_back((float)(-i * step)); }
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPointMultiSeed-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
@@ -0,0 +1,386 @@
+/**\file iterative_closest_point_transform_free.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_transform_free.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// ########################################################   iterative_closest_point_transform_free_time_constrained   ########################################################
+template <typename PointSource, typename PointTarget, typename Scalar>
+void IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar>::computeTransformation(PointCloudSource &output, const Matrix4 &guess) {
+	nr_iterations_ = 0;
+	converged_ = false;
+	final_transformation_ = guess;
+	transformation_ = Matrix4::Identity();
+
+	if (!input_ || !target_ || !indices_ || !tree_) {
+		return;
+	}
+
+	if (use_reciprocal_correspondence_ && !pcl::Registration<PointSource, PointTarget, Scalar>::initComputeReciprocal()) {
+		return;
+	}
+
+	std::vector<bool> rejectors_requiring_aligned_source;
+	setupCorrespondenceRejectors(rejectors_requiring_aligned_source);
+
+	convergence_criteria_->setMaximumIterations(max_iterations_);
+	convergence_criteria_->setRelativeMSE(euclidean_fitness_epsilon_);
+	convergence_criteria_->setTranslationThreshold(transformation_epsilon_);
+	if (transformation_rotation_epsilon_ > 0)
+		convergence_criteria_->setRotationThreshold(transformation_rotation_epsilon_);
+	else
+		convergence_criteria_->setRotationThreshold(1.0 - transformation_epsilon_);
+
+	do {
+		previous_transformation_ = transformation_;
+		Eigen::Matrix4f source_to_target_transform = final_transformation_.template cast<float>();
+
+		PerformanceTimer timer;
+		timer.start();
+		determineCorrespondencesWithTransform(source_to_target_transform, *correspondences_);
+		correspondence_estimation_elapsed_time_ms_ += timer.getElapsedTimeInMilliSec();
+
+		applyCorrespondenceRejectors(rejectors_requiring_aligned_source, source_to_target_transform);
+
+		if ((int)correspondences_->size() < min_number_correspondences_) {
+			convergence_criteria_->setConvergenceState(pcl::registration::DefaultConvergenceCriteria<Scalar>::CONVERGENCE_CRITERIA_NO_CORRESPONDENCES);
+			converged_ = false;
+			break;
+		}
+
+		timer.restart();
+		bool transformation_estimated = estimateIncrementalTransformation(source_to_target_transform, *correspondences_, transformation_);
+		transformation_estimation_elapsed_time_ms_ += timer.getElapsedTimeInMilliSec();
+		if (!transformation_estimated) {
+			convergence_criteria_->setConvergenceState(pcl::registration::DefaultConvergenceCriteria<Scalar>::CONVERGENCE_CRITERIA_NO_CORRESPONDENCES);
+			converged_ = false;
+			break;
+		}
+
+		final_transformation_ = transformation_ * final_transformation_;
+		++nr_iterations_;
+
+		if (update_visualizer_) {
+			std::vector<int> source_indices_good, target_indices_good;
+			source_indices_good.reserve(correspondences_->size());
+			target_indices_good.reserve(correspondences_->size());
+			for (size_t i = 0; i < correspondences_->size(); ++i) {
+				source_indices_good.push_back((*correspondences_)[i].index_query);
+				target_indices_good.push_back((*correspondences_)[i].index_match);
+			}
+			PointCloudSource input_transformed;
+			transformCloud(*input_, input_transformed, final_transformation_);
+			update_visualizer_(input_transformed, source_indices_good, *target_, target_indices_good);
+		}
+
+		converged_ = static_cast<bool>((*convergence_criteria_));
+	} while (convergence_criteria_->getConvergenceState() == pcl::registration::DefaultConvergenceCriteria<Scalar>::CONVERGENCE_CRITERIA_NOT_CONVERGED);
+
+	output = *input_;
+	transformCloud(*input_, output, final_transformation_);
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar>::determineCorrespondencesWithTransform(const Eigen::Matrix4f& source_to_target_transform, pcl::Correspondences& correspondences_out) {
+	const int number_of_queries = (int)indices_->size();
+	const float max_distance_squared = (float)(corr_dist_threshold_ * corr_dist_threshold_);
+	const Eigen::Matrix3f rotation = source_to_target_transform.block<3, 3>(0, 0);
+	const Eigen::Vector3f translation = source_to_target_transform.block<3, 1>(0, 3);
+	const Eigen::Matrix3f rotation_inverse = rotation.transpose();
+	const bool use_reciprocal_correspondences = use_reciprocal_correspondence_ && tree_reciprocal_;
+
+	correspondences_candidates_.resize(number_of_queries);
+
+	#pragma omp parallel num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	{
+		std::vector<int> nn_indices(1);
+		std::vector<float> nn_distances(1);
+		std::vector<int> nn_indices_reciprocal(1);
+		std::vector<float> nn_distances_reciprocal(1);
+		PointTarget query_point;
+		PointSource query_point_reciprocal;
+
+		#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < number_of_queries; ++i) {
+			pcl::Correspondence& correspondence = correspondences_candidates_[i];
+			correspondence.index_match = -1;
+
+			int source_index = (*indices_)[i];
+			query_point.getVector3fMap() = rotation * (*input_)[source_index].getVector3fMap() + translation;
+			if (tree_->nearestKSearch(query_point, 1, nn_indices, nn_distances) < 1 || nn_distances[0] > max_distance_squared) {
+				continue;
+			}
+
+			if (use_reciprocal_correspondences) {
+				query_point_reciprocal.getVector3fMap() = rotation_inverse * ((*target_)[nn_indices[0]].getVector3fMap() - translation);
+				if (tree_reciprocal_->nearestKSearch(query_point_reciprocal, 1, nn_indices_reciprocal, nn_distances_reciprocal) < 1 || nn_indices_reciprocal[0] != source_index) {
+					continue;
+				}
+			}
+
+			correspondence.index_query = source_index;
+			correspondence.index_match = nn_indices[0];
+			correspondence.distance = nn_distances[0];
+		}
+	}
+
+	correspondences_out.clear();
+	correspondences_out.reserve(number_of_queries);
+	for (int i = 0; i < number_of_queries; ++i) {
+		if (correspondences_candidates_[i].index_match >= 0) {
+			correspondences_out.push_back(correspondences_candidates_[i]);
+		}
+	}
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar>::setupCorrespondenceRejectors(std::vector<bool>& rejectors_requiring_aligned_source_out) {
+	rejectors_requiring_aligned_source_out.assign(correspondence_rejectors_.size(), false);
+	if (correspondence_rejectors_.empty()) { return; }
+
+	pcl::PCLPointCloud2::Ptr target_blob(new pcl::PCLPointCloud2());
+	pcl::PCLPointCloud2::Ptr source_blob;
+	pcl::toPCLPointCloud2(*target_, *target_blob);
+
+	for (size_t i = 0; i < correspondence_rejectors_.size(); ++i) {
+		pcl::registration::CorrespondenceRejector::Ptr& rejector = correspondence_rejectors_[i];
+		if (rejector->requiresTargetPoints()) { rejector->setTargetPoints(target_blob); }
+		if (rejector->requiresTargetNormals()) { rejector->setTargetNormals(target_blob); }
+
+		if (rejector->requiresSourcePoints() || rejector->requiresSourceNormals()) {
+			// rejectors that only depend on the relative geometry of the correspondences are invariant to the rigid transformation of the source, and can use the original source cloud
+			if (std::dynamic_pointer_cast< pcl::registration::CorrespondenceRejectorSampleConsensus<PointSource> >(rejector) ||
+					std::dynamic_pointer_cast< pcl::registration::CorrespondenceRejectorPoly<PointSource, PointTarget> >(rejector)) {
+				if (!source_blob) {
+					source_blob.reset(new pcl::PCLPointCloud2());
+					pcl::toPCLPointCloud2(*input_, *source_blob);
+				}
+				if (rejector->requiresSourcePoints()) { rejector->setSourcePoints(source_blob); }
+				if (rejector->requiresSourceNormals()) { rejector->setSourceNormals(source_blob); }
+			} else {
+				rejectors_requiring_aligned_source_out[i] = true;
+			}
+		}
+	}
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar>::applyCorrespondenceRejectors(const std::vector<bool>& rejectors_requiring_aligned_source, const Eigen::Matrix4f& source_to_target_transform) {
+	if (correspondence_rejectors_.empty()) { return; }
+
+	pcl::PCLPointCloud2::Ptr aligned_source_blob;
+	if (std::find(rejectors_requiring_aligned_source.begin(), rejectors_requiring_aligned_source.end(), true) != rejectors_requiring_aligned_source.end()) {
+		if (!aligned_source_) { aligned_source_.reset(new PointCloudSource()); }
+		transformCloud(*input_, *aligned_source_, source_to_target_transform.template cast<Scalar>());
+		aligned_source_blob.reset(new pcl::PCLPointCloud2());
+		pcl::toPCLPointCloud2(*aligned_source_, *aligned_source_blob);
+	}
+
+	pcl::CorrespondencesPtr temp_correspondences(new pcl::Correspondences(*correspondences_));
+	for (size_t i = 0; i < correspondence_rejectors_.size(); ++i) {
+		pcl::registration::CorrespondenceRejector::Ptr& rejector = correspondence_rejectors_[i];
+		if (rejectors_requiring_aligned_source[i]) {
+			if (rejector->requiresSourcePoints()) { rejector->setSourcePoints(aligned_source_blob); }
+			if (rejector->requiresSourceNormals()) { rejector->setSourceNormals(aligned_source_blob); }
+		}
+		rejector->setInputCorrespondences(temp_correspondences);
+		rejector->getCorrespondences(*correspondences_);
+		if (i < correspondence_rejectors_.size() - 1) { *temp_correspondences = *correspondences_; }
+	}
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+bool IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar>::estimateIncrementalTransformation(const Eigen::Matrix4f& source_to_target_transform, const pcl::Correspondences& correspondences, Matrix4& incremental_transformation_out) {
+	if (error_metric_ == PointToPlane) {
+		return estimateIncrementalTransformationPointToPlane(source_to_target_transform, correspondences, incremental_transformation_out);
+	}
+	return estimateIncrementalTransformationPointToPoint(source_to_target_transform, correspondences, incremental_transformation_out);
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+bool IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar>::estimateIncrementalTransformationPointToPoint(const Eigen::Matrix4f& source_to_target_transform, const pcl::Correspondences& correspondences, Matrix4& incremental_transformation_out) {
+	const Eigen::Matrix3d rotation = source_to_target_transform.block<3, 3>(0, 0).template cast<double>();
+	const Eigen::Vector3d translation = source_to_target_transform.block<3, 1>(0, 3).template cast<double>();
+
+	PointToPointAccumulator sums = parallel_utils::computeDeterministicBlockReduction(correspondences.size(), PointToPointAccumulator(),
+			[&](size_t block_start, size_t block_end, PointToPointAccumulator& block_sums) {
+				for (size_t i = block_start; i < block_end; ++i) {
+					Eigen::Vector3d source_point = rotation * (*input_)[correspondences[i].index_query].getVector3fMap().template cast<double>() + translation;
+					Eigen::Vector3d target_point = (*target_)[correspondences[i].index_match].getVector3fMap().template cast<double>();
+					block_sums.source_sum += source_point;
+					block_sums.target_sum += target_point;
+					block_sums.source_target_products_sum.noalias() += source_point * target_point.transpose();
+					++block_sums.number_of_correspondences;
+				}
+			}, number_of_threads_);
+
+	if (sums.number_of_correspondences < 3) { return false; }
+
+	double number_of_correspondences = (double)sums.number_of_correspondences;
+	Eigen::Vector3d source_centroid = sums.source_sum / number_of_correspondences;
+	Eigen::Vector3d target_centroid = sums.target_sum / number_of_correspondences;
+	Eigen::Matrix3d cross_covariance = sums.source_target_products_sum - number_of_correspondences * source_centroid * target_centroid.transpose();
+
+	Eigen::Matrix3d incremental_rotation = Eigen::Matrix3d::Identity();
+	Eigen::Vector3d incremental_translation = Eigen::Vector3d::Zero();
+	if (error_metric_ == PointToPoint2D) {
+		double yaw = std::atan2(cross_covariance(0, 1) - cross_covariance(1, 0), cross_covariance(0, 0) + cross_covariance(1, 1));
+		incremental_rotation = Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+		incremental_translation.head<2>() = target_centroid.head<2>() - (incremental_rotation * source_centroid).head<2>();
+	} else {
+		Eigen::JacobiSVD<Eigen::Matrix3d> svd(cross_covariance, Eigen::ComputeFullU | Eigen::ComputeFullV);
+		Eigen::Matrix3d v = svd.matrixV();
+		incremental_rotation = v * svd.matrixU().transpose();
+		if (incremental_rotation.determinant() < 0) {
+			v.col(2) *= -1.0;
+			incremental_rotation = v * svd.matrixU().transpose();
+		}
+		incremental_translation = target_centroid - incremental_rotation * source_centroid;
+	}
+
+	incremental_transformation_out = Matrix4::Identity();
+	incremental_transformation_out.template block<3, 3>(0, 0) = incremental_rotation.template cast<Scalar>();
+	incremental_transformation_out.template block<3, 1>(0, 3) = incremental_translation.template cast<Scalar>();
+	return true;
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+bool IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar>::estimateIncrementalTransformationPointToPlane(const Eigen::Matrix4f& source_to_target_transform, const pcl::Correspondences& correspondences, Matrix4& incremental_transformation_out) {
+	const Eigen::Matrix3d rotation = source_to_target_transform.block<3, 3>(0, 0).template cast<double>();
+	const Eigen::Vector3d translation = source_to_target_transform.block<3, 1>(0, 3).template cast<double>();
+
+	PointToPlaneAccumulator normal_equations = parallel_utils::computeDeterministicBlockReduction(correspondences.size(), PointToPlaneAccumulator(PointToPlaneAccumulator::Zero()),
+			[&](size_t block_start, size_t block_end, PointToPlaneAccumulator& block_normal_equations) {
+				Eigen::Matrix<double, 6, 1> jacobian_row;
+				for (size_t i = block_start; i < block_end; ++i) {
+					const PointTarget& target = (*target_)[correspondences[i].index_match];
+					Eigen::Vector3d target_normal = target.getNormalVector3fMap().template cast<double>();
+					if (!target_normal.allFinite()) { continue; }
+					Eigen::Vector3d source_point = rotation * (*input_)[correspondences[i].index_query].getVector3fMap().template cast<double>() + translation;
+					jacobian_row.head<3>() = source_point.cross(target_normal);
+					jacobian_row.tail<3>() = target_normal;
+					double residual = target_normal.dot(target.getVector3fMap().template cast<double>() - source_point);
+					block_normal_equations.template block<6, 6>(0, 0).noalias() += jacobian_row * jacobian_row.transpose();
+					block_normal_equations.template block<6, 1>(0, 6) += jacobian_row * residual;
+				}
+			}, number_of_threads_);
+
+	Eigen::LDLT< Eigen::Matrix<double, 6, 6> > solver(normal_equations.template block<6, 6>(0, 0));
+	if (solver.info() != Eigen::Success) { return false; }
+	Eigen::Matrix<double, 6, 1> x = solver.solve(normal_equations.template block<6, 1>(0, 6));
+	if (!x.allFinite()) { return false; }
+
+	Eigen::Matrix3d incremental_rotation = (Eigen::AngleAxisd(x(2), Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(x(1), Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(x(0), Eigen::Vector3d::UnitX())).toRotationMatrix();
+	incremental_transformation_out = Matrix4::Identity();
+	incremental_transformation_out.template block<3, 3>(0, 0) = incremental_rotation.template cast<Scalar>();
+	incremental_transformation_out.template block<3, 1>(0, 3) = x.tail<3>().template cast<Scalar>();
+	return true;
+}
+
+
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPointTransformFree-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void IterativeClosestPointTransformFree<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	typename pcl::Registration<PointT, PointT, float>::Ptr matcher_base(new IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>());
+	typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr matcher = std::dynamic_pointer_cast< typename dynamic_robot_localization::IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT> >(matcher_base);
+
+	std::string error_metric;
+	private_node_handle->param(configuration_namespace + "transform_free_error_metric", error_metric, std::string("PointToPoint"));
+	if (error_metric == "PointToPoint2D") {
+		matcher->setErrorMetric(IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::PointToPoint2D);
+	} else if (error_metric == "PointToPlane") {
+		matcher->setErrorMetric(IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::PointToPlane);
+	} else {
+		if (error_metric != "PointToPoint") { ROS_WARN_STREAM("Unknown transform_free_error_metric [" << error_metric << "] -> using PointToPoint"); }
+		matcher->setErrorMetric(IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::PointToPoint);
+	}
+
+	int number_of_threads;
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads, 0);
+	matcher->setNumberOfThreads(number_of_threads);
+
+	CloudMatcher<PointT>::setCloudMatcher(matcher_base);
+	IterativeClosestPoint<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+
+template<typename PointT>
+typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr IterativeClosestPointTransformFree<PointT>::getTransformFreeMatcher() {
+	return std::dynamic_pointer_cast< IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT> >(CloudMatcher<PointT>::cloud_matcher_);
+}
+
+
+template<typename PointT>
+double IterativeClosestPointTransformFree<PointT>::getCorrespondenceEstimationElapsedTimeMS() {
+	typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr matcher = getTransformFreeMatcher();
+	if (matcher) { return matcher->getCorrespondenceEstimationElapsedTime(); }
+	return -1.0;
+}
+
+
+template<typename PointT>
+void IterativeClosestPointTransformFree<PointT>::resetCorrespondenceEstimationElapsedTime() {
+	typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr matcher = getTransformFreeMatcher();
+	if (matcher) { matcher->resetCorrespondenceEstimationElapsedTime(); }
+}
+
+
+template<typename PointT>
+double IterativeClosestPointTransformFree<PointT>::getTransformationEstimationElapsedTimeMS() {
+	typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr matcher = getTransformFreeMatcher();
+	if (matcher) { return matcher->getTransformationEstimationElapsedTime(); }
+	return -1.0;
+}
+
+
+template<typename PointT>
+void IterativeClosestPointTransformFree<PointT>::resetTransformationEstimationElapsedTime() {
+	typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr matcher = getTransformFreeMatcher();
+	if (matcher) { matcher->resetTransformationEstimationElapsedTime(); }
+}
+
+
+template<typename PointT>
+double IterativeClosestPointTransformFree<PointT>::getTransformCloudElapsedTimeMS() {
+	typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr matcher = getTransformFreeMatcher();
+	if (matcher) { return matcher->getTransformCloudElapsedTime(); }
+	return -1.0;
+}
+
+
+template<typename PointT>
+void IterativeClosestPointTransformFree<PointT>::resetTransformCloudElapsedTime() {
+	typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr matcher = getTransformFreeMatcher();
+	if (matcher) { matcher->resetTransformCloudElapsedTime(); }
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPointTransformFree-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
@@ -18,10 +18,119 @@ namespace dynamic_robot_localization {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalDistributionsTransform2DParallel-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransform2DParallel<PointSource, PointTarget>::computeTransformation(PointCloudSource &output, const Eigen::Matrix4f &guess) {
+	PointCloudSource intermediate_cloud = output;
+
+	nr_iterations_ = 0;
+	converged_ = false;
+
+	if (guess != Eigen::Matrix4f::Identity()) {
+		transformation_ = guess;
+		pcl::transformPointCloud(output, intermediate_cloud, transformation_);
+	}
+
+	updateTargetGrid();
+	const TargetGrid& target_grid = *target_grid_;
+
+	// x translation, y translation and z rotation
+	Eigen::Matrix4f& transformation = transformation_;
+	const Eigen::Matrix3f initial_rotation(transformation.block<3, 3>(0, 0));
+	const Eigen::Vector3f rotation_x(initial_rotation * Eigen::Vector3f::UnitX());
+	Eigen::Vector3d xytheta_transformation(transformation(0, 3), transformation(1, 3), std::atan2(rotation_x[1], rotation_x[0]));
+
+	while (!converged_) {
+		const double cos_theta = std::cos(xytheta_transformation[2]);
+		const double sin_theta = std::sin(xytheta_transformation[2]);
+		previous_transformation_ = transformation;
+
+		ScoreAndDerivatives score = parallel_utils::computeDeterministicBlockReduction(intermediate_cloud.size(), ScoreAndDerivatives::Zero(),
+				[&](size_t block_start, size_t block_end, ScoreAndDerivatives& block_score) {
+					for (size_t i = block_start; i < block_end; ++i) {
+						block_score += target_grid.test(intermediate_cloud[i], cos_theta, sin_theta);
+					}
+				}, number_of_threads_, block_size_);
+
+		if (score.value != 0) {
+			// ensure positive definiteness of the hessian
+			Eigen::EigenSolver<Eigen::Matrix3d> solver;
+			solver.compute(score.hessian, false);
+			double min_eigenvalue = 0;
+			for (int i = 0; i < 3; ++i) {
+				if (solver.eigenvalues()[i].real() < min_eigenvalue) {
+					min_eigenvalue = solver.eigenvalues()[i].real();
+				}
+			}
+
+			if (min_eigenvalue < 0) {
+				double lambda = 1.1 * min_eigenvalue - 1;
+				score.hessian += Eigen::Vector3d(-lambda, -lambda, -lambda).asDiagonal();
+			}
+
+			Eigen::Vector3d delta_transformation(-score.hessian.inverse() * score.grad);
+			xytheta_transformation += newton_lambda_.cwiseProduct(delta_transformation);
+
+			transformation.block<3, 3>(0, 0).matrix() = Eigen::Matrix3f(Eigen::AngleAxisf(static_cast<float>(xytheta_transformation[2]), Eigen::Vector3f::UnitZ()));
+			transformation.block<3, 1>(0, 3).matrix() = Eigen::Vector3f(static_cast<float>(xytheta_transformation[0]), static_cast<float>(xytheta_transformation[1]), 0.0f);
+		} else {
+			PCL_ERROR("[NormalDistributionsTransform2DParallel::computeTransformation] no overlap: try increasing the size or reducing the step of the grid\n");
+			break;
+		}
+
+		pcl::transformPointCloud(output, intermediate_cloud, transformation);
+
+		++nr_iterations_;
+
+		if (update_visualizer_) {
+			update_visualizer_(output, *indices_, *target_, *indices_);
+		}
+
+		Eigen::Matrix4f transformation_delta = transformation.inverse() * previous_transformation_;
+		double cos_angle = 0.5 * (transformation_delta.coeff(0, 0) + transformation_delta.coeff(1, 1) + transformation_delta.coeff(2, 2) - 1);
+		double translation_sqr = transformation_delta.block<3, 1>(0, 3).squaredNorm();
+
+		if (nr_iterations_ >= max_iterations_ ||
+				((transformation_epsilon_ > 0 && translation_sqr <= transformation_epsilon_) && (transformation_rotation_epsilon_ > 0 && cos_angle >= transformation_rotation_epsilon_)) ||
+				((transformation_epsilon_ <= 0) && (transformation_rotation_epsilon_ > 0 && cos_angle >= transformation_rotation_epsilon_)) ||
+				((transformation_epsilon_ > 0 && translation_sqr <= transformation_epsilon_) && (transformation_rotation_epsilon_ <= 0))) {
+			converged_ = true;
+		}
+	}
+
+	final_transformation_ = transformation;
+	output = intermediate_cloud;
+}
+
+
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransform2DParallel<PointSource, PointTarget>::updateTargetGrid() {
+	if (!target_grid_ || target_grid_centre_ != grid_centre_ || target_grid_step_ != grid_step_ || target_grid_extent_ != grid_extent_) {
+		target_grid_ = std::make_shared<TargetGrid>(target_, grid_centre_, grid_extent_, grid_step_);
+		target_grid_centre_ = grid_centre_;
+		target_grid_step_ = grid_step_;
+		target_grid_extent_ = grid_extent_;
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalDistributionsTransform2DParallel-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalDistributionsTransform2D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
 void NormalDistributionsTransform2D<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
-	typename pcl::Registration<PointT, PointT, float>::Ptr matcher_base(new NormalDistributionsTransform2DDetailed<PointT, PointT>());
+	int number_of_threads;
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads, 0);
+	private_node_handle->param(configuration_namespace + "reuse_target_grid_when_reference_cloud_is_unchanged", reuse_target_grid_when_reference_cloud_is_unchanged_, true);
+
+	typename pcl::Registration<PointT, PointT, float>::Ptr matcher_base;
+	if (number_of_threads == 1) {
+		matcher_base = typename pcl::Registration<PointT, PointT, float>::Ptr(new NormalDistributionsTransform2DDetailed<PointT, PointT>());
+	} else {
+		typename NormalDistributionsTransform2DParallel<PointT, PointT>::Ptr matcher_parallel(new NormalDistributionsTransform2DParallel<PointT, PointT>());
+		matcher_parallel->setNumberOfThreads(number_of_threads);
+		matcher_base = matcher_parallel;
+	}
+
 	typename pcl::NormalDistributionsTransform2D<PointT, PointT>::Ptr matcher = std::static_pointer_cast< typename pcl::NormalDistributionsTransform2D<PointT, PointT> >(matcher_base);
 
 	double transformation_rotation_epsilon;
@@ -54,6 +163,26 @@ void NormalDistributionsTransform2D<PointT>::setupConfigurationFromParameterServ
 }
 
 
+template<typename PointT>
+void NormalDistributionsTransform2D<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	// setInputTarget discards the target grid of NormalDistributionsTransform2DParallel
+	if (reuse_target_grid_when_reference_cloud_is_unchanged_ && CloudMatcher<PointT>::cloud_matcher_ && reference_cloud && CloudMatcher<PointT>::cloud_matcher_->getInputTarget() == reference_cloud &&
+			reference_cloud->size() == reference_cloud_number_of_points_ && reference_cloud->header.stamp == reference_cloud_stamp_) {
+		ROS_DEBUG_STREAM("Reusing the NDT 2D target grid of the unchanged reference point cloud with " << reference_cloud->size() << " points");
+		CloudMatcher<PointT>::reference_cloud_keypoints_ = reference_cloud_keypoints;
+		CloudMatcher<PointT>::search_method_ = search_method;
+		return;
+	}
+
+	if (reference_cloud) {
+		reference_cloud_number_of_points_ = reference_cloud->size();
+		reference_cloud_stamp_ = reference_cloud->header.stamp;
+	}
+	CloudMatcher<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+}
+
+
 template<typename PointT>
 int NormalDistributionsTransform2D<PointT>::getNumberOfRegistrationIterations() {
 	if (CloudMatcher<PointT>::cloud_matcher_) {
@@ -18,10 +18,293 @@ namespace dynamic_robot_localization {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalDistributionsTransformParallel-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransformParallel<PointSource, PointTarget>::computeTransformation(PointCloudSource &output, const Eigen::Matrix4f &guess) {
+	nr_iterations_ = 0;
+	converged_ = false;
+
+	// gaussian fitting parameters (eq. 6.8) [Magnusson 2009]
+	double gauss_c1 = 10.0 * (1.0 - outlier_ratio_);
+	double gauss_c2 = outlier_ratio_ / std::pow(resolution_, 3);
+	double gauss_d3 = -std::log(gauss_c2);
+	gauss_d1_ = -std::log(gauss_c1 + gauss_c2) - gauss_d3;
+	gauss_d2_ = -2.0 * std::log((-std::log(gauss_c1 * std::exp(-0.5) + gauss_c2) - gauss_d3) / gauss_d1_);
+
+	if (guess != Eigen::Matrix4f::Identity()) {
+		final_transformation_ = guess;
+		pcl::transformPointCloud(output, output, guess);
+	}
+
+	Eigen::Transform<float, 3, Eigen::Affine, Eigen::ColMajor> eigen_transformation;
+	eigen_transformation.matrix() = final_transformation_;
+	Eigen::Matrix<double, 6, 1> transform, score_gradient;
+	Eigen::Vector3f initial_translation = eigen_transformation.translation();
+	Eigen::Vector3f initial_rotation = eigen_transformation.rotation().eulerAngles(0, 1, 2);
+	transform << initial_translation.template cast<double>(), initial_rotation.template cast<double>();
+
+	Eigen::Matrix<double, 6, 6> hessian;
+	double score = computeDerivativesParallel(score_gradient, hessian, output, transform);
+
+	while (!converged_) {
+		previous_transformation_ = transformation_;
+
+		// newton descent direction (negative for maximization)
+		Eigen::JacobiSVD< Eigen::Matrix<double, 6, 6> > svd(hessian, Eigen::ComputeFullU | Eigen::ComputeFullV);
+		Eigen::Matrix<double, 6, 1> delta = svd.solve(-score_gradient);
+
+		double delta_norm = delta.norm();
+		if (delta_norm == 0 || std::isnan(delta_norm)) {
+			trans_probability_ = score / static_cast<double>(input_->size());
+			converged_ = (delta_norm == 0);
+			return;
+		}
+
+		delta /= delta_norm;
+		delta_norm = computeStepLengthMTParallel(transform, delta, delta_norm, step_size_, transformation_epsilon_ / 2.0, score, score_gradient, hessian, output);
+		delta *= delta_norm;
+
+		convertTransform(delta, transformation_);
+		transform += delta;
+
+		if (update_visualizer_) {
+			update_visualizer_(output, std::vector<int>(), *target_, std::vector<int>());
+		}
+
+		double cos_angle = 0.5 * (transformation_.template block<3, 3>(0, 0).trace() - 1.0);
+		double translation_sqr = transformation_.template block<3, 1>(0, 3).squaredNorm();
+
+		++nr_iterations_;
+
+		if (nr_iterations_ >= max_iterations_ ||
+				((transformation_epsilon_ > 0 && translation_sqr <= transformation_epsilon_) && (transformation_rotation_epsilon_ > 0 && cos_angle >= transformation_rotation_epsilon_)) ||
+				((transformation_epsilon_ <= 0) && (transformation_rotation_epsilon_ > 0 && cos_angle >= transformation_rotation_epsilon_)) ||
+				((transformation_epsilon_ > 0 && translation_sqr <= transformation_epsilon_) && (transformation_rotation_epsilon_ <= 0))) {
+			converged_ = true;
+		}
+	}
+
+	trans_probability_ = score / static_cast<double>(input_->size());
+}
+
+
+template <typename PointSource, typename PointTarget>
+double NormalDistributionsTransformParallel<PointSource, PointTarget>::computeDerivativesParallel(Eigen::Matrix<double, 6, 1> &score_gradient, Eigen::Matrix<double, 6, 6> &hessian,
+		const PointCloudSource &trans_cloud, const Eigen::Matrix<double, 6, 1> &transform, bool compute_hessian) {
+	TransformDerivatives transform_derivatives;
+	computeTransformDerivatives(transform, transform_derivatives);
+
+	const PointCloudSource& input_cloud = *input_;
+	const double gauss_d1 = gauss_d1_;
+	const double gauss_d2 = gauss_d2_;
+	const double search_radius = resolution_;
+
+	DerivativesAccumulator derivatives = parallel_utils::computeDeterministicBlockReduction(input_cloud.size(), DerivativesAccumulator(DerivativesAccumulator::Zero()),
+			[&](size_t block_start, size_t block_end, DerivativesAccumulator& block_derivatives) {
+				std::vector<TargetGridLeafConstPtr> neighborhood;
+				std::vector<float> distances;
+				Eigen::Matrix<double, 3, 6> point_jacobian;
+				point_jacobian.template block<3, 3>(0, 0).setIdentity();
+				Eigen::Vector3d point_hessian[3][3];
+
+				for (size_t i = block_start; i < block_end; ++i) {
+					const PointSource& transformed_point = trans_cloud[i];
+					neighborhood.clear();
+					distances.clear();
+					target_cells_.radiusSearch(transformed_point, search_radius, neighborhood, distances);
+					if (neighborhood.empty()) { continue; }
+
+					Eigen::Vector3d x = input_cloud[i].getVector3fMap().template cast<double>();
+					for (int angle = 0; angle < 3; ++angle) {
+						point_jacobian.col(3 + angle).noalias() = transform_derivatives.rotation_jacobians[angle] * x;
+					}
+
+					if (compute_hessian) {
+						for (int angle_i = 0; angle_i < 3; ++angle_i) {
+							for (int angle_j = angle_i; angle_j < 3; ++angle_j) {
+								point_hessian[angle_i][angle_j].noalias() = transform_derivatives.rotation_hessians[angle_i][angle_j] * x;
+							}
+						}
+					}
+
+					for (size_t n = 0; n < neighborhood.size(); ++n) {
+						const TargetGridLeafConstPtr& cell = neighborhood[n];
+						Eigen::Vector3d x_trans = transformed_point.getVector3fMap().template cast<double>() - cell->getMean();
+						const Eigen::Matrix3d& c_inv = cell->getInverseCov();
+						Eigen::Vector3d c_inv_x_trans = c_inv * x_trans;
+
+						// Equations 6.9, 6.12 and 6.13 [Magnusson 2009]
+						double e_x_cov_x = std::exp(-gauss_d2 * x_trans.dot(c_inv_x_trans) * 0.5);
+						double score_increment = -gauss_d1 * e_x_cov_x;
+						e_x_cov_x *= gauss_d2;
+						if (e_x_cov_x > 1 || e_x_cov_x < 0 || std::isnan(e_x_cov_x)) { continue; }
+						e_x_cov_x *= gauss_d1;
+
+						Eigen::Matrix<double, 3, 6> c_inv_jacobian = c_inv * point_jacobian;
+						Eigen::Matrix<double, 6, 1> x_trans_c_inv_jacobian = c_inv_jacobian.transpose() * x_trans;
+
+						block_derivatives(0, 7) += score_increment;
+						block_derivatives.template block<6, 1>(0, 6).noalias() += e_x_cov_x * x_trans_c_inv_jacobian;
+
+						if (compute_hessian) {
+							Eigen::Matrix<double, 6, 6> hessian_increment = point_jacobian.transpose() * c_inv_jacobian;
+							hessian_increment.noalias() -= gauss_d2 * x_trans_c_inv_jacobian * x_trans_c_inv_jacobian.transpose();
+							for (int angle_i = 0; angle_i < 3; ++angle_i) {
+								for (int angle_j = angle_i; angle_j < 3; ++angle_j) {
+									double second_order_term = c_inv_x_trans.dot(point_hessian[angle_i][angle_j]);
+									hessian_increment(3 + angle_i, 3 + angle_j) += second_order_term;
+									if (angle_i != angle_j) { hessian_increment(3 + angle_j, 3 + angle_i) += second_order_term; }
+								}
+							}
+							block_derivatives.template block<6, 6>(0, 0).noalias() += e_x_cov_x * hessian_increment;
+						}
+					}
+				}
+			}, number_of_threads_, block_size_);
+
+	score_gradient = derivatives.template block<6, 1>(0, 6);
+	if (compute_hessian) {
+		hessian = derivatives.template block<6, 6>(0, 0);
+	}
+	return derivatives(0, 7);
+}
+
+
+template <typename PointSource, typename PointTarget>
+double NormalDistributionsTransformParallel<PointSource, PointTarget>::computeStepLengthMTParallel(const Eigen::Matrix<double, 6, 1> &transform, Eigen::Matrix<double, 6, 1> &step_dir,
+		double step_init, double step_max, double step_min, double &score, Eigen::Matrix<double, 6, 1> &score_gradient, Eigen::Matrix<double, 6, 6> &hessian, PointCloudSource &trans_cloud) {
+	// phi(0) and phi'(0), equation 1.3 [More, Thuente 1994]
+	double phi_0 = -score;
+	double d_phi_0 = -(score_gradient.dot(step_dir));
+
+	if (d_phi_0 >= 0) {
+		if (d_phi_0 == 0) { return 0; }
+		d_phi_0 *= -1;
+		step_dir *= -1;
+	}
+
+	const int max_step_iterations = 10;
+	int step_iterations = 0;
+	const double mu = 1.e-4; // sufficient decrease constant, equation 1.1
+	const double nu = 0.9; // curvature condition constant, equation 1.2
+
+	double a_l = 0, a_u = 0;
+	double f_l = auxilaryFunction_PsiMT(a_l, phi_0, phi_0, d_phi_0, mu);
+	double g_l = auxilaryFunction_dPsiMT(d_phi_0, d_phi_0, mu);
+	double f_u = auxilaryFunction_PsiMT(a_u, phi_0, phi_0, d_phi_0, mu);
+	double g_u = auxilaryFunction_dPsiMT(d_phi_0, d_phi_0, mu);
+
+	bool interval_converged = (step_max - step_min) < 0, open_interval = true;
+
+	double a_t = step_init;
+	a_t = std::min(a_t, step_max);
+	a_t = std::max(a_t, step_min);
+
+	Eigen::Matrix<double, 6, 1> x_t = transform + step_dir * a_t;
+	convertTransform(x_t, final_transformation_);
+	pcl::transformPointCloud(*input_, trans_cloud, final_transformation_);
+
+	// the hessian is computed together with the first trial because most line searches accept the initial step
+	score = computeDerivativesParallel(score_gradient, hessian, trans_cloud, x_t, true);
+
+	double phi_t = -score;
+	double d_phi_t = -(score_gradient.dot(step_dir));
+	double psi_t = auxilaryFunction_PsiMT(a_t, phi_t, phi_0, d_phi_0, mu);
+	double d_psi_t = auxilaryFunction_dPsiMT(d_phi_t, d_phi_0, mu);
+
+	while (!interval_converged && step_iterations < max_step_iterations && !(psi_t <= 0 && d_phi_t <= -nu * d_phi_0)) {
+		if (open_interval) {
+			a_t = trialValueSelectionMT(a_l, f_l, g_l, a_u, f_u, g_u, a_t, psi_t, d_psi_t);
+		} else {
+			a_t = trialValueSelectionMT(a_l, f_l, g_l, a_u, f_u, g_u, a_t, phi_t, d_phi_t);
+		}
+
+		a_t = std::min(a_t, step_max);
+		a_t = std::max(a_t, step_min);
+
+		x_t = transform + step_dir * a_t;
+		convertTransform(x_t, final_transformation_);
+		pcl::transformPointCloud(*input_, trans_cloud, final_transformation_);
+
+		score = computeDerivativesParallel(score_gradient, hessian, trans_cloud, x_t, false);
+
+		phi_t = -score;
+		d_phi_t = -(score_gradient.dot(step_dir));
+		psi_t = auxilaryFunction_PsiMT(a_t, phi_t, phi_0, d_phi_0, mu);
+		d_psi_t = auxilaryFunction_dPsiMT(d_phi_t, d_phi_0, mu);
+
+		if (open_interval && (psi_t <= 0 && d_psi_t >= 0)) {
+			open_interval = false;
+			f_l += phi_0 - mu * d_phi_0 * a_l;
+			g_l += mu * d_phi_0;
+			f_u += phi_0 - mu * d_phi_0 * a_u;
+			g_u += mu * d_phi_0;
+		}
+
+		if (open_interval) {
+			interval_converged = updateIntervalMT(a_l, f_l, g_l, a_u, f_u, g_u, a_t, psi_t, d_psi_t);
+		} else {
+			interval_converged = updateIntervalMT(a_l, f_l, g_l, a_u, f_u, g_u, a_t, phi_t, d_phi_t);
+		}
+
+		++step_iterations;
+	}
+
+	if (step_iterations) {
+		Eigen::Matrix<double, 6, 1> final_score_gradient;
+		computeDerivativesParallel(final_score_gradient, hessian, trans_cloud, x_t, true);
+	}
+
+	return a_t;
+}
+
+
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransformParallel<PointSource, PointTarget>::computeTransformDerivatives(const Eigen::Matrix<double, 6, 1> &transform, TransformDerivatives &transform_derivatives) {
+	// R = Rx * Ry * Rz (same convention as pcl::NormalDistributionsTransform::convertTransform) and dRa / da = Ga * Ra
+	Eigen::Matrix3d rx(Eigen::AngleAxisd(transform(3), Eigen::Vector3d::UnitX()));
+	Eigen::Matrix3d ry(Eigen::AngleAxisd(transform(4), Eigen::Vector3d::UnitY()));
+	Eigen::Matrix3d rz(Eigen::AngleAxisd(transform(5), Eigen::Vector3d::UnitZ()));
+	Eigen::Matrix3d gx, gy, gz;
+	gx << 0, 0, 0,   0, 0, -1,   0, 1, 0;
+	gy << 0, 0, 1,   0, 0, 0,   -1, 0, 0;
+	gz << 0, -1, 0,   1, 0, 0,   0, 0, 0;
+
+	Eigen::Matrix3d rotation = rx * ry * rz;
+	Eigen::Matrix3d rx_gy_ry_rz = rx * gy * ry * rz;
+	transform_derivatives.rotation_jacobians[0] = gx * rotation;
+	transform_derivatives.rotation_jacobians[1] = rx_gy_ry_rz;
+	transform_derivatives.rotation_jacobians[2] = rotation * gz;
+
+	transform_derivatives.rotation_hessians[0][0] = gx * gx * rotation;
+	transform_derivatives.rotation_hessians[0][1] = gx * rx_gy_ry_rz;
+	transform_derivatives.rotation_hessians[0][2] = gx * rotation * gz;
+	transform_derivatives.rotation_hessians[1][1] = rx * gy * gy * ry * rz;
+	transform_derivatives.rotation_hessians[1][2] = rx_gy_ry_rz * gz;
+	transform_derivatives.rotation_hessians[2][2] = rotation * gz * gz;
+	transform_derivatives.rotation_hessians[1][0] = transform_derivatives.rotation_hessians[0][1];
+	transform_derivatives.rotation_hessians[2][0] = transform_derivatives.rotation_hessians[0][2];
+	transform_derivatives.rotation_hessians[2][1] = transform_derivatives.rotation_hessians[1][2];
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalDistributionsTransformParallel-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalDistributionsTransform3D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
 void NormalDistributionsTransform3D<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
-	typename pcl::Registration<PointT, PointT, float>::Ptr matcher_base(new NormalDistributionsTransformDetailed<PointT, PointT>());
+	int number_of_threads;
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads, 0);
+	private_node_handle->param(configuration_namespace + "reuse_target_grid_when_reference_cloud_is_unchanged", reuse_target_grid_when_reference_cloud_is_unchanged_, true);
+
+	typename pcl::Registration<PointT, PointT, float>::Ptr matcher_base;
+	if (number_of_threads == 1) {
+		matcher_base = typename pcl::Registration<PointT, PointT, float>::Ptr(new NormalDistributionsTransformDetailed<PointT, PointT>());
+	} else {
+		typename NormalDistributionsTransformParallel<PointT, PointT>::Ptr matcher_parallel(new NormalDistributionsTransformParallel<PointT, PointT>());
+		matcher_parallel->setNumberOfThreads(number_of_threads);
+		matcher_base = matcher_parallel;
+	}
+
 	typename pcl::NormalDistributionsTransform<PointT, PointT>::Ptr matcher = std::static_pointer_cast< typename pcl::NormalDistributionsTransform<PointT, PointT> >(matcher_base);
 
 	double transformation_rotation_epsilon;
@@ -44,6 +327,26 @@ void NormalDistributionsTransform3D<PointT>::setupConfigurationFromParameterServ
 	CloudMatcher<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
 }
 
+template<typename PointT>
+void NormalDistributionsTransform3D<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	// setInputTarget rebuilds the voxel grid with the target distributions
+	if (reuse_target_grid_when_reference_cloud_is_unchanged_ && CloudMatcher<PointT>::cloud_matcher_ && reference_cloud && CloudMatcher<PointT>::cloud_matcher_->getInputTarget() == reference_cloud &&
+			reference_cloud->size() == reference_cloud_number_of_points_ && reference_cloud->header.stamp == reference_cloud_stamp_) {
+		ROS_DEBUG_STREAM("Reusing the NDT target grid of the unchanged reference point cloud with " << reference_cloud->size() << " points");
+		CloudMatcher<PointT>::reference_cloud_keypoints_ = reference_cloud_keypoints;
+		CloudMatcher<PointT>::search_method_ = search_method;
+		return;
+	}
+
+	if (reference_cloud) {
+		reference_cloud_number_of_points_ = reference_cloud->size();
+		reference_cloud_stamp_ = reference_cloud->header.stamp;
+	}
+	CloudMatcher<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+}
+
+
 template<typename PointT>
 int NormalDistributionsTransform3D<PointT>::getNumberOfRegistrationIterations() {
 	if (CloudMatcher<PointT>::cloud_matcher_) {
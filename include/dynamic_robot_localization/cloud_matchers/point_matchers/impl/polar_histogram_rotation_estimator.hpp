@@ -0,0 +1,232 @@
+/**\file polar_histogram_rotation_estimator.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/polar_histogram_rotation_estimator.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PolarHistogramRotationEstimator-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void PolarHistogramRotationEstimator<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	CloudMatcher<PointT>::setupTFConfigurationsFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+	CloudMatcher<PointT>::setupReferencePointCloudPublisher(node_handle, private_node_handle, configuration_namespace);
+	CloudMatcher<PointT>::setupAlignedPointCloudPublisher(node_handle, private_node_handle, configuration_namespace);
+
+	int number_of_angular_bins;
+	private_node_handle->param(configuration_namespace + "number_of_angular_bins", number_of_angular_bins, 360);
+	angular_distribution_analyzer_.setNumberOfAngularBins(std::max(number_of_angular_bins, 4));
+	private_node_handle->param(configuration_namespace + "axial_normals_histogram", axial_normals_histogram_, true);
+	private_node_handle->param(configuration_namespace + "reference_search_radius", reference_search_radius_, 10.0);
+	private_node_handle->param(configuration_namespace + "number_of_rotation_candidates", number_of_rotation_candidates_, 2);
+	private_node_handle->param(configuration_namespace + "candidate_verification_inlier_distance", candidate_verification_inlier_distance_, 0.3);
+	private_node_handle->param(configuration_namespace + "candidate_verification_maximum_number_of_points", candidate_verification_maximum_number_of_points_, 500);
+	private_node_handle->param(configuration_namespace + "candidate_verification_minimum_inlier_fraction", candidate_verification_minimum_inlier_fraction_, 0.0);
+	number_of_rotation_candidates_ = std::max(number_of_rotation_candidates_, 1);
+}
+
+
+template<typename PointT>
+void PolarHistogramRotationEstimator<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	CloudMatcher<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+
+	reference_histogram_.clear();
+	if (reference_search_radius_ <= 0.0 && reference_cloud) {
+		if (!angular_distribution_analyzer_.computeNormalsOrientationHistogram(*reference_cloud, nullptr, axial_normals_histogram_, reference_histogram_)) {
+			reference_histogram_.clear();
+			ROS_WARN("The reference point cloud does not have valid normals for the polar histogram rotation estimator");
+		}
+	}
+}
+
+
+template<typename PointT>
+void PolarHistogramRotationEstimator<PointT>::setPosePrior(const tf2::Transform& pose_prior) {
+	pose_prior_position_ = Eigen::Vector3f((float)pose_prior.getOrigin().getX(), (float)pose_prior.getOrigin().getY(), (float)pose_prior.getOrigin().getZ());
+	pose_prior_available_ = true;
+}
+
+
+template<typename PointT>
+bool PolarHistogramRotationEstimator<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+		typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+		tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints) {
+	CloudMatcher<PointT>::cloud_align_time_ms_ = 0;
+	if (!CloudMatcher<PointT>::reference_cloud_ || !CloudMatcher<PointT>::search_method_) {
+		ROS_WARN("Discarded ambient cloud because the polar histogram rotation estimator does not have a reference point cloud");
+		return false;
+	}
+
+	if (ambient_pointcloud->empty()) { return false; }
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+
+	// the ambient point cloud is in the map frame, and as such, the rotation is applied around the sensor position given by the pose prior
+	Eigen::Vector3f rotation_center;
+	if (pose_prior_available_) {
+		rotation_center = pose_prior_position_;
+	} else {
+		Eigen::Vector4f centroid;
+		pcl::compute3DCentroid(*ambient_pointcloud, centroid);
+		rotation_center = centroid.head<3>();
+	}
+
+	std::vector<double> ambient_histogram, reference_histogram, correlation;
+	if (!angular_distribution_analyzer_.computeNormalsOrientationHistogram(*ambient_pointcloud, nullptr, axial_normals_histogram_, ambient_histogram)) {
+		ROS_WARN("Polar histogram rotation estimator discarded ambient cloud without valid normals");
+		return false;
+	}
+
+	if (!computeReferenceHistogram(rotation_center, reference_histogram) ||
+			!AngularDistributionAnalyzer<PointT>::s_computeCircularCrossCorrelation(reference_histogram, ambient_histogram, correlation)) {
+		ROS_DEBUG("Polar histogram rotation estimator did not find reference points with valid normals around the rotation center");
+		return false;
+	}
+
+	std::vector<RotationCandidate> rotation_candidates;
+	extractRotationCandidates(correlation, rotation_candidates);
+
+	std::vector< Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f> > candidate_transformations;
+	std::vector<RotationCandidate> verified_candidates;
+	for (size_t i = 0; i < rotation_candidates.size(); ++i) {
+		RotationCandidate candidate = rotation_candidates[i];
+		if (candidate_verification_inlier_distance_ > 0.0) {
+			Eigen::Matrix4f transformation = Eigen::Matrix4f::Identity();
+			Eigen::Matrix3f rotation(Eigen::AngleAxisf(candidate.yaw, Eigen::Vector3f::UnitZ()));
+			transformation.block<3, 3>(0, 0) = rotation;
+			transformation.block<3, 1>(0, 3) = rotation_center - rotation * rotation_center;
+			candidate.score = CloudMatcher<PointT>::computeInlierFraction(*ambient_pointcloud, transformation, candidate_verification_inlier_distance_, candidate_verification_maximum_number_of_points_);
+			if (candidate.score < candidate_verification_minimum_inlier_fraction_) { continue; }
+		}
+		verified_candidates.push_back(candidate);
+	}
+
+	std::stable_sort(verified_candidates.begin(), verified_candidates.end(), std::greater<RotationCandidate>());
+	CloudMatcher<PointT>::cloud_align_time_ms_ = performance_timer.getElapsedTimeInMilliSec();
+	if (verified_candidates.empty()) {
+		ROS_DEBUG_STREAM("Polar histogram rotation estimator rejected all the " << rotation_candidates.size() << " rotation candidates");
+		return false;
+	}
+
+	for (size_t i = 0; i < verified_candidates.size(); ++i) {
+		Eigen::Matrix4f transformation = Eigen::Matrix4f::Identity();
+		Eigen::Matrix3f rotation(Eigen::AngleAxisf(verified_candidates[i].yaw, Eigen::Vector3f::UnitZ()));
+		transformation.block<3, 3>(0, 0) = rotation;
+		transformation.block<3, 1>(0, 3) = rotation_center - rotation * rotation_center;
+		candidate_transformations.push_back(transformation);
+
+		tf2::Transform pose_correction;
+		laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformMatrixToTF2(transformation, pose_correction);
+		accepted_pose_corrections_out.push_back(pose_correction);
+	}
+
+	ROS_DEBUG_STREAM("Polar histogram rotation estimator found a yaw correction of " << verified_candidates.front().yaw << " rad with score " << verified_candidates.front().score
+			<< " in " << CloudMatcher<PointT>::cloud_align_time_ms_ << " ms");
+
+	const Eigen::Matrix4f& final_transformation = candidate_transformations.front();
+	pcl::transformPointCloudWithNormals(*ambient_pointcloud, *pointcloud_registered_out, final_transformation);
+
+	if (CloudMatcher<PointT>::postProcessRegistrationMatrix(ambient_pointcloud, final_transformation, best_pose_correction_out)) {
+		pointcloud_registered_out->header = ambient_pointcloud->header;
+
+		if (pointcloud_keypoints && !pointcloud_keypoints->empty()) {
+			pcl::transformPointCloudWithNormals(*pointcloud_keypoints, *pointcloud_keypoints, final_transformation);
+		}
+
+		if (CloudMatcher<PointT>::cloud_publisher_ && pointcloud_registered_out) {
+			CloudMatcher<PointT>::cloud_publisher_->publishPointCloud(*pointcloud_registered_out);
+		}
+
+		if (CloudMatcher<PointT>::reference_cloud_publisher_ && CloudMatcher<PointT>::reference_cloud_) {
+			CloudMatcher<PointT>::reference_cloud_publisher_->setCloudPublishStamp(ambient_pointcloud->header.stamp);
+			CloudMatcher<PointT>::reference_cloud_publisher_->publishPointCloud(*CloudMatcher<PointT>::reference_cloud_);
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+
+template<typename PointT>
+bool PolarHistogramRotationEstimator<PointT>::computeReferenceHistogram(const Eigen::Vector3f& rotation_center, std::vector<double>& histogram_out) const {
+	if (reference_search_radius_ <= 0.0) {
+		histogram_out = reference_histogram_;
+		return !histogram_out.empty();
+	}
+
+	PointT center_point;
+	center_point.getVector3fMap() = rotation_center;
+	std::vector<int> indices;
+	std::vector<float> squared_distances;
+	if (CloudMatcher<PointT>::search_method_->radiusSearch(center_point, reference_search_radius_, indices, squared_distances) <= 0) { return false; }
+	return angular_distribution_analyzer_.computeNormalsOrientationHistogram(*CloudMatcher<PointT>::reference_cloud_, &indices, axial_normals_histogram_, histogram_out);
+}
+
+
+template<typename PointT>
+void PolarHistogramRotationEstimator<PointT>::extractRotationCandidates(const std::vector<double>& correlation, std::vector<RotationCandidate>& candidates_out) const {
+	candidates_out.clear();
+	int number_of_bins = (int)correlation.size();
+	if (number_of_bins < 3) { return; }
+
+	std::vector< std::pair<double, int> > peaks;
+	for (int i = 0; i < number_of_bins; ++i) {
+		double previous = correlation[(i + number_of_bins - 1) % number_of_bins];
+		double next = correlation[(i + 1) % number_of_bins];
+		if (correlation[i] > previous && correlation[i] >= next) {
+			peaks.push_back(std::make_pair(correlation[i], i));
+		}
+	}
+
+	if (peaks.empty()) { // flat correlation (for example, with perfectly symmetric histograms)
+		peaks.push_back(std::make_pair(correlation[0], 0));
+	}
+
+	std::sort(peaks.begin(), peaks.end(), std::greater< std::pair<double, int> >());
+	if (peaks.size() > (size_t)number_of_rotation_candidates_) { peaks.resize(number_of_rotation_candidates_); }
+
+	double bin_angle = (axial_normals_histogram_ ? M_PI : 2.0 * M_PI) / (double)number_of_bins;
+	double maximum_correlation = std::max(peaks.front().first, 1e-12);
+	for (size_t i = 0; i < peaks.size(); ++i) {
+		int bin = peaks[i].second;
+		double previous = correlation[(bin + number_of_bins - 1) % number_of_bins];
+		double next = correlation[(bin + 1) % number_of_bins];
+		double denominator = previous - 2.0 * peaks[i].first + next;
+		double sub_bin_offset = (std::abs(denominator) > 1e-12) ? std::max(-0.5, std::min(0.5, 0.5 * (previous - next) / denominator)) : 0.0;
+
+		double yaw = ((double)bin + sub_bin_offset) * bin_angle;
+		RotationCandidate candidate;
+		candidate.yaw = (float)std::atan2(std::sin(yaw), std::cos(yaw));
+		candidate.score = (float)(peaks[i].first / maximum_correlation);
+		candidates_out.push_back(candidate);
+
+		if (axial_normals_histogram_) { // normals without consistent flipping only give the yaw modulo pi
+			candidate.yaw = (float)std::atan2(-std::sin(yaw), -std::cos(yaw));
+			candidates_out.push_back(candidate);
+		}
+	}
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PolarHistogramRotationEstimator-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
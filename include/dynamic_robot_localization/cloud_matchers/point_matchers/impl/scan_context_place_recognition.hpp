@@ -0,0 +1,502 @@
+/**\file scan_context_place_recognition.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/scan_context_place_recognition.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <ScanContextPlaceRecognition-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void ScanContextPlaceRecognition<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	CloudMatcher<PointT>::setupTFConfigurationsFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+	CloudMatcher<PointT>::setupReferencePointCloudPublisher(node_handle, private_node_handle, configuration_namespace);
+	CloudMatcher<PointT>::setupAlignedPointCloudPublisher(node_handle, private_node_handle, configuration_namespace);
+
+	private_node_handle->param(configuration_namespace + "number_of_rings", number_of_rings_, 20);
+	private_node_handle->param(configuration_namespace + "number_of_sectors", number_of_sectors_, 60);
+	private_node_handle->param(configuration_namespace + "maximum_radius", maximum_radius_, 20.0);
+	number_of_rings_ = std::max(number_of_rings_, 1);
+	number_of_sectors_ = std::max(number_of_sectors_, 1);
+
+	std::string cell_value_type;
+	private_node_handle->param(configuration_namespace + "cell_value_type", cell_value_type, std::string("maximum_height"));
+	if (cell_value_type == "occupancy") {
+		cell_value_type_ = Occupancy;
+	} else {
+		if (cell_value_type != "maximum_height") { ROS_WARN_STREAM("Unknown scan context cell_value_type [" << cell_value_type << "] -> using maximum_height"); }
+		cell_value_type_ = MaximumHeight;
+	}
+
+	private_node_handle->param(configuration_namespace + "cells_height_offset", cells_height_offset_, 0.0);
+	private_node_handle->param(configuration_namespace + "simulate_occlusions", simulate_occlusions_, false);
+	private_node_handle->param(configuration_namespace + "database_filename", database_filename_, std::string(""));
+	private_node_handle->param(configuration_namespace + "database_save_filename", database_save_filename_, std::string(""));
+	private_node_handle->param(configuration_namespace + "database_grid_resolution", database_grid_resolution_, 1.0);
+	private_node_handle->param(configuration_namespace + "database_sensor_height", database_sensor_height_, 0.0);
+	private_node_handle->param(configuration_namespace + "database_minimum_distance_to_reference_points", database_minimum_distance_to_reference_points_, 0.3);
+	private_node_handle->param(configuration_namespace + "database_minimum_number_of_reference_points", database_minimum_number_of_reference_points_, 50);
+	private_node_handle->param(configuration_namespace + "number_of_ring_key_candidates", number_of_ring_key_candidates_, 50);
+	private_node_handle->param(configuration_namespace + "number_of_pose_candidates", number_of_pose_candidates_, 5);
+	private_node_handle->param(configuration_namespace + "maximum_scan_context_distance", maximum_scan_context_distance_, 1.0);
+	private_node_handle->param(configuration_namespace + "candidate_verification_inlier_distance", candidate_verification_inlier_distance_, 0.3);
+	private_node_handle->param(configuration_namespace + "candidate_verification_maximum_number_of_points", candidate_verification_maximum_number_of_points_, 500);
+	private_node_handle->param(configuration_namespace + "candidate_verification_minimum_inlier_fraction", candidate_verification_minimum_inlier_fraction_, 0.0);
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
+}
+
+
+template<typename PointT>
+void ScanContextPlaceRecognition<PointT>::setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+		typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	CloudMatcher<PointT>::setupReferenceCloud(reference_cloud, reference_cloud_keypoints, search_method);
+
+	if (!database_filename_.empty()) {
+		if (loadDatabase(database_filename_)) {
+			ROS_INFO_STREAM("Loaded scan context database with " << getDatabaseSize() << " places from file " << database_filename_);
+			return;
+		}
+		ROS_WARN_STREAM("Failed to load the scan context database from file " << database_filename_ << " -> building a new database");
+	}
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+	if (!buildDatabase()) {
+		ROS_WARN("Failed to build the scan context database");
+		return;
+	}
+	ROS_INFO_STREAM("Built scan context database with " << getDatabaseSize() << " places in " << performance_timer.getElapsedTimeFormated());
+
+	if (!database_save_filename_.empty()) {
+		if (saveDatabase(database_save_filename_)) {
+			ROS_INFO_STREAM("Saved scan context database to file " << database_save_filename_);
+		} else {
+			ROS_WARN_STREAM("Failed to save the scan context database to file " << database_save_filename_);
+		}
+	}
+}
+
+
+template<typename PointT>
+void ScanContextPlaceRecognition<PointT>::setPosePrior(const tf2::Transform& pose_prior) {
+	pose_prior_position_ = Eigen::Vector3f((float)pose_prior.getOrigin().getX(), (float)pose_prior.getOrigin().getY(), (float)pose_prior.getOrigin().getZ());
+	tf2Scalar roll, pitch, yaw;
+	pose_prior.getBasis().getRPY(roll, pitch, yaw);
+	pose_prior_yaw_ = (float)yaw;
+	pose_prior_available_ = true;
+}
+
+
+template<typename PointT>
+bool ScanContextPlaceRecognition<PointT>::registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
+		typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
+		tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out, typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints) {
+	CloudMatcher<PointT>::cloud_align_time_ms_ = 0;
+	if (!pose_prior_available_) {
+		ROS_WARN("Scan context place recognition requires a pose prior for describing the ambient point cloud");
+		return false;
+	}
+
+	if (database_scan_contexts_.empty()) {
+		ROS_WARN("Discarded ambient cloud because the scan context database is empty");
+		return false;
+	}
+
+	if (ambient_pointcloud->size() < 3) {
+		ROS_WARN_STREAM("Discarded ambient cloud with " << ambient_pointcloud->size() << " points because the scan context place recognition requires at least 3 points");
+		return false;
+	}
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+
+	size_t scan_context_size = getScanContextSize();
+	std::vector<float> query_scan_context;
+	computeScanContext(*ambient_pointcloud, nullptr, pose_prior_position_(0), pose_prior_position_(1), pose_prior_yaw_, query_scan_context);
+	std::vector<float> query_ring_key(number_of_rings_);
+	computeRingKey(query_scan_context.data(), query_ring_key.data());
+
+	// preselection of the database places with the rotation invariant ring keys
+	int database_size = (int)getDatabaseSize();
+	std::vector< std::pair<float, int> > ring_key_distances(database_size);
+	#pragma omp parallel for schedule(static) num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	for (int i = 0; i < database_size; ++i) {
+		const float* ring_key = &database_ring_keys_[(size_t)i * number_of_rings_];
+		float squared_distance = 0.0f;
+		for (int ring = 0; ring < number_of_rings_; ++ring) {
+			float difference = query_ring_key[ring] - ring_key[ring];
+			squared_distance += difference * difference;
+		}
+		ring_key_distances[i] = std::make_pair(squared_distance, i);
+	}
+
+	int number_of_ring_key_candidates = std::min(database_size, std::max(number_of_ring_key_candidates_, 1));
+	std::partial_sort(ring_key_distances.begin(), ring_key_distances.begin() + number_of_ring_key_candidates, ring_key_distances.end());
+
+	// full scan context comparison over all the sector shifts
+	std::vector< std::pair<float, int> > scan_context_distances(number_of_ring_key_candidates);
+	std::vector<int> sector_shifts(number_of_ring_key_candidates, 0);
+	#pragma omp parallel for schedule(dynamic, 4) num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	for (int i = 0; i < number_of_ring_key_candidates; ++i) {
+		int database_index = ring_key_distances[i].second;
+		float distance = computeScanContextDistance(query_scan_context.data(), &database_scan_contexts_[(size_t)database_index * scan_context_size], sector_shifts[i]);
+		scan_context_distances[i] = std::make_pair(distance, i);
+	}
+	std::sort(scan_context_distances.begin(), scan_context_distances.end());
+
+	// pose candidates
+	float sector_angle = (float)(2.0 * M_PI) / (float)number_of_sectors_;
+	std::vector< std::pair<float, Eigen::Matrix4f> > pose_candidates; // (score, pose correction)
+	for (size_t i = 0; i < scan_context_distances.size() && (int)pose_candidates.size() < std::max(number_of_pose_candidates_, 1); ++i) {
+		if (scan_context_distances[i].first > maximum_scan_context_distance_) { break; }
+		int candidate = scan_context_distances[i].second;
+		int database_index = ring_key_distances[candidate].second;
+		float yaw_correction = (float)sector_shifts[candidate] * sector_angle - pose_prior_yaw_;
+
+		Eigen::Matrix4f pose_correction = Eigen::Matrix4f::Identity();
+		Eigen::Matrix3f rotation_correction = Eigen::AngleAxisf(yaw_correction, Eigen::Vector3f::UnitZ()).toRotationMatrix();
+		Eigen::Vector3f candidate_position(database_positions_[(size_t)database_index * 2], database_positions_[(size_t)database_index * 2 + 1], pose_prior_position_(2));
+		pose_correction.block<3, 3>(0, 0) = rotation_correction;
+		pose_correction.block<3, 1>(0, 3) = candidate_position - rotation_correction * pose_prior_position_;
+
+		float score = -scan_context_distances[i].first;
+		if (candidate_verification_inlier_distance_ > 0.0) {
+			float inlier_fraction = CloudMatcher<PointT>::computeInlierFraction(*ambient_pointcloud, pose_correction, candidate_verification_inlier_distance_, candidate_verification_maximum_number_of_points_);
+			if (inlier_fraction < candidate_verification_minimum_inlier_fraction_) { continue; }
+			score = inlier_fraction;
+		}
+		pose_candidates.push_back(std::make_pair(score, pose_correction));
+	}
+
+	if (pose_candidates.empty()) {
+		ROS_DEBUG_STREAM("Scan context place recognition did not find valid places among " << database_size << " database places");
+		return false;
+	}
+
+	std::stable_sort(pose_candidates.begin(), pose_candidates.end(),
+			[](const std::pair<float, Eigen::Matrix4f>& a, const std::pair<float, Eigen::Matrix4f>& b) { return a.first > b.first; });
+
+	for (size_t i = 0; i < pose_candidates.size(); ++i) {
+		tf2::Transform transform;
+		laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformMatrixToTF2(pose_candidates[i].second, transform);
+		accepted_pose_corrections_out.push_back(transform);
+	}
+
+	Eigen::Matrix4f final_transformation = pose_candidates.front().second;
+	pcl::transformPointCloudWithNormals(*ambient_pointcloud, *pointcloud_registered_out, final_transformation);
+	CloudMatcher<PointT>::cloud_align_time_ms_ = performance_timer.getElapsedTimeInMilliSec();
+	ROS_DEBUG_STREAM("Scan context place recognition found " << pose_candidates.size() << " candidate poses in " << CloudMatcher<PointT>::cloud_align_time_ms_ << " ms");
+
+	if (CloudMatcher<PointT>::postProcessRegistrationMatrix(ambient_pointcloud, final_transformation, best_pose_correction_out)) {
+		pointcloud_registered_out->header = ambient_pointcloud->header;
+
+		if (pointcloud_keypoints && !pointcloud_keypoints->empty()) {
+			pcl::transformPointCloudWithNormals(*pointcloud_keypoints, *pointcloud_keypoints, final_transformation);
+		}
+
+		if (CloudMatcher<PointT>::cloud_publisher_ && pointcloud_registered_out) {
+			CloudMatcher<PointT>::cloud_publisher_->publishPointCloud(*pointcloud_registered_out);
+		}
+
+		if (CloudMatcher<PointT>::reference_cloud_publisher_ && CloudMatcher<PointT>::reference_cloud_) {
+			CloudMatcher<PointT>::reference_cloud_publisher_->setCloudPublishStamp(ambient_pointcloud->header.stamp);
+			CloudMatcher<PointT>::reference_cloud_publisher_->publishPointCloud(*CloudMatcher<PointT>::reference_cloud_);
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+
+template<typename PointT>
+void ScanContextPlaceRecognition<PointT>::computeScanContext(const pcl::PointCloud<PointT>& pointcloud, const std::vector<int>* indices, float center_x, float center_y, float yaw,
+		std::vector<float>& scan_context_out) const {
+	scan_context_out.assign(getScanContextSize(), 0.0f);
+	float cos_yaw = std::cos(yaw);
+	float sin_yaw = std::sin(yaw);
+	float maximum_radius = (float)maximum_radius_;
+	float two_pi = (float)(2.0 * M_PI);
+	size_t number_of_points = indices ? indices->size() : pointcloud.size();
+
+	for (size_t i = 0; i < number_of_points; ++i) {
+		const PointT& point = pointcloud[indices ? (size_t)(*indices)[i] : i];
+		float dx = point.x - center_x;
+		float dy = point.y - center_y;
+		float local_x = cos_yaw * dx + sin_yaw * dy;
+		float local_y = -sin_yaw * dx + cos_yaw * dy;
+		float radius = std::sqrt(local_x * local_x + local_y * local_y);
+		if (!std::isfinite(radius) || !std::isfinite(point.z) || radius >= maximum_radius) { continue; }
+
+		float angle = std::atan2(local_y, local_x);
+		if (angle < 0.0f) { angle += two_pi; }
+		int ring = std::min((int)(radius / maximum_radius * (float)number_of_rings_), number_of_rings_ - 1);
+		int sector = std::min((int)(angle / two_pi * (float)number_of_sectors_), number_of_sectors_ - 1);
+
+		float value = (cell_value_type_ == Occupancy) ? 1.0f : std::max(point.z - (float)cells_height_offset_, 1e-3f);
+		float& cell = scan_context_out[(size_t)ring * number_of_sectors_ + sector];
+		cell = std::max(cell, value);
+	}
+
+	if (simulate_occlusions_) {
+		// only the closest occupied ring of each sector is kept (as seen by a 2D range sensor)
+		for (int sector = 0; sector < number_of_sectors_; ++sector) {
+			bool found_occupied_ring = false;
+			for (int ring = 0; ring < number_of_rings_; ++ring) {
+				float& cell = scan_context_out[(size_t)ring * number_of_sectors_ + sector];
+				if (found_occupied_ring) { cell = 0.0f; }
+				else if (cell > 0.0f) { found_occupied_ring = true; }
+			}
+		}
+	}
+}
+
+
+template<typename PointT>
+void ScanContextPlaceRecognition<PointT>::computeRingKey(const float* scan_context, float* ring_key_out) const {
+	for (int ring = 0; ring < number_of_rings_; ++ring) {
+		const float* ring_cells = scan_context + (size_t)ring * number_of_sectors_;
+		float sum = 0.0f;
+		for (int sector = 0; sector < number_of_sectors_; ++sector) {
+			sum += ring_cells[sector];
+		}
+		ring_key_out[ring] = sum / (float)number_of_sectors_;
+	}
+}
+
+
+template<typename PointT>
+float ScanContextPlaceRecognition<PointT>::computeScanContextDistance(const float* query_scan_context, const float* database_scan_context, int& best_sector_shift_out) const {
+	std::vector<float> query_column_norms(number_of_sectors_, 0.0f);
+	std::vector<float> database_column_norms(number_of_sectors_, 0.0f);
+	for (int ring = 0; ring < number_of_rings_; ++ring) {
+		for (int sector = 0; sector < number_of_sectors_; ++sector) {
+			size_t cell = (size_t)ring * number_of_sectors_ + sector;
+			query_column_norms[sector] += query_scan_context[cell] * query_scan_context[cell];
+			database_column_norms[sector] += database_scan_context[cell] * database_scan_context[cell];
+		}
+	}
+	for (int sector = 0; sector < number_of_sectors_; ++sector) {
+		query_column_norms[sector] = std::sqrt(query_column_norms[sector]);
+		database_column_norms[sector] = std::sqrt(database_column_norms[sector]);
+	}
+
+	// the database column j is compared with the query column (j - shift), which corresponds to a sensor yaw of shift sectors in the map
+	float best_distance = 1.0f;
+	best_sector_shift_out = 0;
+	for (int shift = 0; shift < number_of_sectors_; ++shift) {
+		float sum_of_distances = 0.0f;
+		int number_of_compared_columns = 0;
+		for (int database_sector = 0; database_sector < number_of_sectors_; ++database_sector) {
+			int query_sector = (database_sector - shift + number_of_sectors_) % number_of_sectors_;
+			if (query_column_norms[query_sector] <= 0.0f || database_column_norms[database_sector] <= 0.0f) { continue; }
+
+			float dot_product = 0.0f;
+			for (int ring = 0; ring < number_of_rings_; ++ring) {
+				size_t ring_offset = (size_t)ring * number_of_sectors_;
+				dot_product += query_scan_context[ring_offset + query_sector] * database_scan_context[ring_offset + database_sector];
+			}
+			sum_of_distances += 1.0f - dot_product / (query_column_norms[query_sector] * database_column_norms[database_sector]);
+			++number_of_compared_columns;
+		}
+
+		if (number_of_compared_columns > 0) {
+			float distance = sum_of_distances / (float)number_of_compared_columns;
+			if (distance < best_distance) {
+				best_distance = distance;
+				best_sector_shift_out = shift;
+			}
+		}
+	}
+
+	return best_distance;
+}
+
+
+template<typename PointT>
+uint64_t ScanContextPlaceRecognition<PointT>::computeDatabaseHash() const {
+	uint64_t hash = 14695981039346656037ULL;
+	auto combine = [&hash](uint64_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+	auto combine_float = [&combine](float value) { uint32_t value_bits; std::memcpy(&value_bits, &value, sizeof(uint32_t)); combine((uint64_t)value_bits); };
+	combine_float((float)database_grid_resolution_);
+	combine_float((float)database_sensor_height_);
+	combine_float((float)database_minimum_distance_to_reference_points_);
+	combine((uint64_t)database_minimum_number_of_reference_points_);
+
+	const typename pcl::PointCloud<PointT>::Ptr& reference_cloud = CloudMatcher<PointT>::reference_cloud_;
+	if (!reference_cloud) { return hash; }
+	combine((uint64_t)reference_cloud->size());
+	for (size_t i = 0; i < reference_cloud->size(); ++i) {
+		combine_float((*reference_cloud)[i].x);
+		combine_float((*reference_cloud)[i].y);
+		combine_float((*reference_cloud)[i].z);
+	}
+	return hash;
+}
+
+
+template<typename PointT>
+bool ScanContextPlaceRecognition<PointT>::buildDatabase() {
+	database_positions_.clear();
+	database_scan_contexts_.clear();
+	database_ring_keys_.clear();
+	database_number_of_reference_points_ = 0;
+	database_hash_ = 0;
+
+	typename pcl::PointCloud<PointT>::Ptr& reference_cloud = CloudMatcher<PointT>::reference_cloud_;
+	typename pcl::search::KdTree<PointT>::Ptr& search_method = CloudMatcher<PointT>::search_method_;
+	if (!reference_cloud || reference_cloud->empty() || !search_method || database_grid_resolution_ <= 0.0) { return false; }
+
+	PointT minimum_point, maximum_point;
+	pcl::getMinMax3D(*reference_cloud, minimum_point, maximum_point);
+	size_t number_of_cells_x = (size_t)std::floor((maximum_point.x - minimum_point.x) / database_grid_resolution_) + 1;
+	size_t number_of_cells_y = (size_t)std::floor((maximum_point.y - minimum_point.y) / database_grid_resolution_) + 1;
+	size_t number_of_cells = number_of_cells_x * number_of_cells_y;
+
+	// the reference points around each place are searched in 2D
+	typename pcl::PointCloud<PointT>::Ptr reference_cloud_flattened(new pcl::PointCloud<PointT>(*reference_cloud));
+	for (size_t i = 0; i < reference_cloud_flattened->size(); ++i) {
+		(*reference_cloud_flattened)[i].z = 0.0f;
+	}
+	typename pcl::search::KdTree<PointT>::Ptr reference_cloud_flattened_search_method(new pcl::search::KdTree<PointT>());
+	reference_cloud_flattened_search_method->setInputCloud(reference_cloud_flattened);
+
+	std::vector< std::vector<float> > cells_scan_contexts(number_of_cells);
+	float minimum_squared_distance_to_reference_points = (float)(database_minimum_distance_to_reference_points_ * database_minimum_distance_to_reference_points_);
+
+	#pragma omp parallel num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	{
+		std::vector<int> indices;
+		std::vector<float> squared_distances;
+
+		#pragma omp for schedule(dynamic, 16)
+		for (long cell = 0; cell < (long)number_of_cells; ++cell) {
+			PointT place;
+			place.x = minimum_point.x + (float)((size_t)cell % number_of_cells_x) * (float)database_grid_resolution_;
+			place.y = minimum_point.y + (float)((size_t)cell / number_of_cells_x) * (float)database_grid_resolution_;
+			place.z = (float)database_sensor_height_;
+
+			// the sensor cannot be inside obstacles
+			if (minimum_squared_distance_to_reference_points > 0.0f && search_method->nearestKSearch(place, 1, indices, squared_distances) > 0 &&
+					squared_distances[0] < minimum_squared_distance_to_reference_points) { continue; }
+
+			place.z = 0.0f;
+			if (reference_cloud_flattened_search_method->radiusSearch(place, maximum_radius_, indices, squared_distances) < std::max(database_minimum_number_of_reference_points_, 1)) { continue; }
+
+			computeScanContext(*reference_cloud, &indices, place.x, place.y, 0.0f, cells_scan_contexts[cell]);
+		}
+	}
+
+	size_t scan_context_size = getScanContextSize();
+	for (size_t cell = 0; cell < number_of_cells; ++cell) {
+		if (cells_scan_contexts[cell].empty()) { continue; }
+		database_positions_.push_back(minimum_point.x + (float)(cell % number_of_cells_x) * (float)database_grid_resolution_);
+		database_positions_.push_back(minimum_point.y + (float)(cell / number_of_cells_x) * (float)database_grid_resolution_);
+		database_scan_contexts_.insert(database_scan_contexts_.end(), cells_scan_contexts[cell].begin(), cells_scan_contexts[cell].end());
+		std::vector<float>().swap(cells_scan_contexts[cell]);
+	}
+
+	database_ring_keys_.resize(getDatabaseSize() * number_of_rings_);
+	for (size_t i = 0; i < getDatabaseSize(); ++i) {
+		computeRingKey(&database_scan_contexts_[i * scan_context_size], &database_ring_keys_[i * number_of_rings_]);
+	}
+
+	database_number_of_reference_points_ = reference_cloud->size();
+	database_hash_ = computeDatabaseHash();
+	return !database_positions_.empty();
+}
+
+
+template<typename PointT>
+bool ScanContextPlaceRecognition<PointT>::loadDatabase(const std::string& filename) {
+	std::ifstream input_stream(filename.c_str(), std::ios::binary);
+	if (!input_stream.is_open() || !CloudMatcher<PointT>::reference_cloud_) { return false; }
+
+	char magic[8];
+	int32_t header[4];
+	float maximum_radius, cells_height_offset;
+	uint64_t number_of_reference_points, number_of_places, database_hash;
+	input_stream.read(magic, sizeof(magic));
+	input_stream.read(reinterpret_cast<char*>(header), sizeof(header));
+	input_stream.read(reinterpret_cast<char*>(&maximum_radius), sizeof(float));
+	input_stream.read(reinterpret_cast<char*>(&cells_height_offset), sizeof(float));
+	input_stream.read(reinterpret_cast<char*>(&number_of_reference_points), sizeof(uint64_t));
+	input_stream.read(reinterpret_cast<char*>(&number_of_places), sizeof(uint64_t));
+	input_stream.read(reinterpret_cast<char*>(&database_hash), sizeof(uint64_t));
+
+	// the database must have been built with the same descriptor configuration and reference point cloud
+	if (!input_stream.good() || std::string(magic, sizeof(magic)) != "DRLSCDB2" ||
+			header[0] != number_of_rings_ || header[1] != number_of_sectors_ || header[2] != (int32_t)cell_value_type_ || header[3] != (int32_t)simulate_occlusions_ ||
+			maximum_radius != (float)maximum_radius_ || cells_height_offset != (float)cells_height_offset_ ||
+			number_of_reference_points != (uint64_t)CloudMatcher<PointT>::reference_cloud_->size()) { return false; }
+
+	uint64_t expected_database_hash = computeDatabaseHash();
+	if (database_hash != expected_database_hash) {
+		ROS_WARN_STREAM("Scan context database in file " << filename << " was built for a different reference point cloud or database parameters (hash " << database_hash << " != " << expected_database_hash << ")");
+		return false;
+	}
+
+	database_positions_.resize((size_t)number_of_places * 2);
+	database_scan_contexts_.resize((size_t)number_of_places * getScanContextSize());
+	input_stream.read(reinterpret_cast<char*>(database_positions_.data()), sizeof(float) * database_positions_.size());
+	input_stream.read(reinterpret_cast<char*>(database_scan_contexts_.data()), sizeof(float) * database_scan_contexts_.size());
+	if (!input_stream.good()) {
+		database_positions_.clear();
+		database_scan_contexts_.clear();
+		return false;
+	}
+
+	database_ring_keys_.resize(getDatabaseSize() * number_of_rings_);
+	for (size_t i = 0; i < getDatabaseSize(); ++i) {
+		computeRingKey(&database_scan_contexts_[i * getScanContextSize()], &database_ring_keys_[i * number_of_rings_]);
+	}
+	database_number_of_reference_points_ = (size_t)number_of_reference_points;
+	database_hash_ = database_hash;
+	return !database_positions_.empty();
+}
+
+
+template<typename PointT>
+bool ScanContextPlaceRecognition<PointT>::saveDatabase(const std::string& filename) const {
+	if (database_positions_.empty()) { return false; }
+	std::ofstream output_stream(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if (!output_stream.is_open()) { return false; }
+
+	int32_t header[4] = { (int32_t)number_of_rings_, (int32_t)number_of_sectors_, (int32_t)cell_value_type_, (int32_t)simulate_occlusions_ };
+	float maximum_radius = (float)maximum_radius_;
+	float cells_height_offset = (float)cells_height_offset_;
+	uint64_t number_of_reference_points = (uint64_t)database_number_of_reference_points_;
+	uint64_t number_of_places = (uint64_t)getDatabaseSize();
+	uint64_t database_hash = database_hash_;
+	output_stream.write("DRLSCDB2", 8);
+	output_stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+	output_stream.write(reinterpret_cast<const char*>(&maximum_radius), sizeof(float));
+	output_stream.write(reinterpret_cast<const char*>(&cells_height_offset), sizeof(float));
+	output_stream.write(reinterpret_cast<const char*>(&number_of_reference_points), sizeof(uint64_t));
+	output_stream.write(reinterpret_cast<const char*>(&number_of_places), sizeof(uint64_t));
+	output_stream.write(reinterpret_cast<const char*>(&database_hash), sizeof(uint64_t));
+	output_stream.write(reinterpret_cast<const char*>(database_positions_.data()), sizeof(float) * database_positions_.size());
+	output_stream.write(reinterpret_cast<const char*>(database_scan_contexts_.data()), sizeof(float) * database_scan_contexts_.size());
+	return output_stream.good();
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </ScanContextPlaceRecognition-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+// =============================================================================   </protected-section>  =======================================================================
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+} /* namespace dynamic_robot_localization */
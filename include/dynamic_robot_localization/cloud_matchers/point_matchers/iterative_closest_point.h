@@ -13,6 +13,10 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
 
 // PCL includes
 #include <pcl/registration/icp.h>
@@ -21,6 +25,7 @@
 #include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
 #include <dynamic_robot_localization/common/performance_timer.h>
 #include <dynamic_robot_localization/convergence_estimators/default_convergence_criteria_with_time.h>
+#include <dynamic_robot_localization/RegistrationConvergenceTelemetry.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
@@ -94,6 +99,7 @@ class IterativeClosestPoint : public CloudMatcher<PointT> {
 		virtual std::string getMatcherConvergenceState();
 		virtual double getTransformCloudElapsedTimeMS();
 		virtual void resetTransformCloudElapsedTime();
+		void publishConvergenceTelemetry(const typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPoint-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -113,6 +119,7 @@ class IterativeClosestPoint : public CloudMatcher<PointT> {
 		size_t number_of_convergence_time_measurements;
 		double convergence_time_limit_seconds_as_mean_convergence_time_percentage_;
 		int minimum_number_of_convergence_time_measurements_to_adjust_convergence_time_limit_;
+		ros::Publisher convergence_telemetry_publisher_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
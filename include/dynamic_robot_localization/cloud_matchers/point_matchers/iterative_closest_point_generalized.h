@@ -9,28 +9,44 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 // PCL includes
 #include <pcl/registration/gicp.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/SVD>
 
 // project includes
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
 #include <dynamic_robot_localization/convergence_estimators/default_convergence_criteria_with_time.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
 
 // ##########################################################   iterative_closest_point_generalized_time_constrained   #########################################################
+/**
+ * \brief GICP with the point covariances computed by several threads.
+ * When no covariances were given, the source covariances are computed with the kd-tree given in setSearchMethodSource (if it was built for the source cloud), avoiding the serial computation of pcl::GeneralizedIterativeClosestPoint.
+ */
 template <typename PointSource, typename PointTarget>
 class IterativeClosestPointGeneralizedTimeConstrained: public pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget> {
 	public:
 		using Ptr = std::shared_ptr< IterativeClosestPointGeneralizedTimeConstrained<PointSource, PointTarget> >;
 		using ConstPtr = std::shared_ptr< const IterativeClosestPointGeneralizedTimeConstrained<PointSource, PointTarget> >;
+		using MatricesVector = typename pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::MatricesVector;
+		using MatricesVectorPtr = typename pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::MatricesVectorPtr;
 
-		IterativeClosestPointGeneralizedTimeConstrained(double convergence_time_limit_seconds = std::numeric_limits<double>::max()) {
+		IterativeClosestPointGeneralizedTimeConstrained(double convergence_time_limit_seconds = std::numeric_limits<double>::max()) :
+			number_of_threads_(0), transform_cloud_elapsed_time_ms_(0) {
 			pcl::IterativeClosestPoint<PointSource, PointTarget>::convergence_criteria_.reset(new DefaultConvergenceCriteriaWithTime<float> (
 					pcl::Registration<PointSource, PointTarget>::nr_iterations_,
 					pcl::Registration<PointSource, PointTarget>::transformation_,
@@ -40,10 +56,29 @@ class IterativeClosestPointGeneralizedTimeConstrained: public pcl::GeneralizedIt
 
 		virtual ~IterativeClosestPointGeneralizedTimeConstrained() {}
 
+		/**
+		 * \brief Computes the covariances of the points in indices (all points if indices is null) using the same neighborhood and regularization of pcl::GeneralizedIterativeClosestPoint.
+		 * The covariances and the squared distance to the farthest neighbor of each point are written in place, allowing the update of only a subset of the points.
+		 */
+		template <typename PointT>
+		bool computeCovariancesParallel(const typename pcl::PointCloud<PointT>::ConstPtr& cloud, const typename pcl::search::KdTree<PointT>::Ptr& kdtree, MatricesVector& cloud_covariances,
+				std::vector<float>& farthest_neighbor_squared_distances, const std::vector<int>* indices = nullptr);
+
+		inline int getNumberOfThreads() const { return number_of_threads_; }
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
 		inline double getTransformCloudElapsedTime() { return transform_cloud_elapsed_time_ms_; }
 		inline void resetTransformCloudElapsedTime() { transform_cloud_elapsed_time_ms_ = 0; }
 
 	protected:
+		using pcl::Registration<PointSource, PointTarget>::input_;
+		using pcl::Registration<PointSource, PointTarget>::target_;
+		using pcl::Registration<PointSource, PointTarget>::tree_;
+		using pcl::Registration<PointSource, PointTarget>::tree_reciprocal_;
+		using pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::input_covariances_;
+		using pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::target_covariances_;
+
+		virtual void computeTransformation(typename pcl::Registration<PointSource, PointTarget>::PointCloudSource &output, const Eigen::Matrix4f &guess);
+
 		virtual void transformCloud(const typename pcl::Registration<PointSource, PointTarget>::PointCloudSource &input, typename pcl::Registration<PointSource, PointTarget>::PointCloudSource &output, const typename pcl::Registration<PointSource, PointTarget>::Matrix4 &transform) {
 			PerformanceTimer timer_;
 			timer_.start();
@@ -51,6 +86,7 @@ class IterativeClosestPointGeneralizedTimeConstrained: public pcl::GeneralizedIt
 			transform_cloud_elapsed_time_ms_ += timer_.getElapsedTimeInMilliSec();
 		}
 
+		int number_of_threads_;
 		double transform_cloud_elapsed_time_ms_;
 };
 
@@ -69,12 +105,14 @@ class IterativeClosestPointGeneralized : public IterativeClosestPoint<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		IterativeClosestPointGeneralized() {}
+		IterativeClosestPointGeneralized() : cache_reference_cloud_covariances_(true), reference_cloud_covariances_number_of_neighbors_(0) {}
 		virtual ~IterativeClosestPointGeneralized() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPointGeneralized-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
 		virtual double getTransformCloudElapsedTimeMS();
 		virtual void resetTransformCloudElapsedTime();
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPointGeneralized-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -88,6 +126,19 @@ class IterativeClosestPointGeneralized : public IterativeClosestPoint<PointT> {
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		/**
+		 * \brief Updates the cached covariances of the reference cloud.
+		 * If the cached points are a prefix of the new reference cloud (map integration appends the new points), only the appended points and the previous points
+		 * that have an appended point closer than their farthest neighbor are recomputed. Otherwise, all the covariances are recomputed.
+		 */
+		void updateReferenceCloudCovariances(const typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::search::KdTree<PointT>::Ptr& search_method,
+				typename IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT>::Ptr& matcher);
+
+		bool cache_reference_cloud_covariances_;
+		typename IterativeClosestPointGeneralizedTimeConstrained<PointT, PointT>::MatricesVectorPtr reference_cloud_covariances_;
+		std::vector<float> reference_cloud_farthest_neighbor_squared_distances_;
+		std::vector<Eigen::Vector3f> reference_cloud_covariances_points_;
+		int reference_cloud_covariances_number_of_neighbors_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -0,0 +1,103 @@
+#pragma once
+
+/**\file iterative_closest_point_multi_resolution.h
+ * \brief Coarse to fine ICP using voxel grid pyramids of the reference and ambient point clouds.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
+#include <XmlRpcValue.h>
+
+// PCL includes
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/point_cloud.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <Eigen/Core>
+
+// project includes
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point.h>
+#include <dynamic_robot_localization/common/math_utils.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+#include <dynamic_robot_localization/common/pointcloud_utils.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ##############################################################   iterative_closest_point_multi_resolution   ###############################################################
+/**
+ * \brief ICP that runs a schedule of coarse levels (voxel grid leaf size, number of iterations and correspondence distance) before the full resolution registration.
+ * The reference pyramid is built once in setupReferenceCloud and reused for every registration, while the ambient pyramid is built once per registration.
+ * Each coarse level starts from the transformation estimated in the previous level, and the last one is used as initial guess of the full resolution ICP.
+ * The convergence time limit, iterations telemetry and elapsed times of the full resolution ICP are reset after the coarse levels (their time is in getPyramidLevelsElapsedTimeMS).
+ */
+template <typename PointT>
+class IterativeClosestPointMultiResolution : public IterativeClosestPoint<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< IterativeClosestPointMultiResolution<PointT> >;
+		using ConstPtr = std::shared_ptr< const IterativeClosestPointMultiResolution<PointT> >;
+
+		struct PyramidLevel {
+			double voxel_grid_leaf_size;
+			int max_number_of_registration_iterations;
+			double max_correspondence_distance;
+			typename pcl::PointCloud<PointT>::Ptr reference_cloud;
+			typename pcl::search::KdTree<PointT>::Ptr reference_cloud_search_method;
+			typename pcl::PointCloud<PointT>::Ptr ambient_cloud;
+			typename pcl::search::KdTree<PointT>::Ptr ambient_cloud_search_method;
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		IterativeClosestPointMultiResolution() : normalize_normals_of_pyramid_levels_(true), pyramid_levels_elapsed_time_ms_(0.0) {}
+		virtual ~IterativeClosestPointMultiResolution() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPointMultiResolution-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
+		virtual void computeRegistrationInitialGuess(Eigen::Matrix4f& initial_guess_in_out);
+		void buildPyramidLevelCloud(const typename pcl::PointCloud<PointT>::ConstPtr& input_cloud, double voxel_grid_leaf_size, typename pcl::PointCloud<PointT>::Ptr& level_cloud_out);
+		void setupRegistrationData(const typename pcl::PointCloud<PointT>::ConstPtr& source_cloud, const typename pcl::search::KdTree<PointT>::Ptr& source_cloud_search_method,
+				const typename pcl::PointCloud<PointT>::Ptr& target_cloud, const typename pcl::search::KdTree<PointT>::Ptr& target_cloud_search_method,
+				int max_number_of_registration_iterations, double max_correspondence_distance);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPointMultiResolution-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		inline const std::vector<PyramidLevel>& getPyramidLevels() const { return pyramid_levels_; }
+		inline double getPyramidLevelsElapsedTimeMS() const { return pyramid_levels_elapsed_time_ms_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		std::vector<PyramidLevel> pyramid_levels_; // sorted from the coarsest to the finest level
+		bool normalize_normals_of_pyramid_levels_;
+		double pyramid_levels_elapsed_time_ms_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/impl/iterative_closest_point_multi_resolution.hpp>
+#endif
@@ -0,0 +1,119 @@
+#pragma once
+
+/**\file iterative_closest_point_multi_seed.h
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/common/centroid.h>
+#include <pcl/point_cloud.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+// project includes
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point.h>
+#include <dynamic_robot_localization/common/math_utils.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// #################################################################   iterative_closest_point_multi_seed   #################################################################
+/**
+ * \brief ICP for initial pose estimation that searches a lattice of seed poses around the pose prior (position grid x yaw bins, optionally roll / pitch bins) before the full resolution registration.
+ * Each round runs a few iterations of a subsampled ICP from every active seed (in parallel, with one ICP per thread sharing the reference cloud search tree),
+ * scores the seeds by their inlier fraction, keeps the best ones (successive halving) and doubles the number of ambient points used in the next round.
+ * The best seed is used as initial guess of the full resolution ICP and the best few seeds are returned as accepted poses.
+ */
+template <typename PointT>
+class IterativeClosestPointMultiSeed : public IterativeClosestPoint<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< IterativeClosestPointMultiSeed<PointT> >;
+		using ConstPtr = std::shared_ptr< const IterativeClosestPointMultiSeed<PointT> >;
+
+		struct Seed {
+			Eigen::Matrix4f transformation;
+			float score;
+			EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+		};
+		using SeedVector = std::vector< Seed, Eigen::aligned_allocator<Seed> >;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		IterativeClosestPointMultiSeed() :
+			seed_position_window_x_(2.0), seed_position_window_y_(2.0), seed_position_window_z_(0.0), seed_position_step_(1.0),
+			seed_yaw_window_(M_PI), seed_yaw_step_(M_PI / 6.0), seed_roll_pitch_window_(0.0), seed_roll_pitch_step_(0.1),
+			seed_initial_number_of_points_(100), seed_iterations_per_round_(5), seed_keep_fraction_(0.5), number_of_best_seeds_(3),
+			seed_max_correspondence_distance_(1.0), seed_inlier_distance_(0.3), number_of_threads_(0),
+			pose_prior_available_(false), pose_prior_position_(Eigen::Vector3f::Zero()),
+			accepted_transformations_(new std::vector< typename pcl::Registration<PointT, PointT>::Matrix4>()) {}
+		virtual ~IterativeClosestPointMultiSeed() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPointMultiSeed-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setPosePrior(const tf2::Transform& pose_prior);
+		virtual void computeRegistrationInitialGuess(Eigen::Matrix4f& initial_guess_in_out);
+		virtual std::shared_ptr< std::vector< typename pcl::Registration<PointT, PointT>::Matrix4> > getAcceptedTransformations() { return accepted_transformations_; }
+
+		void generateSeeds(const Eigen::Vector3f& center, const Eigen::Matrix4f& initial_guess, SeedVector& seeds_out) const;
+		void runSeedsRound(const typename pcl::PointCloud<PointT>::Ptr& source_sample, SeedVector& seeds);
+		static void s_computeAngles(double window, double step, std::vector<float>& angles_out);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPointMultiSeed-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual std::string getCloudMatcherName() { return "IterativeClosestPointMultiSeed"; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		double seed_position_window_x_;
+		double seed_position_window_y_;
+		double seed_position_window_z_;
+		double seed_position_step_;
+		double seed_yaw_window_;
+		double seed_yaw_step_;
+		double seed_roll_pitch_window_;
+		double seed_roll_pitch_step_;
+		int seed_initial_number_of_points_;
+		int seed_iterations_per_round_;
+		double seed_keep_fraction_;
+		int number_of_best_seeds_;
+		double seed_max_correspondence_distance_;
+		double seed_inlier_distance_;
+		int number_of_threads_;
+
+		bool pose_prior_available_;
+		Eigen::Vector3f pose_prior_position_;
+
+		std::vector< typename IterativeClosestPointTimeConstrained<PointT, PointT, float>::Ptr > seed_matchers_; // one per thread
+		std::shared_ptr< std::vector< typename pcl::Registration<PointT, PointT>::Matrix4> > accepted_transformations_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/impl/iterative_closest_point_multi_seed.hpp>
+#endif
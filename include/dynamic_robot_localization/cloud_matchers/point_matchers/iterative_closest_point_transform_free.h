@@ -0,0 +1,204 @@
+#pragma once
+
+/**\file iterative_closest_point_transform_free.h
+ * \brief ICP that applies the current transform on the fly in the correspondence search and error accumulation, instead of transforming the source cloud on every iteration.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// PCL includes
+#include <pcl/conversions.h>
+#include <pcl/correspondence.h>
+#include <pcl/registration/icp.h>
+#include <pcl/registration/correspondence_rejection_poly.h>
+#include <pcl/registration/correspondence_rejection_sample_consensus.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/SVD>
+#include <Eigen/Cholesky>
+
+// project includes
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+#include <dynamic_robot_localization/convergence_estimators/default_convergence_criteria_with_time.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ########################################################   iterative_closest_point_transform_free_time_constrained   ########################################################
+/**
+ * \brief ICP that keeps the source cloud untransformed during the iterations.
+ * The current transformation is applied to each source point when querying the target search tree and when accumulating the terms of the transformation estimation.
+ * The aligned cloud is only materialized once, after convergence.
+ * The correspondence search and the transformation estimation are built in (the correspondence and transformation estimators of pcl::Registration are not used).
+ */
+template <typename PointSource, typename PointTarget, typename Scalar = float>
+class IterativeClosestPointTransformFreeTimeConstrained: public pcl::IterativeClosestPoint<PointSource, PointTarget, Scalar> {
+	public:
+		using Ptr = std::shared_ptr< IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar> >;
+		using ConstPtr = std::shared_ptr< const IterativeClosestPointTransformFreeTimeConstrained<PointSource, PointTarget, Scalar> >;
+		using Matrix4 = typename pcl::Registration<PointSource, PointTarget, Scalar>::Matrix4;
+		using PointCloudSource = typename pcl::Registration<PointSource, PointTarget, Scalar>::PointCloudSource;
+		using PointCloudSourcePtr = typename pcl::Registration<PointSource, PointTarget, Scalar>::PointCloudSourcePtr;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::input_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::target_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::indices_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::tree_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::tree_reciprocal_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::nr_iterations_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::max_iterations_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::min_number_correspondences_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::corr_dist_threshold_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::transformation_epsilon_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::transformation_rotation_epsilon_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::euclidean_fitness_epsilon_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::transformation_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::previous_transformation_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::final_transformation_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::converged_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::correspondences_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::correspondence_rejectors_;
+		using pcl::Registration<PointSource, PointTarget, Scalar>::update_visualizer_;
+		using pcl::IterativeClosestPoint<PointSource, PointTarget, Scalar>::convergence_criteria_;
+		using pcl::IterativeClosestPoint<PointSource, PointTarget, Scalar>::use_reciprocal_correspondence_;
+
+		enum ErrorMetric {
+			PointToPoint,
+			PointToPoint2D,
+			PointToPlane
+		};
+
+		/** \brief Sums of the point to point terms (centroids and cross covariance) of a block of correspondences. */
+		struct PointToPointAccumulator {
+			EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+			PointToPointAccumulator() : source_sum(Eigen::Vector3d::Zero()), target_sum(Eigen::Vector3d::Zero()), source_target_products_sum(Eigen::Matrix3d::Zero()), number_of_correspondences(0) {}
+			PointToPointAccumulator& operator+=(const PointToPointAccumulator& other) {
+				source_sum += other.source_sum;
+				target_sum += other.target_sum;
+				source_target_products_sum += other.source_target_products_sum;
+				number_of_correspondences += other.number_of_correspondences;
+				return *this;
+			}
+			Eigen::Vector3d source_sum;
+			Eigen::Vector3d target_sum;
+			Eigen::Matrix3d source_target_products_sum;
+			size_t number_of_correspondences;
+		};
+
+		/** \brief Normal equations [ATA | ATb] of the linearized point to plane error of a block of correspondences. */
+		using PointToPlaneAccumulator = Eigen::Matrix<double, 6, 7>;
+
+		IterativeClosestPointTransformFreeTimeConstrained(double convergence_time_limit_seconds = std::numeric_limits<double>::max()) :
+				error_metric_(PointToPoint),
+				number_of_threads_(0),
+				correspondence_estimation_elapsed_time_ms_(0.0),
+				transformation_estimation_elapsed_time_ms_(0.0),
+				transform_cloud_elapsed_time_ms_(0.0) {
+			pcl::IterativeClosestPoint<PointSource, PointTarget, Scalar>::convergence_criteria_.reset(new DefaultConvergenceCriteriaWithTime<Scalar> (
+					pcl::Registration<PointSource, PointTarget, Scalar>::nr_iterations_,
+					pcl::Registration<PointSource, PointTarget, Scalar>::transformation_,
+					*pcl::Registration<PointSource, PointTarget, Scalar>::correspondences_,
+					convergence_time_limit_seconds));
+			pcl::Registration<PointSource, PointTarget, Scalar>::reg_name_ = "IterativeClosestPointTransformFree";
+		}
+
+		virtual ~IterativeClosestPointTransformFreeTimeConstrained() {}
+
+		inline ErrorMetric getErrorMetric() const { return error_metric_; }
+		inline int getNumberOfThreads() const { return number_of_threads_; }
+		inline double getCorrespondenceEstimationElapsedTime() { return correspondence_estimation_elapsed_time_ms_; }
+		inline double getTransformationEstimationElapsedTime() { return transformation_estimation_elapsed_time_ms_; }
+		inline double getTransformCloudElapsedTime() { return transform_cloud_elapsed_time_ms_; }
+
+		inline void setErrorMetric(ErrorMetric error_metric) { error_metric_ = error_metric; }
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		inline void resetCorrespondenceEstimationElapsedTime() { correspondence_estimation_elapsed_time_ms_ = 0.0; }
+		inline void resetTransformationEstimationElapsedTime() { transformation_estimation_elapsed_time_ms_ = 0.0; }
+		inline void resetTransformCloudElapsedTime() { transform_cloud_elapsed_time_ms_ = 0.0; }
+
+	protected:
+		virtual void computeTransformation(PointCloudSource &output, const Matrix4 &guess);
+		virtual void determineCorrespondencesWithTransform(const Eigen::Matrix4f& source_to_target_transform, pcl::Correspondences& correspondences_out);
+		virtual bool estimateIncrementalTransformation(const Eigen::Matrix4f& source_to_target_transform, const pcl::Correspondences& correspondences, Matrix4& incremental_transformation_out);
+		bool estimateIncrementalTransformationPointToPoint(const Eigen::Matrix4f& source_to_target_transform, const pcl::Correspondences& correspondences, Matrix4& incremental_transformation_out);
+		bool estimateIncrementalTransformationPointToPlane(const Eigen::Matrix4f& source_to_target_transform, const pcl::Correspondences& correspondences, Matrix4& incremental_transformation_out);
+		void setupCorrespondenceRejectors(std::vector<bool>& rejectors_requiring_aligned_source_out);
+		void applyCorrespondenceRejectors(const std::vector<bool>& rejectors_requiring_aligned_source, const Eigen::Matrix4f& source_to_target_transform);
+
+		virtual void transformCloud(const PointCloudSource &input, PointCloudSource &output, const Matrix4 &transform) {
+			PerformanceTimer timer_;
+			timer_.start();
+			pcl::IterativeClosestPoint<PointSource, PointTarget, Scalar>::transformCloud(input, output, transform);
+			transform_cloud_elapsed_time_ms_ += timer_.getElapsedTimeInMilliSec();
+		}
+
+		ErrorMetric error_metric_;
+		int number_of_threads_;
+		std::vector<pcl::Correspondence> correspondences_candidates_;
+		PointCloudSourcePtr aligned_source_;
+		double correspondence_estimation_elapsed_time_ms_;
+		double transformation_estimation_elapsed_time_ms_;
+		double transform_cloud_elapsed_time_ms_;
+};
+
+
+// ################################################################   iterative_closest_point_transform_free   #################################################################
+/**
+ * \brief Cloud matcher wrapper for IterativeClosestPointTransformFreeTimeConstrained.
+ */
+template <typename PointT>
+class IterativeClosestPointTransformFree : public IterativeClosestPoint<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< IterativeClosestPointTransformFree<PointT> >;
+		using ConstPtr = std::shared_ptr< const IterativeClosestPointTransformFree<PointT> >;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		IterativeClosestPointTransformFree() {}
+		virtual ~IterativeClosestPointTransformFree() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IterativeClosestPoint-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual double getCorrespondenceEstimationElapsedTimeMS();
+		virtual void resetCorrespondenceEstimationElapsedTime();
+		virtual double getTransformationEstimationElapsedTimeMS();
+		virtual void resetTransformationEstimationElapsedTime();
+		virtual double getTransformCloudElapsedTimeMS();
+		virtual void resetTransformCloudElapsedTime();
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IterativeClosestPoint-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		typename IterativeClosestPointTransformFreeTimeConstrained<PointT, PointT>::Ptr getTransformFreeMatcher();
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/impl/iterative_closest_point_transform_free.hpp>
+#endif
@@ -9,18 +9,22 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <cmath>
 #include <memory>
 #include <string>
 
 // PCL includes
+#include <pcl/common/transforms.h>
 #include <pcl/registration/ndt_2d.h>
 #include <pcl/registration/registration.h>
 
 // external libs includes
 #include <Eigen/Core>
+#include <Eigen/Eigenvalues>
 
 // project includes
 #include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
@@ -41,6 +45,62 @@ class NormalDistributionsTransform2DDetailed: public pcl::NormalDistributionsTra
 		}
 };
 
+
+// ##############################################################   NormalDistributionsTransform2DParallel   ###############################################################
+/**
+ * \brief Same Newton optimization as pcl::NormalDistributionsTransform2D, but with the score, gradient and Hessian of the source points evaluated by several threads (deterministic block reduction).
+ * The target grid with the normal distributions is built only when the target cloud or the grid parameters change, instead of at the start of every registration.
+ */
+template <typename PointSource, typename PointTarget>
+class NormalDistributionsTransform2DParallel: public NormalDistributionsTransform2DDetailed<PointSource, PointTarget> {
+	public:
+		using Ptr = std::shared_ptr< NormalDistributionsTransform2DParallel<PointSource, PointTarget> >;
+		using ConstPtr = std::shared_ptr< const NormalDistributionsTransform2DParallel<PointSource, PointTarget> >;
+		using PointCloudSource = typename pcl::Registration<PointSource, PointTarget>::PointCloudSource;
+		using PointCloudTargetConstPtr = typename pcl::Registration<PointSource, PointTarget>::PointCloudTargetConstPtr;
+		using TargetGrid = pcl::ndt2d::NDT2D<PointTarget>;
+		using ScoreAndDerivatives = pcl::ndt2d::ValueAndDerivatives<3, double>;
+
+		NormalDistributionsTransform2DParallel() : number_of_threads_(0), block_size_(256) {}
+		virtual ~NormalDistributionsTransform2DParallel() {}
+
+		virtual void setInputTarget(const PointCloudTargetConstPtr &cloud) {
+			pcl::Registration<PointSource, PointTarget>::setInputTarget(cloud);
+			target_grid_.reset();
+		}
+
+		inline int getNumberOfThreads() const { return number_of_threads_; }
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		inline void setBlockSize(size_t block_size) { block_size_ = block_size; }
+
+	protected:
+		using pcl::Registration<PointSource, PointTarget>::nr_iterations_;
+		using pcl::Registration<PointSource, PointTarget>::max_iterations_;
+		using pcl::Registration<PointSource, PointTarget>::converged_;
+		using pcl::Registration<PointSource, PointTarget>::transformation_;
+		using pcl::Registration<PointSource, PointTarget>::final_transformation_;
+		using pcl::Registration<PointSource, PointTarget>::previous_transformation_;
+		using pcl::Registration<PointSource, PointTarget>::transformation_epsilon_;
+		using pcl::Registration<PointSource, PointTarget>::transformation_rotation_epsilon_;
+		using pcl::Registration<PointSource, PointTarget>::target_;
+		using pcl::Registration<PointSource, PointTarget>::indices_;
+		using pcl::Registration<PointSource, PointTarget>::update_visualizer_;
+		using pcl::NormalDistributionsTransform2D<PointSource, PointTarget>::grid_centre_;
+		using pcl::NormalDistributionsTransform2D<PointSource, PointTarget>::grid_step_;
+		using pcl::NormalDistributionsTransform2D<PointSource, PointTarget>::grid_extent_;
+		using pcl::NormalDistributionsTransform2D<PointSource, PointTarget>::newton_lambda_;
+
+		virtual void computeTransformation(PointCloudSource &output, const Eigen::Matrix4f &guess);
+		void updateTargetGrid();
+
+		int number_of_threads_;
+		size_t block_size_;
+		std::shared_ptr<TargetGrid> target_grid_;
+		Eigen::Vector2f target_grid_centre_;
+		Eigen::Vector2f target_grid_step_;
+		Eigen::Vector2f target_grid_extent_;
+};
+
 // #####################################################################   NormalDistributionsTransform2D   ####################################################################
 /**
  * \brief Description...
@@ -55,12 +115,14 @@ class NormalDistributionsTransform2D : public CloudMatcher<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		NormalDistributionsTransform2D() {}
+		NormalDistributionsTransform2D() : reuse_target_grid_when_reference_cloud_is_unchanged_(true), reference_cloud_number_of_points_(0), reference_cloud_stamp_(0) {}
 		virtual ~NormalDistributionsTransform2D() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalDistributionsTransform2D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
 		virtual int getNumberOfRegistrationIterations();
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalDistributionsTransform2D-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -73,6 +135,9 @@ class NormalDistributionsTransform2D : public CloudMatcher<PointT> {
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		bool reuse_target_grid_when_reference_cloud_is_unchanged_;
+		size_t reference_cloud_number_of_points_;
+		uint64_t reference_cloud_stamp_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -9,14 +9,22 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <cmath>
 #include <memory>
 #include <string>
+#include <vector>
 
 // PCL includes
+#include <pcl/common/transforms.h>
 #include <pcl/registration/ndt.h>
 
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/SVD>
+
 // project includes
 #include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
@@ -32,6 +40,70 @@ class NormalDistributionsTransformDetailed: public pcl::NormalDistributionsTrans
 };
 
 
+// ###############################################################   NormalDistributionsTransformParallel   ###############################################################
+/**
+ * \brief Same Newton optimization and More-Thuente line search as pcl::NormalDistributionsTransform, but with the score, gradient and Hessian evaluated by several threads.
+ * The source points are split in fixed size blocks, each block accumulates its own score / gradient / Hessian, and the partial sums are added in block order (results do not depend on the number of threads).
+ * The point derivatives are computed from the closed form derivatives of the rotation matrix (R = Rx * Ry * Rz), evaluated once per transform and shared (read only) by all threads.
+ */
+template <typename PointSource, typename PointTarget>
+class NormalDistributionsTransformParallel: public NormalDistributionsTransformDetailed<PointSource, PointTarget> {
+	public:
+		using Ptr = std::shared_ptr< NormalDistributionsTransformParallel<PointSource, PointTarget> >;
+		using ConstPtr = std::shared_ptr< const NormalDistributionsTransformParallel<PointSource, PointTarget> >;
+		using PointCloudSource = typename pcl::Registration<PointSource, PointTarget>::PointCloudSource;
+		using TargetGridLeafConstPtr = typename pcl::NormalDistributionsTransform<PointSource, PointTarget>::TargetGridLeafConstPtr;
+		using DerivativesAccumulator = Eigen::Matrix<double, 6, 8>; // [hessian | score gradient | score]
+
+		struct TransformDerivatives {
+			Eigen::Matrix3d rotation_jacobians[3]; // dR / d(roll, pitch, yaw)
+			Eigen::Matrix3d rotation_hessians[3][3]; // d2R / d(angle_i) d(angle_j)
+		};
+
+		NormalDistributionsTransformParallel() : number_of_threads_(0), block_size_(256) {}
+		virtual ~NormalDistributionsTransformParallel() {}
+
+		inline int getNumberOfThreads() const { return number_of_threads_; }
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		inline void setBlockSize(size_t block_size) { block_size_ = block_size; }
+
+	protected:
+		using pcl::Registration<PointSource, PointTarget>::input_;
+		using pcl::Registration<PointSource, PointTarget>::nr_iterations_;
+		using pcl::Registration<PointSource, PointTarget>::max_iterations_;
+		using pcl::Registration<PointSource, PointTarget>::converged_;
+		using pcl::Registration<PointSource, PointTarget>::transformation_;
+		using pcl::Registration<PointSource, PointTarget>::final_transformation_;
+		using pcl::Registration<PointSource, PointTarget>::previous_transformation_;
+		using pcl::Registration<PointSource, PointTarget>::transformation_epsilon_;
+		using pcl::Registration<PointSource, PointTarget>::transformation_rotation_epsilon_;
+		using pcl::Registration<PointSource, PointTarget>::target_;
+		using pcl::Registration<PointSource, PointTarget>::update_visualizer_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::target_cells_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::resolution_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::step_size_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::outlier_ratio_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::gauss_d1_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::gauss_d2_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::trans_probability_;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::convertTransform;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::auxilaryFunction_PsiMT;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::auxilaryFunction_dPsiMT;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::updateIntervalMT;
+		using pcl::NormalDistributionsTransform<PointSource, PointTarget>::trialValueSelectionMT;
+
+		virtual void computeTransformation(PointCloudSource &output, const Eigen::Matrix4f &guess);
+		double computeDerivativesParallel(Eigen::Matrix<double, 6, 1> &score_gradient, Eigen::Matrix<double, 6, 6> &hessian, const PointCloudSource &trans_cloud,
+				const Eigen::Matrix<double, 6, 1> &transform, bool compute_hessian = true);
+		double computeStepLengthMTParallel(const Eigen::Matrix<double, 6, 1> &transform, Eigen::Matrix<double, 6, 1> &step_dir, double step_init, double step_max, double step_min,
+				double &score, Eigen::Matrix<double, 6, 1> &score_gradient, Eigen::Matrix<double, 6, 6> &hessian, PointCloudSource &trans_cloud);
+		static void computeTransformDerivatives(const Eigen::Matrix<double, 6, 1> &transform, TransformDerivatives &transform_derivatives);
+
+		int number_of_threads_;
+		size_t block_size_;
+};
+
+
 // #####################################################################   NormalDistributionsTransform3D   ####################################################################
 /**
  * \brief Description...
@@ -46,12 +118,14 @@ class NormalDistributionsTransform3D : public CloudMatcher<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		NormalDistributionsTransform3D() {}
+		NormalDistributionsTransform3D() : reuse_target_grid_when_reference_cloud_is_unchanged_(true), reference_cloud_number_of_points_(0), reference_cloud_stamp_(0) {}
 		virtual ~NormalDistributionsTransform3D() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalDistributionsTransform3D-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
 		virtual int getNumberOfRegistrationIterations();
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalDistributionsTransform3D-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -64,6 +138,9 @@ class NormalDistributionsTransform3D : public CloudMatcher<PointT> {
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		bool reuse_target_grid_when_reference_cloud_is_unchanged_;
+		size_t reference_cloud_number_of_points_;
+		uint64_t reference_cloud_stamp_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -0,0 +1,115 @@
+#pragma once
+
+/**\file polar_histogram_rotation_estimator.h
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// PCL includes
+#include <pcl/common/centroid.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+// project includes
+#include <dynamic_robot_localization/cloud_analyzers/angular_distribution_analyzer.h>
+#include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ####################################################################   PolarHistogramRotationEstimator   ###################################################################
+/**
+ * \brief Yaw pre-alignment stage that builds histograms of the normals orientation (in the xy plane) of the ambient point cloud and of the local reference point cloud
+ * and estimates the rotation between them with a FFT circular cross correlation, in O(n + b log b) for n points and b bins.
+ * The best correlation peaks are converted into rotations around the pose prior position (or the ambient centroid), verified by their inlier fraction and returned as accepted poses,
+ * leaving the translation to be solved by the next matchers (ICP or feature matchers).
+ * The ambient point cloud must be in the map frame and have normals.
+ */
+template <typename PointT>
+class PolarHistogramRotationEstimator : public CloudMatcher<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< PolarHistogramRotationEstimator<PointT> >;
+		using ConstPtr = std::shared_ptr< const PolarHistogramRotationEstimator<PointT> >;
+
+		struct RotationCandidate {
+			float yaw = 0.0f;
+			float score = 0.0f;
+
+			inline bool operator>(const RotationCandidate& other) const { return score > other.score; }
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		PolarHistogramRotationEstimator() :
+			axial_normals_histogram_(true), reference_search_radius_(10.0), number_of_rotation_candidates_(2),
+			candidate_verification_inlier_distance_(0.3), candidate_verification_maximum_number_of_points_(500), candidate_verification_minimum_inlier_fraction_(0.0),
+			pose_prior_available_(false), pose_prior_position_(Eigen::Vector3f::Zero()) {
+			angular_distribution_analyzer_.setNumberOfAngularBins(360);
+		}
+		virtual ~PolarHistogramRotationEstimator() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PolarHistogramRotationEstimator-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
+		virtual void setPosePrior(const tf2::Transform& pose_prior);
+		virtual bool registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints, tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints = false);
+
+		/** Histogram of the reference points within reference_search_radius_ of the rotation center (or of the whole reference point cloud if the radius is <= 0) */
+		bool computeReferenceHistogram(const Eigen::Vector3f& rotation_center, std::vector<double>& histogram_out) const;
+		/** Yaw angles of the highest circular local maxima of the correlation (refined with a parabola fit over the neighbor bins), sorted by decreasing correlation */
+		void extractRotationCandidates(const std::vector<double>& correlation, std::vector<RotationCandidate>& candidates_out) const;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PolarHistogramRotationEstimator-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual std::string getCloudMatcherName() { return "PolarHistogramRotationEstimator"; }
+		virtual bool registrationRequiresNormalsOnAmbientPointCloud() { return true; }
+		inline AngularDistributionAnalyzer<PointT>& getAngularDistributionAnalyzer() { return angular_distribution_analyzer_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		AngularDistributionAnalyzer<PointT> angular_distribution_analyzer_;
+		bool axial_normals_histogram_;
+		double reference_search_radius_;
+		int number_of_rotation_candidates_;
+		double candidate_verification_inlier_distance_;
+		int candidate_verification_maximum_number_of_points_;
+		double candidate_verification_minimum_inlier_fraction_;
+
+		bool pose_prior_available_;
+		Eigen::Vector3f pose_prior_position_;
+		std::vector<double> reference_histogram_; // cached when the histogram is computed over the whole reference point cloud
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/impl/polar_histogram_rotation_estimator.hpp>
+#endif
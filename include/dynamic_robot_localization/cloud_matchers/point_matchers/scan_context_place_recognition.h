@@ -0,0 +1,143 @@
+#pragma once
+
+/**\file scan_context_place_recognition.h
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// PCL includes
+#include <pcl/common/common.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// project includes
+#include <dynamic_robot_localization/cloud_matchers/cloud_matcher.h>
+#include <dynamic_robot_localization/common/math_utils.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ######################################################################   ScanContextPlaceRecognition   #####################################################################
+/**
+ * \brief Global relocalization using a database of scan context descriptors (polar grid of rings x sectors around the sensor) computed from the reference point cloud
+ * over a grid of candidate sensor positions.
+ * The database candidates are preselected with the rotation invariant ring keys and then compared with the ambient scan context over all sector shifts (which gives the yaw).
+ * The best candidate poses are verified with the inlier fraction of the ambient point cloud and returned as accepted poses, for being refined by the point matchers that follow.
+ * The ambient point cloud is described around the pose prior given by the localization system.
+ */
+template <typename PointT>
+class ScanContextPlaceRecognition : public CloudMatcher<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< ScanContextPlaceRecognition<PointT> >;
+		using ConstPtr = std::shared_ptr< const ScanContextPlaceRecognition<PointT> >;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <enums>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		enum CellValueType {
+			MaximumHeight,
+			Occupancy
+		};
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </enums>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		ScanContextPlaceRecognition() :
+			number_of_rings_(20), number_of_sectors_(60), maximum_radius_(20.0), cell_value_type_(MaximumHeight), cells_height_offset_(0.0), simulate_occlusions_(false),
+			database_grid_resolution_(1.0), database_sensor_height_(0.0), database_minimum_distance_to_reference_points_(0.3), database_minimum_number_of_reference_points_(50),
+			number_of_ring_key_candidates_(50), number_of_pose_candidates_(5), maximum_scan_context_distance_(1.0),
+			candidate_verification_inlier_distance_(0.3), candidate_verification_maximum_number_of_points_(500), candidate_verification_minimum_inlier_fraction_(0.0), number_of_threads_(0),
+			pose_prior_available_(false), pose_prior_position_(Eigen::Vector3f::Zero()), pose_prior_yaw_(0.0f), database_number_of_reference_points_(0), database_hash_(0) {}
+		virtual ~ScanContextPlaceRecognition() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <ScanContextPlaceRecognition-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void setupReferenceCloud(typename pcl::PointCloud<PointT>::Ptr& reference_cloud, typename pcl::PointCloud<PointT>::Ptr& reference_cloud_keypoints,
+				typename pcl::search::KdTree<PointT>::Ptr& search_method);
+		virtual void setPosePrior(const tf2::Transform& pose_prior);
+		virtual bool registerCloud(typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud, typename pcl::search::KdTree<PointT>::Ptr& ambient_pointcloud_search_method,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints, tf2::Transform& best_pose_correction_out, std::vector< tf2::Transform >& accepted_pose_corrections_out,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_registered_out, bool return_aligned_keypoints = false);
+
+		/** Scan context (row major, rings x sectors) of the points (within maximum_radius_) around the given center, with the sectors starting at the given yaw */
+		void computeScanContext(const pcl::PointCloud<PointT>& pointcloud, const std::vector<int>* indices, float center_x, float center_y, float yaw, std::vector<float>& scan_context_out) const;
+		void computeRingKey(const float* scan_context, float* ring_key_out) const;
+		/** Mean cosine distance between the non empty columns of the scan contexts, minimized over the sector shifts of the query */
+		float computeScanContextDistance(const float* query_scan_context, const float* database_scan_context, int& best_sector_shift_out) const;
+
+		/** FNV-1a hash of the reference cloud coordinates and of the parameters used to build the database, stored in the database file for rejecting databases built for other maps */
+		uint64_t computeDatabaseHash() const;
+		bool buildDatabase();
+		bool loadDatabase(const std::string& filename);
+		bool saveDatabase(const std::string& filename) const;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </ScanContextPlaceRecognition-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual std::string getCloudMatcherName() { return "ScanContextPlaceRecognition"; }
+		virtual bool registrationRequiresNormalsOnAmbientPointCloud() { return false; }
+		inline size_t getDatabaseSize() const { return database_positions_.size() / 2; }
+		inline size_t getScanContextSize() const { return (size_t)number_of_rings_ * (size_t)number_of_sectors_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		int number_of_rings_;
+		int number_of_sectors_;
+		double maximum_radius_;
+		CellValueType cell_value_type_;
+		double cells_height_offset_;
+		bool simulate_occlusions_;
+		double database_grid_resolution_;
+		double database_sensor_height_;
+		double database_minimum_distance_to_reference_points_;
+		int database_minimum_number_of_reference_points_;
+		std::string database_filename_;
+		std::string database_save_filename_;
+		int number_of_ring_key_candidates_;
+		int number_of_pose_candidates_;
+		double maximum_scan_context_distance_;
+		double candidate_verification_inlier_distance_;
+		int candidate_verification_maximum_number_of_points_;
+		double candidate_verification_minimum_inlier_fraction_;
+		int number_of_threads_;
+
+		bool pose_prior_available_;
+		Eigen::Vector3f pose_prior_position_;
+		float pose_prior_yaw_;
+
+		size_t database_number_of_reference_points_;
+		uint64_t database_hash_;
+		std::vector<float> database_positions_; // x y of each database entry
+		std::vector<float> database_scan_contexts_; // getScanContextSize() values per database entry
+		std::vector<float> database_ring_keys_; // number_of_rings_ values per database entry
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/impl/scan_context_place_recognition.hpp>
+#endif
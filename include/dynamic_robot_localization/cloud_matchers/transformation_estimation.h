@@ -35,10 +35,15 @@ enum TransformationEstimationApproach {
 	TransformationEstimation2D,
 	TransformationEstimationDualQuaternion,
 	TransformationEstimationLM,
+	TransformationEstimationLMAnalytic,
 	TransformationEstimationPointToPlane,
 	TransformationEstimationPointToPlaneLLS,
+	TransformationEstimationPointToPlaneLLSParallel,
 	TransformationEstimationPointToPlaneLLSWeighted,
+	TransformationEstimationPointToPlaneLLSWeightedParallel,
+	TransformationEstimationPointToPlaneLMAnalytic,
 	TransformationEstimationPointToPlaneWeighted,
+	TransformationEstimationPointToPlaneWeightedLMAnalytic,
 	TransformationEstimationSVD,
 	TransformationEstimationSVDScale
 };
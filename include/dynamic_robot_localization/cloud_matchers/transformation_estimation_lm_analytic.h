@@ -0,0 +1,141 @@
+#pragma once
+
+/**\file transformation_estimation_lm_analytic.h
+ * \brief Levenberg-Marquardt transformation estimation with closed form Jacobians for the point to point and point to plane metrics.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// PCL includes
+#include <pcl/correspondence.h>
+#include <pcl/point_cloud.h>
+#include <pcl/registration/transformation_estimation.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+#include <Eigen/Geometry>
+
+// project includes
+#include <dynamic_robot_localization/common/parallel_utils.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ####################################################################   transformation_estimation_lm_analytic   ####################################################################
+/**
+ * \brief Levenberg-Marquardt minimization of the point to point (or point to plane) error, using the closed form Jacobians of a left perturbation [rotation vector, translation] of the current estimate.
+ * Unlike pcl::registration::TransformationEstimationLM, no numeric differentiation is performed, so each iteration only requires one evaluation of the Jacobians and one evaluation of the cost for each tried damping.
+ * The correspondences are gathered once per estimation into column major workspaces that are reused between calls, allowing the vectorized evaluation of the residuals.
+ */
+template <typename PointSource, typename PointTarget, typename Scalar = float>
+class TransformationEstimationLMAnalyticTimed : public pcl::registration::TransformationEstimation<PointSource, PointTarget, Scalar> {
+	public:
+		using Ptr = std::shared_ptr< TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar> >;
+		using ConstPtr = std::shared_ptr< const TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar> >;
+		using Matrix4 = typename pcl::registration::TransformationEstimation<PointSource, PointTarget, Scalar>::Matrix4;
+		using NormalEquations = Eigen::Matrix<double, 6, 7>; // [JtJ | Jtr]
+
+		enum ErrorMetric {
+			PointToPoint,
+			PointToPlane
+		};
+
+		TransformationEstimationLMAnalyticTimed(ErrorMetric error_metric = PointToPoint) :
+			error_metric_(error_metric), use_weights_(false), use_correspondence_weights_(true),
+			max_iterations_(20), initial_damping_(1e-4), parameters_update_epsilon_(1e-10), number_of_threads_(0), block_size_(1024),
+			workspace_size_(0), transformation_estimation_elapsed_time_(0) {}
+		virtual ~TransformationEstimationLMAnalyticTimed() {}
+
+		virtual void estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt, Matrix4 &transformation_matrix) const;
+		virtual void estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const std::vector<int> &indices_src,
+				const pcl::PointCloud<PointTarget> &cloud_tgt, Matrix4 &transformation_matrix) const;
+		virtual void estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const std::vector<int> &indices_src,
+				const pcl::PointCloud<PointTarget> &cloud_tgt, const std::vector<int> &indices_tgt, Matrix4 &transformation_matrix) const;
+		virtual void estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt,
+				const pcl::Correspondences &correspondences, Matrix4 &transformation_matrix) const;
+
+		inline ErrorMetric getErrorMetric() const { return error_metric_; }
+		inline int getMaximumIterations() const { return max_iterations_; }
+		inline int getNumberOfThreads() const { return number_of_threads_; }
+		inline size_t getBlockSize() const { return block_size_; }
+		inline double getTransformationEstimationElapsedTime() { return transformation_estimation_elapsed_time_; }
+
+		inline void setErrorMetric(ErrorMetric error_metric) { error_metric_ = error_metric; }
+		inline void setMaximumIterations(int max_iterations) { max_iterations_ = max_iterations; }
+		inline void setInitialDamping(double initial_damping) { initial_damping_ = initial_damping; }
+		inline void setParametersUpdateEpsilon(double parameters_update_epsilon) { parameters_update_epsilon_ = parameters_update_epsilon; }
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		inline void setBlockSize(size_t block_size) { block_size_ = block_size; }
+		inline void resetTransformationEstimationElapsedTime() { transformation_estimation_elapsed_time_ = 0; }
+
+	protected:
+		template <typename CorrespondenceAccessor>
+		void fillWorkspace(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt, size_t number_of_correspondences, CorrespondenceAccessor correspondence_accessor) const;
+		void estimateRigidTransformationFromWorkspace(Matrix4 &transformation_matrix) const;
+		double computeCost(const Eigen::Matrix3d& rotation, const Eigen::Vector3d& translation) const;
+		void computeNormalEquations(const Eigen::Matrix3d& rotation, const Eigen::Vector3d& translation, NormalEquations& normal_equations) const;
+
+		ErrorMetric error_metric_;
+		bool use_weights_;
+		bool use_correspondence_weights_;
+		std::vector<double> weights_;
+		int max_iterations_;
+		double initial_damping_;
+		double parameters_update_epsilon_;
+		int number_of_threads_;
+		size_t block_size_;
+
+		mutable Eigen::Matrix3Xd workspace_source_points_;
+		mutable Eigen::Matrix3Xd workspace_target_points_;
+		mutable Eigen::Matrix3Xd workspace_target_normals_;
+		mutable Eigen::RowVectorXd workspace_weights_;
+		mutable Eigen::Matrix3Xd workspace_transformed_points_;
+		mutable size_t workspace_size_;
+		mutable double transformation_estimation_elapsed_time_;
+};
+
+
+// ##############################################################   transformation_estimation_point_to_plane_lm_analytic   ##############################################################
+template <typename PointSource, typename PointTarget, typename Scalar = float>
+class TransformationEstimationPointToPlaneLMAnalyticTimed : public TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar> {
+	public:
+		using Ptr = std::shared_ptr< TransformationEstimationPointToPlaneLMAnalyticTimed<PointSource, PointTarget, Scalar> >;
+		using ConstPtr = std::shared_ptr< const TransformationEstimationPointToPlaneLMAnalyticTimed<PointSource, PointTarget, Scalar> >;
+
+		TransformationEstimationPointToPlaneLMAnalyticTimed() : TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>(TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::PointToPlane) {}
+		virtual ~TransformationEstimationPointToPlaneLMAnalyticTimed() {}
+};
+
+
+// ##########################################################   transformation_estimation_point_to_plane_weighted_lm_analytic   ##########################################################
+/**
+ * \brief Weighted point to plane version (same weights interface as pcl::registration::TransformationEstimationPointToPlaneWeighted).
+ */
+template <typename PointSource, typename PointTarget, typename Scalar = float>
+class TransformationEstimationPointToPlaneWeightedLMAnalyticTimed : public TransformationEstimationPointToPlaneLMAnalyticTimed<PointSource, PointTarget, Scalar> {
+	public:
+		using Ptr = std::shared_ptr< TransformationEstimationPointToPlaneWeightedLMAnalyticTimed<PointSource, PointTarget, Scalar> >;
+		using ConstPtr = std::shared_ptr< const TransformationEstimationPointToPlaneWeightedLMAnalyticTimed<PointSource, PointTarget, Scalar> >;
+
+		TransformationEstimationPointToPlaneWeightedLMAnalyticTimed() { TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::use_weights_ = true; }
+		virtual ~TransformationEstimationPointToPlaneWeightedLMAnalyticTimed() {}
+
+		inline void setWeights(const std::vector<double> &weights) { TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::weights_ = weights; }
+		inline void setUseCorrespondenceWeights(bool use_correspondence_weights) { TransformationEstimationLMAnalyticTimed<PointSource, PointTarget, Scalar>::use_correspondence_weights_ = use_correspondence_weights; }
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/impl/transformation_estimation_lm_analytic.hpp>
+#endif
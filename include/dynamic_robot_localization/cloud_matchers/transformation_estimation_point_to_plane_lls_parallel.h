@@ -0,0 +1,98 @@
+#pragma once
+
+/**\file transformation_estimation_point_to_plane_lls_parallel.h
+ * \brief Point to plane linear least squares transformation estimation with a multi-threaded and deterministic accumulation of the normal equations.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <memory>
+#include <vector>
+
+// PCL includes
+#include <pcl/correspondence.h>
+#include <pcl/point_cloud.h>
+#include <pcl/registration/transformation_estimation_point_to_plane_lls.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+
+// project includes
+#include <dynamic_robot_localization/common/parallel_utils.h>
+#include <dynamic_robot_localization/common/performance_timer.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// ###############################################################   transformation_estimation_point_to_plane_lls_parallel   ###############################################################
+/**
+ * \brief Same minimization as pcl::registration::TransformationEstimationPointToPlaneLLS, but with the 6x6 normal equations accumulated in double precision by several threads.
+ * Each fixed size block of correspondences is reduced independently and the partial sums are added in block order, which keeps the result independent of the number of threads.
+ */
+template <typename PointSource, typename PointTarget, typename Scalar = float>
+class TransformationEstimationPointToPlaneLLSParallelTimed : public pcl::registration::TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar> {
+	public:
+		using Ptr = std::shared_ptr< TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar> >;
+		using ConstPtr = std::shared_ptr< const TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar> >;
+		using Matrix4 = typename pcl::registration::TransformationEstimation<PointSource, PointTarget, Scalar>::Matrix4;
+		using NormalEquations = Eigen::Matrix<double, 6, 7>; // [ATA | ATb]
+
+		using pcl::registration::TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::estimateRigidTransformation;
+
+		TransformationEstimationPointToPlaneLLSParallelTimed() : number_of_threads_(0), block_size_(1024), use_weights_(false), use_correspondence_weights_(true), transformation_estimation_elapsed_time_(0) {}
+		virtual ~TransformationEstimationPointToPlaneLLSParallelTimed() {}
+
+		virtual void estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const std::vector<int> &indices_src,
+				const pcl::PointCloud<PointTarget> &cloud_tgt, const std::vector<int> &indices_tgt, Matrix4 &transformation_matrix) const;
+		virtual void estimateRigidTransformation(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt,
+				const pcl::Correspondences &correspondences, Matrix4 &transformation_matrix) const;
+
+		inline int getNumberOfThreads() const { return number_of_threads_; }
+		inline size_t getBlockSize() const { return block_size_; }
+		inline double getTransformationEstimationElapsedTime() { return transformation_estimation_elapsed_time_; }
+
+		inline void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		inline void setBlockSize(size_t block_size) { block_size_ = block_size; }
+		inline void resetTransformationEstimationElapsedTime() { transformation_estimation_elapsed_time_ = 0; }
+
+	protected:
+		template <typename CorrespondenceAccessor>
+		void estimateRigidTransformationParallel(const pcl::PointCloud<PointSource> &cloud_src, const pcl::PointCloud<PointTarget> &cloud_tgt,
+				size_t number_of_correspondences, CorrespondenceAccessor correspondence_accessor, Matrix4 &transformation_matrix) const;
+
+		int number_of_threads_;
+		size_t block_size_;
+		bool use_weights_;
+		bool use_correspondence_weights_;
+		std::vector<double> weights_;
+		mutable double transformation_estimation_elapsed_time_;
+};
+
+
+// ###########################################################   transformation_estimation_point_to_plane_lls_weighted_parallel   ###########################################################
+/**
+ * \brief Weighted version of TransformationEstimationPointToPlaneLLSParallelTimed (same weights interface as pcl::registration::TransformationEstimationPointToPlaneLLSWeighted).
+ */
+template <typename PointSource, typename PointTarget, typename Scalar = float>
+class TransformationEstimationPointToPlaneLLSWeightedParallelTimed : public TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar> {
+	public:
+		using Ptr = std::shared_ptr< TransformationEstimationPointToPlaneLLSWeightedParallelTimed<PointSource, PointTarget, Scalar> >;
+		using ConstPtr = std::shared_ptr< const TransformationEstimationPointToPlaneLLSWeightedParallelTimed<PointSource, PointTarget, Scalar> >;
+
+		TransformationEstimationPointToPlaneLLSWeightedParallelTimed() { TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar>::use_weights_ = true; }
+		virtual ~TransformationEstimationPointToPlaneLLSWeightedParallelTimed() {}
+
+		inline void setWeights(const std::vector<double> &weights) { TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar>::weights_ = weights; }
+		inline void setUseCorrespondenceWeights(bool use_correspondence_weights) { TransformationEstimationPointToPlaneLLSParallelTimed<PointSource, PointTarget, Scalar>::use_correspondence_weights_ = use_correspondence_weights; }
+};
+
+} /* namespace dynamic_robot_localization */
+
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/cloud_matchers/impl/transformation_estimation_point_to_plane_lls_parallel.hpp>
+#endif
@@ -9,6 +9,7 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <utility>
@@ -49,6 +50,8 @@ class CircularBufferPointCloud {
 		void insertReverse(typename pcl::PointCloud<PointT>::const_iterator first, typename pcl::PointCloud<PointT>::const_iterator last);
 		void eraseNewest(size_t count = 1);
 		void eraseOldest(size_t count = 1);
+		/** Indices of the elements inserted since the last call to resetNewElements (the most recent first) */
+		void getNewElementsIndices(std::vector<int>& indices_out) const;
 
 		typename pcl::PointCloud<PointT>::iterator begin() { return pointcloud_->begin(); }
 		typename pcl::PointCloud<PointT>::const_iterator begin() const { return pointcloud_->begin(); }
@@ -65,28 +68,38 @@ class CircularBufferPointCloud {
 
 		bool empty()  { return pointcloud_->empty(); }
 		size_t size() { return pointcloud_->size(); }
-		void resize(size_t number_elements) { pointcloud_->resize(number_elements); max_buffer_size_ = number_elements; }
+		void resize(size_t number_elements) { pointcloud_->resize(number_elements); max_buffer_size_ = number_elements; number_of_new_elements_ = number_elements; }
 		void reserve(size_t number_elements) { if (pointcloud_->size() < number_elements) { pointcloud_->reserve(number_elements); max_buffer_size_ = number_elements; } }
-		void clear() { pointcloud_->clear(); }
+		void clear() { pointcloud_->clear(); number_of_new_elements_ = 0; replaced_elements_.clear(); }
+		void resetNewElements() { number_of_new_elements_ = 0; replaced_elements_.clear(); }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CircularBufferPointCloud-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		typename pcl::PointCloud<PointT>& getPointCloud() { return *pointcloud_; }
 		typename pcl::PointCloud<PointT>::Ptr getPointCloudPtr() { return pointcloud_; }
 		size_t getMaxBufferSize() const { return max_buffer_size_; }
+		size_t getNumberOfNewElements() const { return std::min(number_of_new_elements_, pointcloud_->size()); }
+		/** Old elements overwritten by the insertions since the last call to resetNewElements (only filled when tracking is enabled) */
+		const pcl::PointCloud<PointT>& getReplacedElements() const { return replaced_elements_; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		void setMaxBufferSize(size_t max_buffer_size) { max_buffer_size_ = max_buffer_size; }
+		void setTrackReplacedElements(bool track_replaced_elements) { track_replaced_elements_ = track_replaced_elements; if (!track_replaced_elements) { replaced_elements_.clear(); } }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
 		size_t fillBuffer(size_t number_elements_to_insert, typename pcl::PointCloud<PointT>::const_iterator first);
+		void addNewElements(size_t number_elements) { number_of_new_elements_ = std::min(number_of_new_elements_ + number_elements, max_buffer_size_); }
+		void addReplacedElement(const PointT& replaced_element) { if (track_replaced_elements_ && replaced_elements_.size() < max_buffer_size_) { replaced_elements_.push_back(replaced_element); } }
 		typename pcl::PointCloud<PointT>::Ptr pointcloud_;
 		size_t next_insert_position_;
 		size_t max_buffer_size_;
+		size_t number_of_new_elements_;
+		bool track_replaced_elements_;
+		pcl::PointCloud<PointT> replaced_elements_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
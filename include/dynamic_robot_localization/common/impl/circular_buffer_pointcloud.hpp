@@ -17,10 +17,11 @@ namespace dynamic_robot_localization {
 // =============================================================================  <public-section>  ============================================================================
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
-CircularBufferPointCloud<PointT>::CircularBufferPointCloud(size_t max_buffer_size, typename pcl::PointCloud<PointT>::Ptr pointcloud) : pointcloud_(pointcloud), max_buffer_size_(max_buffer_size) {
+CircularBufferPointCloud<PointT>::CircularBufferPointCloud(size_t max_buffer_size, typename pcl::PointCloud<PointT>::Ptr pointcloud) : pointcloud_(pointcloud), max_buffer_size_(max_buffer_size), track_replaced_elements_(false) {
 	if (pointcloud_->size() > max_buffer_size) {
 		pointcloud_->resize(max_buffer_size_);
 	}
+	number_of_new_elements_ = pointcloud_->size();
 
 	if (pointcloud_->size() == max_buffer_size) {
 		next_insert_position_ = 0;
@@ -68,8 +69,10 @@ void CircularBufferPointCloud<PointT>::insert(const PointT& new_element) {
 			pointcloud_->insert(pointcloud_->begin() + next_insert_position_, new_element); 	// inserting elements (happens if vector size was modified)
 		}
 	} else {
+		addReplacedElement((*pointcloud_)[next_insert_position_]);
 		(*pointcloud_)[next_insert_position_] = new_element; 									// replacing old elements
 	}
+	addNewElements(1);
 
 	if (++next_insert_position_ >= max_buffer_size_) {
 		next_insert_position_ = 0;																// wrap around
@@ -93,6 +96,7 @@ void CircularBufferPointCloud<PointT>::insert(typename pcl::PointCloud<PointT>::
 	if (number_elements_to_insert > max_buffer_size_) {
 		last = first + max_buffer_size_;
 	}
+	addNewElements(std::distance(first, last));
 
 	size_t remaining_number_elements_to_insert = fillBuffer(number_elements_to_insert, first);
 	std::advance(first, number_elements_to_insert - remaining_number_elements_to_insert);
@@ -100,17 +104,20 @@ void CircularBufferPointCloud<PointT>::insert(typename pcl::PointCloud<PointT>::
 	if (remaining_number_elements_to_insert > 0) {
 		if (next_insert_position_ + remaining_number_elements_to_insert < pointcloud_->size()) { // replacing old elements
 			for (size_t i = 0; i < remaining_number_elements_to_insert; ++i) {
+				addReplacedElement((*pointcloud_)[next_insert_position_]);
 				(*pointcloud_)[next_insert_position_++] = *first++;
 			}
 		} else { // replacing old elements with wrap around
 			size_t next_element_to_insert = 0;
 			size_t number_elements_until_end_of_buffer = pointcloud_->size() - next_insert_position_;
 			for (; next_element_to_insert < number_elements_until_end_of_buffer; ++next_element_to_insert) {
+				addReplacedElement((*pointcloud_)[next_insert_position_]);
 				(*pointcloud_)[next_insert_position_++] = *first++;
 			}
 
 			next_insert_position_ = 0;
 			for (; next_element_to_insert < remaining_number_elements_to_insert; ++next_element_to_insert) {
+				addReplacedElement((*pointcloud_)[next_insert_position_]);
 				(*pointcloud_)[next_insert_position_++] = *first++;
 			}
 		}
@@ -134,22 +141,26 @@ bool CircularBufferPointCloud<PointT>::insertWithSwappping(typename pcl::PointCl
 	if (number_elements_to_insert > max_buffer_size_) {
 		last = first + max_buffer_size_;
 	}
+	addNewElements(std::distance(first, last));
 	size_t remaining_number_elements_to_insert = fillBuffer(number_elements_to_insert, first);
 	std::advance(first, number_elements_to_insert - remaining_number_elements_to_insert);
 
 	if (next_insert_position_ + remaining_number_elements_to_insert < pointcloud_->size()) { // swapping old elements
 		for (size_t i = 0; i < remaining_number_elements_to_insert; ++i) {
+			addReplacedElement((*pointcloud_)[next_insert_position_]);
 			std::swap((*pointcloud_)[next_insert_position_++], *first++);
 		}
 	} else { // swapping old elements with wrap around
 		size_t next_element_to_insert = 0;
 		size_t number_elements_until_end_of_buffer = pointcloud_->size() - next_insert_position_;
 		for (; next_element_to_insert < number_elements_until_end_of_buffer; ++next_element_to_insert) {
+			addReplacedElement((*pointcloud_)[next_insert_position_]);
 			std::swap((*pointcloud_)[next_insert_position_++], *first++);
 		}
 
 		next_insert_position_ = 0;
 		for (; next_element_to_insert < remaining_number_elements_to_insert; ++next_element_to_insert) {
+			addReplacedElement((*pointcloud_)[next_insert_position_]);
 			std::swap((*pointcloud_)[next_insert_position_++], *first++);
 		}
 	}
@@ -170,6 +181,7 @@ void CircularBufferPointCloud<PointT>::insertReverse(const PointT& new_element)
 			(*pointcloud_)[next_insert_position_ - 1] = new_element;
 		}
 	}
+	addNewElements(max_buffer_size_); // reverse insertions are not tracked individually
 }
 
 
@@ -189,6 +201,7 @@ void CircularBufferPointCloud<PointT>::insertReverse(typename pcl::PointCloud<Po
 	if (number_elements_to_insert > max_buffer_size_) {
 		last = first + max_buffer_size_;
 	}
+	addNewElements(max_buffer_size_); // reverse insertions are not tracked individually
 	size_t remaining_number_elements_to_insert = fillBuffer(number_elements_to_insert, first);
 	std::advance(first, number_elements_to_insert - remaining_number_elements_to_insert);
 
@@ -216,6 +229,7 @@ void CircularBufferPointCloud<PointT>::insertReverse(typename pcl::PointCloud<Po
 template<typename PointT>
 void CircularBufferPointCloud<PointT>::eraseNewest(size_t count) {
 	if (count > 0 && !pointcloud_->empty()) {
+		number_of_new_elements_ -= std::min(count, number_of_new_elements_);
 		if (count >= pointcloud_->size()) {
 			pointcloud_->clear();
 			next_insert_position_ = 0;
@@ -249,6 +263,21 @@ void CircularBufferPointCloud<PointT>::eraseOldest(size_t count) {
 		}
 	}
 }
+
+
+template<typename PointT>
+void CircularBufferPointCloud<PointT>::getNewElementsIndices(std::vector<int>& indices_out) const {
+	indices_out.clear();
+	size_t buffer_size = pointcloud_->size();
+	size_t number_of_new_elements = getNumberOfNewElements();
+	if (number_of_new_elements == 0) { return; }
+
+	indices_out.reserve(number_of_new_elements);
+	size_t last_insert_position = std::min(next_insert_position_, buffer_size);
+	for (size_t i = 1; i <= number_of_new_elements; ++i) {
+		indices_out.push_back((int)((last_insert_position + buffer_size - i) % buffer_size));
+	}
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </CircularBufferPointCloud-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
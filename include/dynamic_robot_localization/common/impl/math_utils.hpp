@@ -28,10 +28,7 @@ bool isTransformValid(const Eigen::Matrix<Scalar, 4, 4>& transform) {
 template <typename Scalar>
 std::string convertTransformToString(const Eigen::Matrix<Scalar, 4, 4>& transform, const std::string& line_prefix, const std::string& line_suffix, const std::string& number_separator) {
 	std::stringstream ss;
-	ss	<< line_prefix << std::setw(18) << transform(0, 0) << number_separator << std::setw(18) <<  transform(0, 1) << number_separator << std::setw(18) <<  transform(0, 2) << number_separator << std::setw(18) <<  transform(0, 3) << line_suffix
-		<< line_prefix << std::setw(18) << transform(1, 0) << number_separator << std::setw(18) <<  transform(1, 1) << number_separator << std::setw(18) <<  transform(1, 2) << number_separator << std::setw(18) <<  transform(1, 3) << line_suffix
-		<< line_prefix << std::setw(18) << transform(2, 0) << number_separator << std::setw(18) <<  transform(2, 1) << number_separator << std::setw(18) <<  transform(2, 2) << number_separator << std::setw(18) <<  transform(2, 3) << line_suffix
-		<< line_prefix << std::setw(18) << transform(3, 0) << number_separator << std::setw(18) <<  transform(3, 1) << number_separator << std::setw(18) <<  transform(3, 2) << number_separator << std::setw(18) <<  transform(3, 3) << line_suffix;
+	ss << formatTransform<Scalar>(transform, line_prefix.c_str(), line_suffix.c_str(), number_separator.c_str());
 	return ss.str();
 }
 
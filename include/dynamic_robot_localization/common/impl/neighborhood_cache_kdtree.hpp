@@ -0,0 +1,194 @@
+/**\file neighborhood_cache_kdtree.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/neighborhood_cache_kdtree.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NeighborhoodCacheKdTree-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+bool NeighborhoodCacheKdTree<PointT>::buildNeighborhoodCache(double radius, int k) {
+	clearNeighborhoodCache();
+	typename PointCloud::ConstPtr cloud = this->getInputCloud();
+	if (!cloud || cloud->empty() || (radius <= 0.0 && k <= 0)) { return false; }
+	if (this->getIndices()) {
+		ROS_DEBUG("The neighborhood cache does not support kd-trees built over a subset of the point cloud indices");
+		return false;
+	}
+
+	size_t number_of_points = cloud->size();
+	float squared_radius = (radius > 0.0 ? (float)(radius * radius) : 0.0f);
+	unsigned int maximum_number_of_neighbors = (maximum_number_of_neighbors_ > 0 ? (unsigned int)maximum_number_of_neighbors_ : 0);
+	std::vector< std::vector<int> > points_neighbors_indices(number_of_points);
+	std::vector< std::vector<float> > points_neighbors_squared_distances(number_of_points);
+	complete_neighborhood_squared_radius_.assign(number_of_points, -1.0f);
+
+	#pragma omp parallel for schedule(dynamic, 256) num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	for (int i = 0; i < (int)number_of_points; ++i) {
+		const PointT& point = (*cloud)[i];
+		if (!pcl::isFinite(point)) { continue; } // invalid points are never served from the cache
+
+		std::vector<int>& neighbors_indices = points_neighbors_indices[i];
+		std::vector<float>& neighbors_squared_distances = points_neighbors_squared_distances[i];
+		float complete_neighborhood_squared_radius = 0.0f;
+
+		if (radius > 0.0) {
+			pcl::search::KdTree<PointT>::radiusSearch(point, radius, neighbors_indices, neighbors_squared_distances, maximum_number_of_neighbors);
+			if (maximum_number_of_neighbors == 0 || neighbors_indices.size() < maximum_number_of_neighbors) {
+				complete_neighborhood_squared_radius = squared_radius;
+			} else if (!neighbors_squared_distances.empty()) {
+				complete_neighborhood_squared_radius = neighbors_squared_distances.back();
+			}
+		}
+
+		if (k > 0 && neighbors_indices.size() < (size_t)k) {
+			pcl::search::KdTree<PointT>::nearestKSearch(point, k, neighbors_indices, neighbors_squared_distances);
+			if (!neighbors_squared_distances.empty()) {
+				complete_neighborhood_squared_radius = std::max(complete_neighborhood_squared_radius, neighbors_squared_distances.back());
+			}
+		}
+
+		complete_neighborhood_squared_radius_[i] = complete_neighborhood_squared_radius;
+	}
+
+	neighbors_offsets_.resize(number_of_points + 1);
+	neighbors_offsets_[0] = 0;
+	for (size_t i = 0; i < number_of_points; ++i) {
+		neighbors_offsets_[i + 1] = neighbors_offsets_[i] + points_neighbors_indices[i].size();
+	}
+
+	neighbors_indices_.resize(neighbors_offsets_.back());
+	neighbors_squared_distances_.resize(neighbors_offsets_.back());
+
+	#pragma omp parallel for schedule(static) num_threads(parallel_utils::getNumberOfThreads(number_of_threads_))
+	for (int i = 0; i < (int)number_of_points; ++i) {
+		std::copy(points_neighbors_indices[i].begin(), points_neighbors_indices[i].end(), neighbors_indices_.begin() + neighbors_offsets_[i]);
+		std::copy(points_neighbors_squared_distances[i].begin(), points_neighbors_squared_distances[i].end(), neighbors_squared_distances_.begin() + neighbors_offsets_[i]);
+	}
+
+	cached_cloud_ = cloud.get();
+	cached_cloud_size_ = number_of_points;
+	cached_radius_ = radius;
+	cached_k_ = k;
+
+	ROS_DEBUG_STREAM("Neighborhood cache has " << neighbors_indices_.size() << " neighbors for " << number_of_points << " points (radius: " << radius << " | k: " << k << ")");
+	return true;
+}
+
+
+template<typename PointT>
+void NeighborhoodCacheKdTree<PointT>::clearNeighborhoodCache() {
+	cached_cloud_ = nullptr;
+	cached_cloud_size_ = 0;
+	cached_radius_ = 0.0;
+	cached_k_ = 0;
+	neighbors_offsets_.clear();
+	neighbors_indices_.clear();
+	neighbors_squared_distances_.clear();
+	complete_neighborhood_squared_radius_.clear();
+}
+
+
+template<typename PointT>
+bool NeighborhoodCacheKdTree<PointT>::isNeighborhoodCacheValid() const {
+	return cached_cloud_ && this->getInputCloud().get() == cached_cloud_ && cached_cloud_->size() == cached_cloud_size_ && !this->getIndices();
+}
+
+
+template<typename PointT>
+int NeighborhoodCacheKdTree<PointT>::radiusSearch(int index, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn) const {
+	if (getCachedNeighborsWithinRadius(index, radius, k_indices, k_sqr_distances, max_nn)) { return (int)k_indices.size(); }
+	recordCacheMiss(radius, 0);
+	return pcl::search::KdTree<PointT>::radiusSearch(index, radius, k_indices, k_sqr_distances, max_nn);
+}
+
+
+template<typename PointT>
+int NeighborhoodCacheKdTree<PointT>::radiusSearch(const PointCloud& cloud, int index, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn) const {
+	if (&cloud == this->getInputCloud().get()) {
+		if (getCachedNeighborsWithinRadius(index, radius, k_indices, k_sqr_distances, max_nn)) { return (int)k_indices.size(); }
+		recordCacheMiss(radius, 0);
+	}
+	return pcl::search::KdTree<PointT>::radiusSearch(cloud, index, radius, k_indices, k_sqr_distances, max_nn);
+}
+
+
+template<typename PointT>
+int NeighborhoodCacheKdTree<PointT>::nearestKSearch(int index, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const {
+	if (getCachedNearestNeighbors(index, k, k_indices, k_sqr_distances)) { return (int)k_indices.size(); }
+	recordCacheMiss(0.0, k);
+	return pcl::search::KdTree<PointT>::nearestKSearch(index, k, k_indices, k_sqr_distances);
+}
+
+
+template<typename PointT>
+int NeighborhoodCacheKdTree<PointT>::nearestKSearch(const PointCloud& cloud, int index, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const {
+	if (&cloud == this->getInputCloud().get()) {
+		if (getCachedNearestNeighbors(index, k, k_indices, k_sqr_distances)) { return (int)k_indices.size(); }
+		recordCacheMiss(0.0, k);
+	}
+	return pcl::search::KdTree<PointT>::nearestKSearch(cloud, index, k, k_indices, k_sqr_distances);
+}
+
+
+template<typename PointT>
+bool NeighborhoodCacheKdTree<PointT>::getCachedNeighborsWithinRadius(int index, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn) const {
+	if (!isNeighborhoodCacheValid() || index < 0 || (size_t)index >= cached_cloud_size_) { return false; }
+
+	float squared_radius = (float)(radius * radius);
+	if (radius <= 0.0 || squared_radius > complete_neighborhood_squared_radius_[index]) { return false; }
+
+	size_t neighbors_start = neighbors_offsets_[index];
+	std::vector<float>::const_iterator distances_begin = neighbors_squared_distances_.begin() + neighbors_start;
+	std::vector<float>::const_iterator distances_end = neighbors_squared_distances_.begin() + neighbors_offsets_[index + 1];
+	size_t number_of_neighbors = (size_t)(std::upper_bound(distances_begin, distances_end, squared_radius) - distances_begin); // lists are sorted by distance
+	if (max_nn > 0) { number_of_neighbors = std::min(number_of_neighbors, (size_t)max_nn); }
+
+	k_indices.assign(neighbors_indices_.begin() + neighbors_start, neighbors_indices_.begin() + neighbors_start + number_of_neighbors);
+	k_sqr_distances.assign(distances_begin, distances_begin + number_of_neighbors);
+	return true;
+}
+
+
+template<typename PointT>
+bool NeighborhoodCacheKdTree<PointT>::getCachedNearestNeighbors(int index, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const {
+	if (!isNeighborhoodCacheValid() || index < 0 || (size_t)index >= cached_cloud_size_ || k <= 0 || complete_neighborhood_squared_radius_[index] < 0.0f) { return false; }
+
+	size_t neighbors_start = neighbors_offsets_[index];
+	if (neighbors_offsets_[index + 1] - neighbors_start < (size_t)k) { return false; } // the first k of a list sorted by distance that is complete up to its last neighbor are the k nearest
+
+	k_indices.assign(neighbors_indices_.begin() + neighbors_start, neighbors_indices_.begin() + neighbors_start + k);
+	k_sqr_distances.assign(neighbors_squared_distances_.begin() + neighbors_start, neighbors_squared_distances_.begin() + neighbors_start + k);
+	return true;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NeighborhoodCacheKdTree-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+template<typename PointT>
+void NeighborhoodCacheKdTree<PointT>::recordCacheMiss(double radius, int k) const {
+	s_updateMaximum(largest_requested_radius_, radius);
+	s_updateMaximum(largest_requested_k_, k);
+	number_of_cache_misses_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+template<typename PointT>
+template<typename T>
+void NeighborhoodCacheKdTree<PointT>::s_updateMaximum(std::atomic<T>& maximum, T value) {
+	T current_maximum = maximum.load(std::memory_order_relaxed);
+	while (value > current_maximum && !maximum.compare_exchange_weak(current_maximum, value, std::memory_order_relaxed)) {} // only writes while the value is larger than the maximum
+}
+// =============================================================================   </protected-section>  =======================================================================
+
+} /* namespace dynamic_robot_localization */
@@ -62,6 +62,93 @@ bool fromROSMsg(const nav_msgs::OccupancyGrid& occupancy_grid, pcl::PointCloud<P
 }
 
 
+template<typename PointT>
+bool fromROSMsgWithGradientNormals(const nav_msgs::OccupancyGrid& occupancy_grid, pcl::PointCloud<PointT>& pointcloud, int threshold_for_map_cell_as_obstacle, int smoothing_radius, float unknown_cell_occupancy) {
+	if (!fromROSMsg(occupancy_grid, pointcloud, OccupancyGridValuesPtr(), threshold_for_map_cell_as_obstacle)) { return false; }
+
+	int map_width = (int)occupancy_grid.info.width;
+	int map_height = (int)occupancy_grid.info.height;
+	std::vector<int> occupied_cells;
+	occupied_cells.reserve(pointcloud.size());
+	for (size_t data_position = 0; data_position < occupancy_grid.data.size(); ++data_position) {
+		if (occupancy_grid.data[data_position] > threshold_for_map_cell_as_obstacle) {
+			occupied_cells.push_back((int)data_position); // same order as the points added by fromROSMsg
+		}
+	}
+	if (occupied_cells.size() != pointcloud.size()) { return false; }
+
+	// Sobel kernels convolved with the binomial smoothing kernel (computed only at the occupied cells instead of over the whole image)
+	if (smoothing_radius < 0) { smoothing_radius = 0; }
+	std::vector<float> binomial_kernel(1, 1.0f);
+	for (int i = 0; i < 2 * smoothing_radius; ++i) {
+		std::vector<float> next_binomial_kernel(binomial_kernel.size() + 1, 0.0f);
+		for (size_t j = 0; j < binomial_kernel.size(); ++j) {
+			next_binomial_kernel[j] += binomial_kernel[j] * 0.5f;
+			next_binomial_kernel[j + 1] += binomial_kernel[j] * 0.5f;
+		}
+		binomial_kernel.swap(next_binomial_kernel);
+	}
+
+	int kernel_radius = smoothing_radius + 1;
+	int kernel_size = 2 * kernel_radius + 1;
+	std::vector<float> gradient_x_kernel(kernel_size * kernel_size, 0.0f);
+	std::vector<float> gradient_y_kernel(kernel_size * kernel_size, 0.0f);
+	for (int sobel_dy = -1; sobel_dy <= 1; ++sobel_dy) {
+		for (int sobel_dx = -1; sobel_dx <= 1; ++sobel_dx) {
+			float sobel_x = (float)(sobel_dx * (2 - std::abs(sobel_dy)));
+			float sobel_y = (float)(sobel_dy * (2 - std::abs(sobel_dx)));
+			for (int smoothing_dy = -smoothing_radius; smoothing_dy <= smoothing_radius; ++smoothing_dy) {
+				for (int smoothing_dx = -smoothing_radius; smoothing_dx <= smoothing_radius; ++smoothing_dx) {
+					float smoothing_weight = binomial_kernel[smoothing_dy + smoothing_radius] * binomial_kernel[smoothing_dx + smoothing_radius];
+					int kernel_position = (sobel_dy + smoothing_dy + kernel_radius) * kernel_size + (sobel_dx + smoothing_dx + kernel_radius);
+					gradient_x_kernel[kernel_position] += sobel_x * smoothing_weight;
+					gradient_y_kernel[kernel_position] += sobel_y * smoothing_weight;
+				}
+			}
+		}
+	}
+
+	Eigen::Matrix3f grid_rotation = Eigen::Quaternionf(occupancy_grid.info.origin.orientation.w, occupancy_grid.info.origin.orientation.x, occupancy_grid.info.origin.orientation.y, occupancy_grid.info.origin.orientation.z).normalized().toRotationMatrix();
+	float nan = std::numeric_limits<float>::quiet_NaN();
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < (int)occupied_cells.size(); ++i) {
+		int cell_x = occupied_cells[i] % map_width;
+		int cell_y = occupied_cells[i] / map_width;
+		float gradient_x = 0.0f;
+		float gradient_y = 0.0f;
+		for (int dy = -kernel_radius; dy <= kernel_radius; ++dy) {
+			int y = std::min(std::max(cell_y + dy, 0), map_height - 1);
+			for (int dx = -kernel_radius; dx <= kernel_radius; ++dx) {
+				int x = std::min(std::max(cell_x + dx, 0), map_width - 1);
+				signed char cell_value = occupancy_grid.data[y * map_width + x];
+				float cell_occupancy = (cell_value < 0) ? unknown_cell_occupancy : std::min((float)cell_value, 100.0f) * 0.01f;
+				int kernel_position = (dy + kernel_radius) * kernel_size + (dx + kernel_radius);
+				gradient_x += gradient_x_kernel[kernel_position] * cell_occupancy;
+				gradient_y += gradient_y_kernel[kernel_position] * cell_occupancy;
+			}
+		}
+
+		PointT& point = pointcloud[i];
+		float gradient_norm = std::sqrt(gradient_x * gradient_x + gradient_y * gradient_y);
+		if (gradient_norm > 1e-6f) {
+			Eigen::Vector3f normal = grid_rotation * Eigen::Vector3f(-gradient_x / gradient_norm, -gradient_y / gradient_norm, 0.0f); // occupancy decreases towards free space
+			point.normal_x = normal(0);
+			point.normal_y = normal(1);
+			point.normal_z = normal(2);
+			point.curvature = 0.0f;
+		} else {
+			point.normal_x = nan;
+			point.normal_y = nan;
+			point.normal_z = nan;
+			point.curvature = nan;
+		}
+	}
+
+	return true;
+}
+
+
 template <typename PointT>
 bool publishPointCloud(pcl::PointCloud<PointT>& pointcloud, ros::Publisher& publisher, const std::string& frame_id, bool publish_pointcloud_only_if_there_is_subscribers, const std::string& point_cloud_name_for_logging) {
 	if (!publisher.getTopic().empty()) {
@@ -85,6 +85,25 @@ void removePointsOnSensorOrigin(pcl::PointCloud<PointT>& pointcloud) {
 }
 
 
+template <typename PointT>
+size_t invalidatePointsOnSensorOrigin(pcl::PointCloud<PointT>& pointcloud) {
+	size_t number_of_invalid_points = 0;
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	for (size_t i = 0; i < pointcloud.size(); ++i) {
+		if (pointcloud[i].x == pointcloud.sensor_origin_.x() && pointcloud[i].y == pointcloud.sensor_origin_.y() && pointcloud[i].z == pointcloud.sensor_origin_.z()) {
+			pointcloud[i].x = nan;
+			pointcloud[i].y = nan;
+			pointcloud[i].z = nan;
+			++number_of_invalid_points;
+		}
+	}
+	if (number_of_invalid_points > 0) {
+		pointcloud.is_dense = false;
+	}
+	return number_of_invalid_points;
+}
+
+
 template <typename PointT>
 void colorizePointCloudClusters(const pcl::PointCloud<PointT>& pointcloud, const std::vector<pcl::PointIndices>& cluster_indices, pcl::PointCloud<PointT>& pointcloud_colored_out) {
 	for (size_t cluster_index = 0; cluster_index < cluster_indices.size(); ++cluster_index) {
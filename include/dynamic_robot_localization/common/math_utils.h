@@ -11,6 +11,7 @@
 // std includes
 #include <cmath>
 #include <iomanip>
+#include <ostream>
 #include <string>
 #include <utility>
 
@@ -62,6 +63,40 @@ bool isTransformValid(const Eigen::Matrix<Scalar, 4, 4>& transform);
 template <typename Scalar>
 std::string convertTransformToString(const Eigen::Matrix<Scalar, 4, 4>& transform, const std::string& line_prefix = "\n\t\t[ ", const std::string& line_suffix = " ]",  const std::string& number_separator = " | ");
 
+/**
+ * \brief Keeps a reference to a transform and only formats it when inserted into a stream.
+ * Meant to be used directly inside the ROS_*_STREAM macros (which only evaluate their arguments when the log level is enabled), avoiding the formatting cost of disabled debug messages.
+ * The transform must outlive the formatter (it is not copied).
+ */
+template <typename Scalar>
+struct TransformFormatter {
+	TransformFormatter(const Eigen::Matrix<Scalar, 4, 4>& _transform, const char* _line_prefix, const char* _line_suffix, const char* _number_separator) :
+		transform(_transform), line_prefix(_line_prefix), line_suffix(_line_suffix), number_separator(_number_separator) {}
+
+	const Eigen::Matrix<Scalar, 4, 4>& transform;
+	const char* line_prefix;
+	const char* line_suffix;
+	const char* number_separator;
+};
+
+template <typename Scalar>
+inline TransformFormatter<Scalar> formatTransform(const Eigen::Matrix<Scalar, 4, 4>& transform, const char* line_prefix = "\n\t\t[ ", const char* line_suffix = " ]", const char* number_separator = " | ") {
+	return TransformFormatter<Scalar>(transform, line_prefix, line_suffix, number_separator);
+}
+
+template <typename Scalar>
+std::ostream& operator<<(std::ostream& os, const TransformFormatter<Scalar>& transform_formatter) {
+	for (int row = 0; row < 4; ++row) {
+		os << transform_formatter.line_prefix;
+		for (int col = 0; col < 4; ++col) {
+			if (col > 0) { os << transform_formatter.number_separator; }
+			os << std::setw(18) << transform_formatter.transform(row, col);
+		}
+		os << transform_formatter.line_suffix;
+	}
+	return os;
+}
+
 template <typename PairFirst, typename PairSecond>
 bool sortFunctionForPairSecondValueAscendingOrder(const std::pair<PairFirst, PairSecond> &left, const std::pair<PairFirst, PairSecond> &right) { return left.second < right.second; }
 
@@ -0,0 +1,126 @@
+#pragma once
+
+/**\file neighborhood_cache_kdtree.h
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
+
+// project includes
+#include <dynamic_robot_localization/common/parallel_utils.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// #########################################################################   NeighborhoodCacheKdTree   #######################################################################
+/**
+ * \brief Kd-tree that computes the neighbors of all the points of its input cloud in one parallel pass (at the largest radius / k requested by the consumers)
+ * and stores them sorted by distance in compressed sparse rows (offsets + indices + squared distances).
+ * The radius and k searches of points of the input cloud (used by the normal, curvature and keypoint estimators) are then answered by truncating the cached lists,
+ * and the searches outside the cached neighborhood fall back to the kd-tree and are recorded for sizing the cache of the next point cloud.
+ * The searches of points of other clouds (such as the keypoints given to the descriptor estimators, with the input cloud as surface) always use the kd-tree.
+ */
+template <typename PointT>
+class NeighborhoodCacheKdTree : public pcl::search::KdTree<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< NeighborhoodCacheKdTree<PointT> >;
+		using ConstPtr = std::shared_ptr< const NeighborhoodCacheKdTree<PointT> >;
+		using PointCloud = typename pcl::search::KdTree<PointT>::PointCloud;
+		using pcl::search::KdTree<PointT>::radiusSearch;
+		using pcl::search::KdTree<PointT>::nearestKSearch;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		NeighborhoodCacheKdTree() : pcl::search::KdTree<PointT>(true),
+			cached_cloud_(nullptr), cached_cloud_size_(0), cached_radius_(0.0), cached_k_(0),
+			maximum_number_of_neighbors_(0), number_of_threads_(0),
+			largest_requested_radius_(0.0), largest_requested_k_(0), number_of_cache_misses_(0) {}
+		virtual ~NeighborhoodCacheKdTree() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NeighborhoodCacheKdTree-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/**
+		 * Computes the neighbors of all the input cloud points within radius (extended to the k nearest neighbors for the points that have less than k neighbors within radius).
+		 * Must be called after setInputCloud (and again if the input cloud changes). Returns false if there is nothing to cache (radius <= 0 and k <= 0).
+		 */
+		bool buildNeighborhoodCache(double radius, int k);
+		void clearNeighborhoodCache();
+		bool isNeighborhoodCacheValid() const;
+
+		virtual int radiusSearch(int index, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn = 0) const;
+		virtual int radiusSearch(const PointCloud& cloud, int index, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn = 0) const;
+		virtual int nearestKSearch(int index, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const;
+		virtual int nearestKSearch(const PointCloud& cloud, int index, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const;
+
+		/** Copies the cached neighbors of the point with the given index within radius (truncated to max_nn if > 0) and returns false if they are not in the cache */
+		bool getCachedNeighborsWithinRadius(int index, double radius, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances, unsigned int max_nn = 0) const;
+		/** Copies the k nearest cached neighbors of the point with the given index and returns false if they are not in the cache */
+		bool getCachedNearestNeighbors(int index, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances) const;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NeighborhoodCacheKdTree-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		double getCachedRadius() const { return cached_radius_; }
+		int getCachedK() const { return cached_k_; }
+		size_t getNumberOfCachedNeighbors() const { return neighbors_indices_.size(); }
+		/** Largest radius / k of the searches that could not be answered by the cache (or that were set with setLargestRequestedNeighborhood) */
+		double getLargestRequestedRadius() const { return largest_requested_radius_.load(); }
+		int getLargestRequestedK() const { return largest_requested_k_.load(); }
+		size_t getNumberOfCacheMisses() const { return number_of_cache_misses_; }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		/** Limits the memory used by the cache in dense regions (<= 0 -> no limit) */
+		void setMaximumNumberOfNeighbors(int maximum_number_of_neighbors) { maximum_number_of_neighbors_ = maximum_number_of_neighbors; }
+		void setNumberOfThreads(int number_of_threads) { number_of_threads_ = number_of_threads; }
+		void setLargestRequestedNeighborhood(double radius, int k) { largest_requested_radius_.store(radius); largest_requested_k_.store(k); }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		/** Lock free, since the cache misses are recorded from inside the parallel loops of the estimators */
+		void recordCacheMiss(double radius, int k) const;
+		template <typename T>
+		static void s_updateMaximum(std::atomic<T>& maximum, T value);
+
+		const PointCloud* cached_cloud_;
+		size_t cached_cloud_size_;
+		double cached_radius_;
+		int cached_k_;
+		int maximum_number_of_neighbors_;
+		int number_of_threads_;
+
+		std::vector<size_t> neighbors_offsets_; // neighbors of point i are in [neighbors_offsets_[i], neighbors_offsets_[i + 1][
+		std::vector<int> neighbors_indices_;
+		std::vector<float> neighbors_squared_distances_;
+		std::vector<float> complete_neighborhood_squared_radius_; // all the neighbors of point i within this squared distance are in the cache
+
+		mutable std::atomic<double> largest_requested_radius_;
+		mutable std::atomic<int> largest_requested_k_;
+		mutable std::atomic<size_t> number_of_cache_misses_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/common/impl/neighborhood_cache_kdtree.hpp>
+#endif
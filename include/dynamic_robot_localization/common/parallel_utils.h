@@ -0,0 +1,81 @@
+#pragma once
+
+/**\file parallel_utils.h
+ * \brief Helpers for running OpenMP loops with deterministic reductions.
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// #############################################################################   parallel_utils   ############################################################################
+namespace parallel_utils {
+
+/**
+ * \brief Returns the number of threads to use in a parallel region (<= 0 -> number of processors available).
+ */
+inline int getNumberOfThreads(int number_of_threads) {
+#ifdef _OPENMP
+	return (number_of_threads > 0 ? number_of_threads : omp_get_num_procs());
+#else
+	return 1;
+#endif
+}
+
+
+/**
+ * \brief Returns the index of the thread running the caller inside a parallel region.
+ */
+inline int getThreadNumber() {
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * \brief Splits [0, number_of_elements[ in blocks of fixed size and calls block_function(block_start, block_end, block_accumulator) for each of them in parallel.
+ * The partial sums are then added in block order, which makes the result independent of the number of threads and of the scheduling.
+ */
+template <typename Accumulator, typename BlockFunction>
+Accumulator computeDeterministicBlockReduction(size_t number_of_elements, const Accumulator& zero, BlockFunction block_function, int number_of_threads = 0, size_t block_size = 1024) {
+	if (number_of_elements == 0) { return zero; }
+	if (block_size == 0) { block_size = 1024; }
+
+	int number_of_blocks = (int)((number_of_elements + block_size - 1) / block_size);
+	std::vector< Accumulator, Eigen::aligned_allocator<Accumulator> > partial_sums(number_of_blocks, zero);
+
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(getNumberOfThreads(number_of_threads))
+	for (int block = 0; block < number_of_blocks; ++block) {
+		size_t block_start = (size_t)block * block_size;
+		size_t block_end = std::min(block_start + block_size, number_of_elements);
+		block_function(block_start, block_end, partial_sums[block]);
+	}
+
+	Accumulator result = zero;
+	for (size_t i = 0; i < partial_sums.size(); ++i) {
+		result += partial_sums[i];
+	}
+	return result;
+}
+
+} /* namespace parallel_utils */
+} /* namespace dynamic_robot_localization */
@@ -9,8 +9,13 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 // ROS includes
 #include <ros/console.h>
@@ -55,6 +60,14 @@ using OccupancyGridValuesPtr = std::shared_ptr< OccupancyGridValues >;
 template <typename PointT>
 bool fromROSMsg(const nav_msgs::OccupancyGrid& occupancy_grid, pcl::PointCloud<PointT>& pointcloud, OccupancyGridValuesPtr occupancy_grid_values = OccupancyGridValuesPtr(), int threshold_for_map_cell_as_obstacle = 95);
 
+/**
+ * Converts the occupied cells into points (like fromROSMsg) with normals computed from the Sobel gradient of the occupancy image smoothed with a binomial kernel of the given radius (in cells).
+ * Occupancy is the cell probability (unknown cells use unknown_cell_occupancy), so the normals point to free space (or to unknown space when there is no free space nearby).
+ * Cells without gradient (inside thick obstacles) get NaN normals.
+ */
+template <typename PointT>
+bool fromROSMsgWithGradientNormals(const nav_msgs::OccupancyGrid& occupancy_grid, pcl::PointCloud<PointT>& pointcloud, int threshold_for_map_cell_as_obstacle = 95, int smoothing_radius = 1, float unknown_cell_occupancy = 0.5f);
+
 template <typename PointT>
 bool publishPointCloud(pcl::PointCloud<PointT>& pointcloud, ros::Publisher& publisher, const std::string& frame_id, bool publish_pointcloud_only_if_there_is_subscribers, const std::string& point_cloud_name_for_logging);
 
@@ -37,6 +37,10 @@ void colorizePointCloudWithCurvature(pcl::PointCloud<PointT>& pointcloud);
 template <typename PointT>
 void removePointsOnSensorOrigin(pcl::PointCloud<PointT>& pointcloud);
 
+/** Sets the points on the sensor origin to NaN (keeping the layout of organized point clouds) and returns the number of invalidated points */
+template <typename PointT>
+size_t invalidatePointsOnSensorOrigin(pcl::PointCloud<PointT>& pointcloud);
+
 template <typename PointT>
 void colorizePointCloudClusters(const pcl::PointCloud<PointT>& pointcloud, const std::vector<pcl::PointIndices>& cluster_indices, pcl::PointCloud<PointT>& pointcloud_colored_out);
 
@@ -9,11 +9,14 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <algorithm>
 #include <cmath>
+#include <deque>
 #include <iomanip>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 // ROS includes
 #include <ros/ros.h>
@@ -31,6 +34,8 @@ namespace dynamic_robot_localization {
 // ##################################################################   DefaultConvergenceCriteriaWithTime   ###################################################################
 /**
  * \brief Description...
+ * Besides the pcl::registration::DefaultConvergenceCriteria checks, it can stop the registration when the correspondences MSE stalls (or oscillates) over a sliding window of iterations
+ * and can record the telemetry of the last iterations in a fixed size ring buffer.
  */
 template <typename Scalar = float>
 class DefaultConvergenceCriteriaWithTime : public pcl::registration::DefaultConvergenceCriteria<Scalar> {
@@ -43,17 +48,30 @@ class DefaultConvergenceCriteriaWithTime : public pcl::registration::DefaultConv
 
 		using pcl::registration::DefaultConvergenceCriteria<Scalar>::transformation_;
 
+		struct IterationTelemetry {
+			int iteration;
+			double elapsed_time;
+			double correspondences_mean_square_error;
+			double translation_delta;
+			double rotation_delta;
+			size_t number_of_correspondences;
+		};
+
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		DefaultConvergenceCriteriaWithTime(const int &iterations, const typename pcl::registration::DefaultConvergenceCriteria<Scalar>::Matrix4 &transform,
 				const pcl::Correspondences &correspondences, double convergence_time_limit_seconds = 3.0) :
 			pcl::registration::DefaultConvergenceCriteria<Scalar>(iterations, transform, correspondences),
-			convergence_time_limit_seconds_(convergence_time_limit_seconds), convergence_state_time_limit_reached_(false), convergence_rotation_threshold_(-1337.0) {}
+			convergence_time_limit_seconds_(convergence_time_limit_seconds), convergence_state_time_limit_reached_(false), convergence_rotation_threshold_(-1337.0),
+			convergence_stall_window_size_(0), convergence_stall_relative_mse_improvement_threshold_(0.001), convergence_state_stall_detected_(false), convergence_state_oscillation_detected_(false),
+			best_mean_square_error_(std::numeric_limits<double>::max()), number_of_iterations_without_mse_improvement_(0), last_recorded_iteration_(0),
+			telemetry_buffer_size_(0), telemetry_buffer_next_index_(0), telemetry_buffer_number_of_elements_(0) {}
 		virtual ~DefaultConvergenceCriteriaWithTime() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <DefaultConvergenceCriteriaWithTime-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		virtual bool hasConverged();
 		virtual void resetConvergenceTimer();
+		void resetIterationsHistory();
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </DefaultConvergenceCriteriaWithTime-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -62,22 +80,46 @@ class DefaultConvergenceCriteriaWithTime : public pcl::registration::DefaultConv
 		std::string getConvergenceStateString();
 		inline int getNumberOfRegistrationIterations() { return pcl::registration::DefaultConvergenceCriteria<Scalar>::iterations_; }
 		double getRootMeanSquareErrorOfRegistrationCorrespondences();
+		/** RMSE of the correspondences used in the last iteration (all within the max correspondence distance), or max double if there are none */
+		double getRootMeanSquareErrorOfLastCorrespondences();
 		int getNumberCorrespondences();
 		inline double getConvergenceRotationThreshold() const { return convergence_rotation_threshold_; }
+		inline int getConvergenceStallWindowSize() const { return convergence_stall_window_size_; }
+		inline double getConvergenceStallRelativeMSEImprovementThreshold() const { return convergence_stall_relative_mse_improvement_threshold_; }
+		inline size_t getTelemetryBufferSize() const { return telemetry_buffer_size_; }
+		void getIterationsTelemetry(std::vector<IterationTelemetry>& iterations_telemetry_out) const; // ordered from oldest to newest
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		inline void setConvergenceTimeLimitSeconds(double convergence_time_limit_seconds) { convergence_time_limit_seconds_ = convergence_time_limit_seconds; }
 		inline void setConvergenceRotationThreshold(double convergenceRotationThreshold) { convergence_rotation_threshold_ = convergenceRotationThreshold; }
+		inline void setConvergenceStallWindowSize(int convergence_stall_window_size) { convergence_stall_window_size_ = convergence_stall_window_size; }
+		inline void setConvergenceStallRelativeMSEImprovementThreshold(double threshold) { convergence_stall_relative_mse_improvement_threshold_ = threshold; }
+		void setTelemetryBufferSize(size_t telemetry_buffer_size);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 	// ========================================================================   </public-section>  ===========================================================================
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
+		bool isRegistrationStalled(double mean_square_error);
+		void recordIterationTelemetry(double mean_square_error, double elapsed_time);
+
 		PerformanceTimer convergence_timer_;
 		double convergence_time_limit_seconds_;
 		bool convergence_state_time_limit_reached_;
 		double convergence_rotation_threshold_;
+		int convergence_stall_window_size_;
+		double convergence_stall_relative_mse_improvement_threshold_;
+		bool convergence_state_stall_detected_;
+		bool convergence_state_oscillation_detected_;
+		std::deque<double> stall_window_mean_square_errors_;
+		double best_mean_square_error_;
+		int number_of_iterations_without_mse_improvement_;
+		int last_recorded_iteration_;
+		std::vector<IterationTelemetry> telemetry_buffer_;
+		size_t telemetry_buffer_size_;
+		size_t telemetry_buffer_next_index_;
+		size_t telemetry_buffer_number_of_elements_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -23,6 +23,18 @@ template<typename Scalar>
 bool DefaultConvergenceCriteriaWithTime<Scalar>::hasConverged() {
 	double elapsed_time = convergence_timer_.getElapsedTimeInSec();
 	convergence_state_time_limit_reached_ = false;
+	convergence_state_stall_detected_ = false;
+	convergence_state_oscillation_detected_ = false;
+
+	int iteration = pcl::registration::DefaultConvergenceCriteria<Scalar>::iterations_;
+	if (iteration <= last_recorded_iteration_) { resetIterationsHistory(); } // new registration
+	last_recorded_iteration_ = iteration;
+
+	double mean_square_error = -1.0;
+	if ((telemetry_buffer_size_ > 0 || convergence_stall_window_size_ > 0) && !pcl::registration::DefaultConvergenceCriteria<Scalar>::correspondences_.empty()) {
+		mean_square_error = pcl::registration::DefaultConvergenceCriteria<Scalar>::calculateMSE(pcl::registration::DefaultConvergenceCriteria<Scalar>::correspondences_);
+	}
+	recordIterationTelemetry(mean_square_error, elapsed_time);
 	if (convergence_time_limit_seconds_ >= 0.0 && elapsed_time > convergence_time_limit_seconds_) {
 		ROS_WARN_STREAM("[DefaultConvergenceCriteriaWithTime::hasConverged] Convergence time limit of " << convergence_time_limit_seconds_ << " seconds exceeded (elapsed time: " << elapsed_time << ")" \
 				<< " | Iteration: " << pcl::registration::DefaultConvergenceCriteria<Scalar>::iterations_ \
@@ -34,7 +46,6 @@ bool DefaultConvergenceCriteriaWithTime<Scalar>::hasConverged() {
 	} else {
 		if (convergence_rotation_threshold_ > 0.0) { pcl::registration::DefaultConvergenceCriteria<Scalar>::setRotationThreshold(convergence_rotation_threshold_); }
 		bool converged = pcl::registration::DefaultConvergenceCriteria<Scalar>::hasConverged();
-		std::string transform_str = math_utils::convertTransformToString(transformation_);
 		ROS_DEBUG_STREAM("[DefaultConvergenceCriteriaWithTime::hasConverged]:" \
 				<< "\n\t Convergence state: " << getConvergenceStateString() \
 				<< "\n\t Current convergence time: " << elapsed_time \
@@ -42,13 +53,20 @@ bool DefaultConvergenceCriteriaWithTime<Scalar>::hasConverged() {
 				<< "\n\t Iteration: " << pcl::registration::DefaultConvergenceCriteria<Scalar>::iterations_ \
 				<< "\n\t CorrespondencesCurrentMeanSquareError: " << pcl::registration::DefaultConvergenceCriteria<Scalar>::correspondences_cur_mse_ \
 				<< "\n\t Current convergence transformation is:" \
-				<< transform_str << "\n");
+				<< math_utils::formatTransform(transformation_) << "\n");
 
 		if (!math_utils::isTransformValid<Scalar>(transformation_)) {
 			ROS_WARN("[DefaultConvergenceCriteriaWithTime::hasConverged] Rejected estimated transformation with NaN values!");
 			return true; // a transform with NaNs will cause a crash because of kd-tree search
 		}
 
+		if (!converged && isRegistrationStalled(mean_square_error)) {
+			ROS_DEBUG_STREAM("[DefaultConvergenceCriteriaWithTime::hasConverged] Stopping registration at iteration " << iteration << " because the correspondences MSE did not improve more than " \
+					<< (convergence_stall_relative_mse_improvement_threshold_ * 100.0) << "% in the last " << convergence_stall_window_size_ << " iterations (" << getConvergenceStateString() << ")");
+			pcl::registration::DefaultConvergenceCriteria<Scalar>::convergence_state_ = pcl::registration::DefaultConvergenceCriteria<Scalar>::CONVERGENCE_CRITERIA_REL_MSE;
+			return true;
+		}
+
 		return converged;
 	}
 }
@@ -60,9 +78,43 @@ void DefaultConvergenceCriteriaWithTime<Scalar>::resetConvergenceTimer() {
 }
 
 
+template<typename Scalar>
+void DefaultConvergenceCriteriaWithTime<Scalar>::resetIterationsHistory() {
+	stall_window_mean_square_errors_.clear();
+	best_mean_square_error_ = std::numeric_limits<double>::max();
+	number_of_iterations_without_mse_improvement_ = 0;
+	last_recorded_iteration_ = 0;
+	telemetry_buffer_next_index_ = 0;
+	telemetry_buffer_number_of_elements_ = 0;
+}
+
+
+template<typename Scalar>
+void DefaultConvergenceCriteriaWithTime<Scalar>::setTelemetryBufferSize(size_t telemetry_buffer_size) {
+	telemetry_buffer_size_ = telemetry_buffer_size;
+	telemetry_buffer_.resize(telemetry_buffer_size);
+	telemetry_buffer_next_index_ = 0;
+	telemetry_buffer_number_of_elements_ = 0;
+}
+
+
+template<typename Scalar>
+void DefaultConvergenceCriteriaWithTime<Scalar>::getIterationsTelemetry(std::vector<IterationTelemetry>& iterations_telemetry_out) const {
+	iterations_telemetry_out.clear();
+	if (telemetry_buffer_size_ == 0) { return; }
+	iterations_telemetry_out.reserve(telemetry_buffer_number_of_elements_);
+	size_t oldest_index = (telemetry_buffer_next_index_ + telemetry_buffer_size_ - telemetry_buffer_number_of_elements_) % telemetry_buffer_size_;
+	for (size_t i = 0; i < telemetry_buffer_number_of_elements_; ++i) {
+		iterations_telemetry_out.push_back(telemetry_buffer_[(oldest_index + i) % telemetry_buffer_size_]);
+	}
+}
+
+
 template<typename Scalar>
 std::string DefaultConvergenceCriteriaWithTime<Scalar>::getConvergenceStateString() {
 	if (convergence_state_time_limit_reached_) { return "CONVERGENCE_CRITERIA_TIME_LIMIT"; }
+	if (convergence_state_oscillation_detected_) { return "CONVERGENCE_CRITERIA_MSE_OSCILLATION"; }
+	if (convergence_state_stall_detected_) { return "CONVERGENCE_CRITERIA_MSE_STALL"; }
 	typename pcl::registration::DefaultConvergenceCriteria<Scalar>::ConvergenceState convergence_state = pcl::registration::DefaultConvergenceCriteria<Scalar>::getConvergenceState();
 	switch (convergence_state) {
 		case pcl::registration::DefaultConvergenceCriteria<Scalar>::CONVERGENCE_CRITERIA_NOT_CONVERGED: 		{ return "CONVERGENCE_CRITERIA_NOT_CONVERGED"; 		break; }
@@ -86,6 +138,12 @@ double DefaultConvergenceCriteriaWithTime<Scalar>::getRootMeanSquareErrorOfRegis
 	}
 }
 
+template<typename Scalar>
+double DefaultConvergenceCriteriaWithTime<Scalar>::getRootMeanSquareErrorOfLastCorrespondences() {
+	if (pcl::registration::DefaultConvergenceCriteria<Scalar>::correspondences_.empty()) { return std::numeric_limits<double>::max(); }
+	return std::sqrt(pcl::registration::DefaultConvergenceCriteria<Scalar>::calculateMSE(pcl::registration::DefaultConvergenceCriteria<Scalar>::correspondences_));
+}
+
 template<typename Scalar>
 int DefaultConvergenceCriteriaWithTime<Scalar>::getNumberCorrespondences() {
 	return pcl::registration::DefaultConvergenceCriteria<Scalar>::correspondences_.size();
@@ -94,6 +152,60 @@ int DefaultConvergenceCriteriaWithTime<Scalar>::getNumberCorrespondences() {
 // =============================================================================  </public-section>  ===========================================================================
 
 // =============================================================================   <protected-section>   =======================================================================
+template<typename Scalar>
+bool DefaultConvergenceCriteriaWithTime<Scalar>::isRegistrationStalled(double mean_square_error) {
+	if (convergence_stall_window_size_ <= 0 || !(mean_square_error >= 0.0) || !std::isfinite(mean_square_error)) { return false; }
+
+	stall_window_mean_square_errors_.push_back(mean_square_error);
+	while (stall_window_mean_square_errors_.size() > (size_t)convergence_stall_window_size_) {
+		stall_window_mean_square_errors_.pop_front();
+	}
+
+	if (mean_square_error < best_mean_square_error_ * (1.0 - convergence_stall_relative_mse_improvement_threshold_)) {
+		best_mean_square_error_ = mean_square_error;
+		number_of_iterations_without_mse_improvement_ = 0;
+		return false;
+	}
+
+	if (++number_of_iterations_without_mse_improvement_ < convergence_stall_window_size_) { return false; }
+
+	// an oscillating MSE changes direction in most iterations, while a plateau decreases slowly (or stays constant)
+	int number_of_direction_changes = 0;
+	int number_of_possible_direction_changes = (int)stall_window_mean_square_errors_.size() - 2;
+	double previous_difference = 0.0;
+	for (size_t i = 1; i < stall_window_mean_square_errors_.size(); ++i) {
+		double difference = stall_window_mean_square_errors_[i] - stall_window_mean_square_errors_[i - 1];
+		if (difference * previous_difference < 0.0) { ++number_of_direction_changes; }
+		if (difference != 0.0) { previous_difference = difference; }
+	}
+
+	if (number_of_possible_direction_changes > 0 && number_of_direction_changes * 2 >= number_of_possible_direction_changes) {
+		convergence_state_oscillation_detected_ = true;
+	} else {
+		convergence_state_stall_detected_ = true;
+	}
+	return true;
+}
+
+
+template<typename Scalar>
+void DefaultConvergenceCriteriaWithTime<Scalar>::recordIterationTelemetry(double mean_square_error, double elapsed_time) {
+	if (telemetry_buffer_size_ == 0) { return; }
+
+	double rotation_cos_angle = 0.5 * ((double)transformation_.coeff(0, 0) + (double)transformation_.coeff(1, 1) + (double)transformation_.coeff(2, 2) - 1.0);
+	rotation_cos_angle = std::max(-1.0, std::min(1.0, rotation_cos_angle));
+
+	IterationTelemetry& iteration_telemetry = telemetry_buffer_[telemetry_buffer_next_index_];
+	iteration_telemetry.iteration = pcl::registration::DefaultConvergenceCriteria<Scalar>::iterations_;
+	iteration_telemetry.elapsed_time = elapsed_time;
+	iteration_telemetry.correspondences_mean_square_error = mean_square_error;
+	iteration_telemetry.translation_delta = transformation_.template block<3, 1>(0, 3).norm();
+	iteration_telemetry.rotation_delta = std::acos(rotation_cos_angle);
+	iteration_telemetry.number_of_correspondences = pcl::registration::DefaultConvergenceCriteria<Scalar>::correspondences_.size();
+
+	telemetry_buffer_next_index_ = (telemetry_buffer_next_index_ + 1) % telemetry_buffer_size_;
+	if (telemetry_buffer_number_of_elements_ < telemetry_buffer_size_) { ++telemetry_buffer_number_of_elements_; }
+}
 // =============================================================================   </protected-section>  =======================================================================
 
 // =============================================================================   <private-section>   =========================================================================
@@ -21,16 +21,9 @@ namespace dynamic_robot_localization {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PrincipalCurvaturesEstimation-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
 void PrincipalCurvaturesEstimation<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
-	int search_k;
-	private_node_handle->param(configuration_namespace + "search_k", search_k, 0);
-	curvature_estimator_.setKSearch(search_k);
-
-	if (search_k <= 0) {
-		double search_radius;
-		private_node_handle->param(configuration_namespace + "search_radius", search_radius, 0.12);
-		curvature_estimator_.setRadiusSearch(search_radius);
-	}
-
+	private_node_handle->param(configuration_namespace + "search_k", search_k_, 0);
+	private_node_handle->param(configuration_namespace + "search_radius", search_radius_, 0.12);
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
 	private_node_handle->param(configuration_namespace + "update_normals_with_principal_component_directions", update_normals_with_principal_component_directions_, false);
 
 	std::string upsample_method_str;
@@ -45,31 +38,88 @@ void PrincipalCurvaturesEstimation<PointT>::setupConfigurationFromParameterServe
 
 template<typename PointT>
 void PrincipalCurvaturesEstimation<PointT>::estimatePointsCurvature(typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::search::KdTree<PointT>::Ptr& search_method) {
-	curvature_estimator_.setSearchMethod(search_method);
-	curvature_estimator_.setInputCloud(pointcloud);
-	curvature_estimator_.setInputNormals(pointcloud);
-
-	pcl::PointCloud<pcl::PrincipalCurvatures> principal_curvatures;
-	curvature_estimator_.compute(principal_curvatures);
-
-	for (size_t i = 0; (i < pointcloud->size()) && (i < principal_curvatures.size()); ++i) {
-		if (curvature_type_ == CURVATURE_TYPE_GAUSSIAN) {
-			(*pointcloud)[i].curvature = principal_curvatures[i].pc1 * principal_curvatures[i].pc2;
-		} else {
-			(*pointcloud)[i].curvature = (principal_curvatures[i].pc1 + principal_curvatures[i].pc2) * 0.5;
+	if (!search_method->getInputCloud() || search_method->getInputCloud().get() != pointcloud.get()) {
+		search_method->setInputCloud(pointcloud);
+	}
+
+	int number_of_threads = parallel_utils::getNumberOfThreads(number_of_threads_);
+	float nan = std::numeric_limits<float>::quiet_NaN();
+	std::vector< Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > principal_directions;
+	if (update_normals_with_principal_component_directions_) {
+		principal_directions.resize(pointcloud->size(), Eigen::Vector3f::Constant(nan)); // the normals are only updated after all the points are processed (they are the input of the neighbors)
+	}
+
+	#pragma omp parallel num_threads(number_of_threads)
+	{
+		std::vector<int> neighbors_indices;
+		std::vector<float> neighbors_squared_distances;
+
+		#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < (int)pointcloud->size(); ++i) {
+			PointT& point = (*pointcloud)[i];
+			Eigen::Vector3f principal_direction;
+			float pc1, pc2;
+
+			bool valid_curvature = pcl::isFinite(point) &&
+					((search_k_ > 0 ? search_method->nearestKSearch(i, search_k_, neighbors_indices, neighbors_squared_distances) : search_method->radiusSearch(i, search_radius_, neighbors_indices, neighbors_squared_distances)) > 0) &&
+					computePointPrincipalCurvatures(*pointcloud, (size_t)i, neighbors_indices, principal_direction, pc1, pc2);
+
+			if (valid_curvature) {
+				point.curvature = (curvature_type_ == CURVATURE_TYPE_GAUSSIAN) ? (pc1 * pc2) : ((pc1 + pc2) * 0.5f);
+				if (update_normals_with_principal_component_directions_) { principal_directions[i] = principal_direction; }
+			} else {
+				point.curvature = nan;
+			}
 		}
+	}
 
-		if (update_normals_with_principal_component_directions_) {
-			(*pointcloud)[i].normal_x = principal_curvatures[i].principal_curvature_x;
-			(*pointcloud)[i].normal_y = principal_curvatures[i].principal_curvature_y;
-			(*pointcloud)[i].normal_z = principal_curvatures[i].principal_curvature_z;
+	if (update_normals_with_principal_component_directions_) {
+		for (size_t i = 0; i < pointcloud->size(); ++i) {
+			(*pointcloud)[i].normal_x = principal_directions[i](0);
+			(*pointcloud)[i].normal_y = principal_directions[i](1);
+			(*pointcloud)[i].normal_z = principal_directions[i](2);
 		}
 	}
 
-	ROS_DEBUG_STREAM("PrincipalCurvaturesEstimation computed curvature information for a point cloud with " << pointcloud->size() << " points");
+	ROS_DEBUG_STREAM("PrincipalCurvaturesEstimation computed curvature information for a point cloud with " << pointcloud->size() << " points using " << number_of_threads << " threads");
 
 	CurvatureEstimator<PointT>::estimatePointsCurvature(pointcloud, search_method);
 }
+
+template<typename PointT>
+bool PrincipalCurvaturesEstimation<PointT>::computePointPrincipalCurvatures(const pcl::PointCloud<PointT>& pointcloud, size_t point_index, const std::vector<int>& neighbors_indices,
+		Eigen::Vector3f& principal_direction_out, float& pc1_out, float& pc2_out) {
+	const PointT& point = pointcloud[point_index];
+	Eigen::Vector3f point_normal(point.normal_x, point.normal_y, point.normal_z);
+	if (neighbors_indices.empty() || !point_normal.allFinite()) { return false; }
+
+	Eigen::Matrix3f tangent_plane_projection = Eigen::Matrix3f::Identity() - point_normal * point_normal.transpose();
+
+	// two passes (centroid and then covariance) like pcl::PrincipalCurvaturesEstimation, without storing the projected normals
+	Eigen::Vector3f projected_normals_centroid = Eigen::Vector3f::Zero();
+	for (size_t i = 0; i < neighbors_indices.size(); ++i) {
+		const PointT& neighbor = pointcloud[neighbors_indices[i]];
+		projected_normals_centroid += tangent_plane_projection * Eigen::Vector3f(neighbor.normal_x, neighbor.normal_y, neighbor.normal_z);
+	}
+	float inverse_number_of_neighbors = 1.0f / (float)neighbors_indices.size();
+	projected_normals_centroid *= inverse_number_of_neighbors;
+
+	Eigen::Matrix3f covariance_matrix = Eigen::Matrix3f::Zero();
+	for (size_t i = 0; i < neighbors_indices.size(); ++i) {
+		const PointT& neighbor = pointcloud[neighbors_indices[i]];
+		Eigen::Vector3f demeaned_projected_normal = tangent_plane_projection * Eigen::Vector3f(neighbor.normal_x, neighbor.normal_y, neighbor.normal_z) - projected_normals_centroid;
+		covariance_matrix.noalias() += demeaned_projected_normal * demeaned_projected_normal.transpose();
+	}
+	if (!covariance_matrix.allFinite()) { return false; }
+
+	Eigen::Vector3f eigenvalues;
+	pcl::eigen33(covariance_matrix, eigenvalues);
+	pcl::computeCorrespondingEigenVector(covariance_matrix, eigenvalues(2), principal_direction_out);
+
+	pc1_out = eigenvalues(2) * inverse_number_of_neighbors;
+	pc2_out = eigenvalues(1) * inverse_number_of_neighbors;
+	return true;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PrincipalCurvaturesEstimation-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
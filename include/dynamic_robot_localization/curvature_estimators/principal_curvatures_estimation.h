@@ -13,6 +13,8 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,16 +25,24 @@
 // PCL includes
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
-#include <pcl/features/principal_curvatures.h>
+#include <pcl/common/eigen.h>
+#include <pcl/search/kdtree.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/StdVector>
 
 // project includes
+#include <dynamic_robot_localization/common/parallel_utils.h>
 #include <dynamic_robot_localization/curvature_estimators/curvature_estimator.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
 // #####################################################################   PrincipalCurvaturesEstimation   #####################################################################
 /**
- * \brief Description...
+ * \brief Estimates the principal curvatures from the covariance of the neighbors normals projected into the tangent plane of each point (same method as pcl::PrincipalCurvaturesEstimation).
+ * The points are processed in parallel and the curvature (and optionally the principal direction) is written directly in the point cloud, using the neighbors of the given search method
+ * (which can be a NeighborhoodCacheKdTree shared with the normal estimator).
  */
 template <typename PointT>
 class PrincipalCurvaturesEstimation : public CurvatureEstimator<PointT> {
@@ -54,13 +64,17 @@ class PrincipalCurvaturesEstimation : public CurvatureEstimator<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constants>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-		PrincipalCurvaturesEstimation() : curvature_type_(CURVATURE_TYPE_MEAN), update_normals_with_principal_component_directions_(false) {}
+		PrincipalCurvaturesEstimation() : search_k_(0), search_radius_(0.12), number_of_threads_(0), curvature_type_(CURVATURE_TYPE_MEAN), update_normals_with_principal_component_directions_(false) {}
 		virtual ~PrincipalCurvaturesEstimation() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <PrincipalCurvaturesEstimation-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
 		virtual void estimatePointsCurvature(typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::search::KdTree<PointT>::Ptr& search_method);
+
+		/** Returns false if the normals of the neighbors are not enough to estimate the principal curvatures (principal_direction_out (unit), pc1_out >= pc2_out) */
+		static bool computePointPrincipalCurvatures(const pcl::PointCloud<PointT>& pointcloud, size_t point_index, const std::vector<int>& neighbors_indices,
+				Eigen::Vector3f& principal_direction_out, float& pc1_out, float& pc2_out);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PrincipalCurvaturesEstimation-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -72,7 +86,9 @@ class PrincipalCurvaturesEstimation : public CurvatureEstimator<PointT> {
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
-		pcl::PrincipalCurvaturesEstimation<PointT, PointT> curvature_estimator_;
+		int search_k_;
+		double search_radius_;
+		int number_of_threads_;
 		CurvatureType curvature_type_;
 		bool update_normals_with_principal_component_directions_;
 	// ========================================================================   </protected-section>  ========================================================================
@@ -25,10 +25,14 @@ Localization<PointT>::Localization() :
 	reference_pointcloud_normalize_normals_(true),
 	ambient_pointcloud_normalize_normals_(false),
 	flip_normals_using_occupancy_grid_analysis_(true),
+	compute_reference_normals_from_occupancy_grid_gradients_(false),
+	occupancy_grid_gradients_smoothing_radius_(1),
+	occupancy_grid_gradients_unknown_cell_occupancy_(0.5),
 	map_update_mode_(NoIntegration),
 	use_incremental_map_update_(false),
 	override_pointcloud_timestamp_to_current_time_(false),
 	remove_points_in_sensor_origin_(false),
+	keep_ambient_pointcloud_organized_(false),
 	minimum_number_of_points_in_ambient_pointcloud_(10),
 	minimum_number_of_points_in_reference_pointcloud_(10),
 	localization_detailed_use_millimeters_in_root_mean_square_error_inliers_(false),
@@ -46,6 +50,14 @@ Localization<PointT>::Localization() :
 	compute_normals_when_tracking_pose_(false),
 	compute_normals_when_recovering_pose_tracking_(false),
 	compute_normals_when_estimating_initial_pose_(true),
+	circular_buffer_incremental_normal_estimation_(false),
+	circular_buffer_incremental_normal_estimation_seam_radius_(0.12),
+	ambient_pointcloud_use_neighborhood_cache_(false),
+	ambient_pointcloud_neighborhood_cache_radius_(0.0),
+	ambient_pointcloud_neighborhood_cache_maximum_radius_(0.5),
+	ambient_pointcloud_neighborhood_cache_k_(0),
+	ambient_pointcloud_neighborhood_cache_maximum_number_of_neighbors_(0),
+	ambient_pointcloud_neighborhood_cache_number_of_threads_(0),
 	compute_keypoints_when_tracking_pose_(false),
 	compute_keypoints_when_recovering_pose_tracking_(false),
 	compute_keypoints_when_estimating_initial_pose_(true),
@@ -482,6 +494,7 @@ void Localization<PointT>::setupMessageManagementFromParameterServer(const std::
 	min_seconds_between_reference_pointcloud_update_.fromSec(min_seconds_between_reference_pointcloud_update);
 
 	private_node_handle_->param(configuration_namespace + "message_management/remove_points_in_sensor_origin", remove_points_in_sensor_origin_, false);
+	private_node_handle_->param(configuration_namespace + "message_management/keep_ambient_pointcloud_organized", keep_ambient_pointcloud_organized_, false);
 
 	private_node_handle_->param(configuration_namespace + "message_management/minimum_number_of_points_in_ambient_pointcloud", minimum_number_of_points_in_ambient_pointcloud_, 10);
 
@@ -649,7 +662,18 @@ void Localization<PointT>::setupNormalEstimatorsFromParameterServer(const std::s
 	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/compute_normals_when_estimating_initial_pose", compute_normals_when_estimating_initial_pose_, true);
 	private_node_handle_->param(configuration_namespace + "normal_estimators/reference_pointcloud/use_filtered_cloud_as_normal_estimation_surface", use_filtered_cloud_as_normal_estimation_surface_reference_, false);
 	private_node_handle_->param(configuration_namespace + "normal_estimators/reference_pointcloud/flip_normals_using_occupancy_grid_analysis", flip_normals_using_occupancy_grid_analysis_, true);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/reference_pointcloud/compute_normals_from_occupancy_grid_gradients", compute_reference_normals_from_occupancy_grid_gradients_, false);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/reference_pointcloud/occupancy_grid_gradients_smoothing_radius", occupancy_grid_gradients_smoothing_radius_, 1);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/reference_pointcloud/occupancy_grid_gradients_unknown_cell_occupancy", occupancy_grid_gradients_unknown_cell_occupancy_, 0.5);
 	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/use_filtered_cloud_as_normal_estimation_surface", use_filtered_cloud_as_normal_estimation_surface_ambient_, false);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/circular_buffer_incremental_normal_estimation", circular_buffer_incremental_normal_estimation_, false);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/circular_buffer_incremental_normal_estimation_seam_radius", circular_buffer_incremental_normal_estimation_seam_radius_, 0.12);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/neighborhood_cache/use_neighborhood_cache", ambient_pointcloud_use_neighborhood_cache_, false);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/neighborhood_cache/radius", ambient_pointcloud_neighborhood_cache_radius_, 0.0);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/neighborhood_cache/maximum_radius", ambient_pointcloud_neighborhood_cache_maximum_radius_, 0.5);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/neighborhood_cache/k", ambient_pointcloud_neighborhood_cache_k_, 0);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/neighborhood_cache/maximum_number_of_neighbors", ambient_pointcloud_neighborhood_cache_maximum_number_of_neighbors_, 0);
+	private_node_handle_->param(configuration_namespace + "normal_estimators/ambient_pointcloud/neighborhood_cache/number_of_threads", ambient_pointcloud_neighborhood_cache_number_of_threads_, 0);
 	setupNormalEstimatorFromParameterServer(reference_cloud_normal_estimator_, "normal_estimators/reference_pointcloud/");
 	setupNormalEstimatorFromParameterServer(ambient_cloud_normal_estimator_, "normal_estimators/ambient_pointcloud/");
 }
@@ -671,6 +695,8 @@ void Localization<PointT>::s_setupNormalEstimatorFromParameterServer(typename No
 			std::string estimator_name = it->first;
 			if (estimator_name.find("normal_estimator_sac") != std::string::npos) {
 				normal_estimator = typename NormalEstimator<PointT>::Ptr(new NormalEstimatorSAC<PointT>());
+			} else if (estimator_name.find("integral_image_normal_estimation") != std::string::npos) {
+				normal_estimator = typename NormalEstimator<PointT>::Ptr(new IntegralImageNormalEstimation<PointT>());
 			} else if (estimator_name.find("normal_estimation_omp") != std::string::npos) {
 				normal_estimator = typename NormalEstimator<PointT>::Ptr(new NormalEstimationOMP<PointT>());
 			} else if (estimator_name.find("moving_least_squares") != std::string::npos) {
@@ -878,6 +904,12 @@ void Localization<PointT>::s_setupCloudMatchersFromParameterServer(std::vector<
 				cloud_matcher.reset(new IterativeClosestPointWithNormals<PointT>());
 			} else if (matcher_name.find("iterative_closest_point_non_linear") != std::string::npos) {
 				cloud_matcher.reset(new IterativeClosestPointNonLinear<PointT>());
+			} else if (matcher_name.find("iterative_closest_point_multi_resolution") != std::string::npos) {
+				cloud_matcher.reset(new IterativeClosestPointMultiResolution<PointT>());
+			} else if (matcher_name.find("iterative_closest_point_multi_seed") != std::string::npos) {
+				cloud_matcher.reset(new IterativeClosestPointMultiSeed<PointT>());
+			} else if (matcher_name.find("iterative_closest_point_transform_free") != std::string::npos) {
+				cloud_matcher.reset(new IterativeClosestPointTransformFree<PointT>());
 			} else if (matcher_name.find("iterative_closest_point_2d") != std::string::npos) {
 				cloud_matcher.reset(new IterativeClosestPoint2D<PointT>());
 			} else if (matcher_name.find("iterative_closest_point") != std::string::npos) {
@@ -888,6 +920,12 @@ void Localization<PointT>::s_setupCloudMatchersFromParameterServer(std::vector<
 				cloud_matcher.reset(new NormalDistributionsTransform3D<PointT>());
 			} else if (matcher_name.find("principal_component_analysis") != std::string::npos) {
 				cloud_matcher.reset(new PrincipalComponentAnalysis<PointT>());
+			} else if (matcher_name.find("scan_context_place_recognition") != std::string::npos) {
+				cloud_matcher.reset(new ScanContextPlaceRecognition<PointT>());
+			} else if (matcher_name.find("branch_and_bound_scan_matcher_2d") != std::string::npos) {
+				cloud_matcher.reset(new BranchAndBoundScanMatcher2D<PointT>());
+			} else if (matcher_name.find("polar_histogram_rotation_estimator") != std::string::npos) {
+				cloud_matcher.reset(new PolarHistogramRotationEstimator<PointT>());
 			}
 
 			if (cloud_matcher) {
@@ -968,6 +1006,7 @@ void Localization<PointT>::s_setupKeypointMatcherFromParameterServer(std::vector
 																	 const std::string& keypoint_descriptor_configuration_namespace, const std::string& feature_matcher_configuration_namespace,
 																	 ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle) {
 	keypoint_descriptor->setupConfigurationFromParameterServer(node_handle, private_node_handle, keypoint_descriptor_configuration_namespace);
+	keypoint_descriptor = KeypointDescriptor<PointT, DescriptorT>::s_getSharedKeypointDescriptor(keypoint_descriptor); // matchers lists with the same descriptor configuration share its computed descriptors
 
 	XmlRpc::XmlRpcValue keypoint_matchers;
 	if (private_node_handle->getParam(feature_matcher_configuration_namespace, keypoint_matchers) && keypoint_matchers.getType() == XmlRpc::XmlRpcValue::TypeStruct) {
@@ -1249,14 +1288,22 @@ void Localization<PointT>::loadReferencePointCloudFromROSOccupancyGrid(const nav
 	size_t number_points_in_occupancy_grid = occupancy_grid_msg->info.width * occupancy_grid_msg->info.height;
 	if (number_points_in_occupancy_grid > (size_t)minimum_number_of_points_in_reference_pointcloud_ && (!reference_pointcloud_loaded_ || (ros::Time::now() - last_map_received_time_) > min_seconds_between_reference_pointcloud_update_)) {
 		typename pcl::PointCloud<PointT>::Ptr reference_pointcloud_from_occupancy_grid(new pcl::PointCloud<PointT>());
-		if (pointcloud_conversions::fromROSMsg(*occupancy_grid_msg, *reference_pointcloud_from_occupancy_grid)) {
+		bool conversion_successful = false;
+		if (compute_reference_normals_from_occupancy_grid_gradients_) {
+			conversion_successful = pointcloud_conversions::fromROSMsgWithGradientNormals(*occupancy_grid_msg, *reference_pointcloud_from_occupancy_grid, 95,
+					occupancy_grid_gradients_smoothing_radius_, (float)occupancy_grid_gradients_unknown_cell_occupancy_);
+		} else {
+			conversion_successful = pointcloud_conversions::fromROSMsg(*occupancy_grid_msg, *reference_pointcloud_from_occupancy_grid);
+		}
+
+		if (conversion_successful) {
 			if (reference_pointcloud_from_occupancy_grid->size() > (size_t)minimum_number_of_points_in_reference_pointcloud_) {
 				reference_pointcloud_2d_ = true;
 				if (occupancy_grid_msg->header.frame_id != map_frame_id_ && !transformCloudToTFFrame(reference_pointcloud_from_occupancy_grid, occupancy_grid_msg->header.stamp, map_frame_id_for_transforming_pointclouds_)) { return; }
 				reference_pointcloud_ = reference_pointcloud_from_occupancy_grid;
 				reference_pointcloud_->header.frame_id = map_frame_id_for_publishing_pointclouds_;
-				if (flip_normals_using_occupancy_grid_analysis_ && reference_cloud_normal_estimator_) reference_cloud_normal_estimator_->setOccupancyGridMsg(occupancy_grid_msg);
-				if (updateLocalizationPipelineWithNewReferenceCloud(occupancy_grid_msg->header.stamp)) {
+				if (flip_normals_using_occupancy_grid_analysis_ && reference_cloud_normal_estimator_ && !compute_reference_normals_from_occupancy_grid_gradients_) reference_cloud_normal_estimator_->setOccupancyGridMsg(occupancy_grid_msg);
+				if (updateLocalizationPipelineWithNewReferenceCloud(occupancy_grid_msg->header.stamp, compute_reference_normals_from_occupancy_grid_gradients_)) {
 					ROS_INFO_STREAM("Loaded reference point cloud from costmap topic " << reference_costmap_topic_ << " with " << reference_pointcloud_->size() << " points in " << performance_timer.getElapsedTimeFormated());
 					last_map_received_time_ = ros::Time::now();
 					return;
@@ -1301,7 +1348,7 @@ void Localization<PointT>::publishReferencePointCloud(const ros::Time& time_stam
 
 
 template<typename PointT>
-bool Localization<PointT>::updateLocalizationPipelineWithNewReferenceCloud(const ros::Time& time_stamp) {
+bool Localization<PointT>::updateLocalizationPipelineWithNewReferenceCloud(const ros::Time& time_stamp, bool reference_pointcloud_has_normals) {
 	reference_pointcloud_->header.stamp = pcl_conversions::toPCL(time_stamp);
 	localization_diagnostics_msg_.number_points_reference_pointcloud = reference_pointcloud_->size();
 
@@ -1321,8 +1368,9 @@ bool Localization<PointT>::updateLocalizationPipelineWithNewReferenceCloud(const
 
 	if (reference_pointcloud_->size() > (size_t)minimum_number_of_points_in_reference_pointcloud_) {
 		reference_pointcloud_search_method_->setInputCloud(reference_pointcloud_);
-		if (reference_cloud_normal_estimator_ || reference_cloud_curvature_estimator_) {
-			if (!applyNormalEstimator(reference_cloud_normal_estimator_, reference_cloud_curvature_estimator_, reference_pointcloud_, reference_pointcloud_raw, reference_pointcloud_search_method_,true)) { return false; }
+		typename NormalEstimator<PointT>::Ptr reference_cloud_normal_estimator = (reference_pointcloud_has_normals ? typename NormalEstimator<PointT>::Ptr() : reference_cloud_normal_estimator_);
+		if (reference_cloud_normal_estimator || reference_cloud_curvature_estimator_) {
+			if (!applyNormalEstimator(reference_cloud_normal_estimator, reference_cloud_curvature_estimator_, reference_pointcloud_, reference_pointcloud_raw, reference_pointcloud_search_method_,true)) { return false; }
 		}
 
 		if (reference_pointcloud_->size() > (size_t)minimum_number_of_points_in_reference_pointcloud_) {
@@ -1786,8 +1834,7 @@ bool Localization<PointT>::transformCloudToTFFrame(typename pcl::PointCloud<Poin
 		ambient_pointcloud->sensor_origin_(1) = (float)new_sensor_origin(1);
 		ambient_pointcloud->sensor_origin_(2) = (float)new_sensor_origin(2);
 
-		std::string transform_string = math_utils::convertTransformToString<double>(pose_tf_cloud_to_map_eigen_transform.matrix());
-		ROS_DEBUG_STREAM("Transformed pointcloud with " << ambient_pointcloud->size() << " points from frame " << ambient_pointcloud->header.frame_id << " to frame " << target_frame_id << " using matrix:" << transform_string << "\n");
+		ROS_DEBUG_STREAM("Transformed pointcloud with " << ambient_pointcloud->size() << " points from frame " << ambient_pointcloud->header.frame_id << " to frame " << target_frame_id << " using matrix:" << math_utils::formatTransform<double>(pose_tf_cloud_to_map_eigen_transform.matrix()) << "\n");
 
 		if ((target_frame_id == map_frame_id_ || target_frame_id == map_frame_id_for_transforming_pointclouds_) && !map_frame_id_for_publishing_pointclouds_.empty())
 			ambient_pointcloud->header.frame_id = map_frame_id_for_publishing_pointclouds_;
@@ -1949,13 +1996,21 @@ bool Localization<PointT>::processAmbientPointCloud(typename pcl::PointCloud<Poi
 		size_t ambient_pointcloud_size = ambient_pointcloud->size();
 		std::vector<int> indexes;
 		ambient_pointcloud->is_dense = false;
-		ROS_DEBUG_STREAM("Removing NaNs from ambient cloud with " << ambient_pointcloud_size << " points");
-		pcl::removeNaNFromPointCloud(*ambient_pointcloud, *ambient_pointcloud, indexes);
-		indexes.clear();
-		size_t number_of_nans_in_ambient_pointcloud = ambient_pointcloud_size - ambient_pointcloud->size();
-		ROS_DEBUG_STREAM("Removed " << number_of_nans_in_ambient_pointcloud << " NaNs from ambient cloud with " << ambient_pointcloud_size << " points");
+		bool keep_ambient_pointcloud_organized = keep_ambient_pointcloud_organized_ && ambient_pointcloud->isOrganized() && !ambient_pointcloud_with_circular_buffer_;
+		if (keep_ambient_pointcloud_organized) {
+			ROS_DEBUG_STREAM("Keeping the " << ambient_pointcloud->width << "x" << ambient_pointcloud->height << " layout of the organized ambient cloud (NaNs will be removed after the normal estimation)");
+		} else {
+			ROS_DEBUG_STREAM("Removing NaNs from ambient cloud with " << ambient_pointcloud_size << " points");
+			pcl::removeNaNFromPointCloud(*ambient_pointcloud, *ambient_pointcloud, indexes);
+			indexes.clear();
+			size_t number_of_nans_in_ambient_pointcloud = ambient_pointcloud_size - ambient_pointcloud->size();
+			ROS_DEBUG_STREAM("Removed " << number_of_nans_in_ambient_pointcloud << " NaNs from ambient cloud with " << ambient_pointcloud_size << " points");
+		}
 
-		if (remove_points_in_sensor_origin_) {
+		if (remove_points_in_sensor_origin_ && keep_ambient_pointcloud_organized) {
+			size_t number_of_points_in_sensor_origin_in_ambient_pointcloud = pointcloud_utils::invalidatePointsOnSensorOrigin(*ambient_pointcloud);
+			ROS_DEBUG_STREAM("Invalidated " << number_of_points_in_sensor_origin_in_ambient_pointcloud << " points in sensor origin from ambient cloud with " << ambient_pointcloud_size << " points");
+		} else if (remove_points_in_sensor_origin_) {
 			size_t number_of_points_in_ambient_pointcloud_before_sensor_origin_removal = ambient_pointcloud->size();
 			ROS_DEBUG_STREAM("Removing points in sensor origin from a ambient cloud with " << number_of_points_in_ambient_pointcloud_before_sensor_origin_removal << " points");
 			pointcloud_utils::removePointsOnSensorOrigin(*ambient_pointcloud);
@@ -2235,7 +2290,7 @@ bool Localization<PointT>::s_applyCloudFilters(std::vector< typename CloudFilter
 
 template<typename PointT>
 bool Localization<PointT>::applyNormalEstimator(typename NormalEstimator<PointT>::Ptr& normal_estimator, typename CurvatureEstimator<PointT>::Ptr& curvature_estimator, typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::PointCloud<PointT>::Ptr& surface,
-												typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, bool pointcloud_is_map) {
+												typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, bool pointcloud_is_map, const pcl::IndicesPtr& pointcloud_indices) {
 	if (!normal_estimator && !curvature_estimator) return false;
 
 	PerformanceTimer performance_timer;
@@ -2264,7 +2319,7 @@ bool Localization<PointT>::applyNormalEstimator(typename NormalEstimator<PointT>
 		sensor_pose_tf_guess.getOrigin().setZ(0.0);
 	}
 
-	bool status = s_applyNormalEstimator(normal_estimator, curvature_estimator, pointcloud, surface, pointcloud_search_method, sensor_pose_tf_guess, minimum_number_of_points_in_ambient_pointcloud_);
+	bool status = s_applyNormalEstimator(normal_estimator, curvature_estimator, pointcloud, surface, pointcloud_search_method, sensor_pose_tf_guess, minimum_number_of_points_in_ambient_pointcloud_, pointcloud_indices);
 
 	localization_times_msg_.surface_normal_estimation_time += performance_timer.getElapsedTimeInMilliSec();
 
@@ -2275,10 +2330,17 @@ bool Localization<PointT>::applyNormalEstimator(typename NormalEstimator<PointT>
 template<typename PointT>
 bool Localization<PointT>::s_applyNormalEstimator(typename NormalEstimator<PointT>::Ptr& normal_estimator, typename CurvatureEstimator<PointT>::Ptr& curvature_estimator, typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::PointCloud<PointT>::Ptr& surface,
 												  typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method,
-												  tf2::Transform& sensor_pose_tf_guess, int minimum_number_of_points_in_ambient_pointcloud) {
+												  tf2::Transform& sensor_pose_tf_guess, int minimum_number_of_points_in_ambient_pointcloud, const pcl::IndicesPtr& pointcloud_indices) {
 	if (!normal_estimator && !curvature_estimator) return false;
 
-	if (surface && surface->size() > (size_t)minimum_number_of_points_in_ambient_pointcloud) {
+	if (pointcloud_indices && normal_estimator && !curvature_estimator && normal_estimator->estimateNormalsOfIndices(pointcloud, pointcloud_indices, pointcloud_search_method, sensor_pose_tf_guess)) {
+		return pointcloud->size() > (size_t)minimum_number_of_points_in_ambient_pointcloud;
+	}
+
+	if (surface && surface->size() > (size_t)minimum_number_of_points_in_ambient_pointcloud && normal_estimator && !curvature_estimator && !normal_estimator->requiresSurfaceSearchMethod(surface)) {
+		ROS_DEBUG_STREAM("Using raw pointcloud with " << surface->size() << " points as surface for normal estimation (without kd-tree)");
+		normal_estimator->estimateNormals(pointcloud, surface, pointcloud_search_method, sensor_pose_tf_guess, pointcloud); // updates the pointcloud_search_method if the number of points changed
+	} else if (surface && surface->size() > (size_t)minimum_number_of_points_in_ambient_pointcloud) {
 		ROS_DEBUG_STREAM("Using raw pointcloud with " << surface->size() << " points as surface for normal estimation");
 		typename pcl::search::KdTree<PointT>::Ptr surface_search_method(new pcl::search::KdTree<PointT>());
 		surface_search_method->setInputCloud(surface);
@@ -2298,6 +2360,71 @@ bool Localization<PointT>::s_applyNormalEstimator(typename NormalEstimator<Point
 }
 
 
+template<typename PointT>
+void Localization<PointT>::selectCircularBufferPointsForNormalEstimation(typename pcl::search::KdTree<PointT>::Ptr& search_method, std::vector<int>& indices_out) {
+	ambient_pointcloud_with_circular_buffer_->getNewElementsIndices(indices_out);
+	const pcl::PointCloud<PointT>& buffer_pointcloud = ambient_pointcloud_with_circular_buffer_->getPointCloud();
+	if (indices_out.size() >= buffer_pointcloud.size() || circular_buffer_incremental_normal_estimation_seam_radius_ <= 0.0 || !search_method->getInputCloud()) { return; }
+
+	size_t number_of_new_points = indices_out.size();
+	std::vector<char> selected_points(buffer_pointcloud.size(), 0);
+	for (size_t i = 0; i < indices_out.size(); ++i) {
+		selected_points[indices_out[i]] = 1;
+	}
+
+	std::vector<int> neighbors_indices;
+	std::vector<float> neighbors_squared_distances;
+	auto select_seam_points = [&](const PointT& seam_center) {
+		if (!pcl::isFinite(seam_center)) { return; }
+		if (search_method->radiusSearch(seam_center, circular_buffer_incremental_normal_estimation_seam_radius_, neighbors_indices, neighbors_squared_distances) > 0) {
+			for (size_t j = 0; j < neighbors_indices.size(); ++j) {
+				if (selected_points[neighbors_indices[j]] == 0) {
+					selected_points[neighbors_indices[j]] = 1;
+					indices_out.push_back(neighbors_indices[j]);
+				}
+			}
+		}
+	};
+
+	for (size_t i = 0; i < number_of_new_points; ++i) {
+		select_seam_points(buffer_pointcloud[indices_out[i]]);
+	}
+
+	// old points that had the overwritten points as neighbors
+	const pcl::PointCloud<PointT>& replaced_points = ambient_pointcloud_with_circular_buffer_->getReplacedElements();
+	for (size_t i = 0; i < replaced_points.size(); ++i) {
+		select_seam_points(replaced_points[i]);
+	}
+
+	ROS_DEBUG_STREAM("Updating the normals of " << number_of_new_points << " new points and " << (indices_out.size() - number_of_new_points) << " seam points (around the new points and the "
+			<< replaced_points.size() << " overwritten points) in the circular buffer with " << buffer_pointcloud.size() << " points");
+}
+
+
+template<typename PointT>
+void Localization<PointT>::buildAmbientPointCloudNeighborhoodCache(typename pcl::search::KdTree<PointT>::Ptr& search_method) {
+	typename NeighborhoodCacheKdTree<PointT>::Ptr neighborhood_cache = std::dynamic_pointer_cast< NeighborhoodCacheKdTree<PointT> >(search_method);
+	if (!neighborhood_cache || !neighborhood_cache->getInputCloud() || neighborhood_cache->isNeighborhoodCacheValid()) { return; }
+
+	double radius = ambient_pointcloud_neighborhood_cache_radius_;
+	if (radius <= 0.0) {
+		radius = neighborhood_cache->getLargestRequestedRadius();
+		if (ambient_pointcloud_neighborhood_cache_maximum_radius_ > 0.0) { radius = std::min(radius, ambient_pointcloud_neighborhood_cache_maximum_radius_); }
+	}
+
+	int k = (ambient_pointcloud_neighborhood_cache_k_ > 0 ? ambient_pointcloud_neighborhood_cache_k_ : neighborhood_cache->getLargestRequestedK());
+	if (ambient_pointcloud_neighborhood_cache_maximum_number_of_neighbors_ > 0) { k = std::min(k, ambient_pointcloud_neighborhood_cache_maximum_number_of_neighbors_); }
+
+	PerformanceTimer performance_timer;
+	performance_timer.start();
+	if (neighborhood_cache->buildNeighborhoodCache(radius, k)) {
+		ROS_DEBUG_STREAM("Built the ambient point cloud neighborhood cache in " << performance_timer.getElapsedTimeInMilliSec() << " ms");
+	} else {
+		ROS_DEBUG("Skipping the ambient point cloud neighborhood cache (no radius or k requested yet)");
+	}
+}
+
+
 template<typename PointT>
 bool Localization<PointT>::applyKeypointDetectors(std::vector< typename KeypointDetector<PointT>::Ptr >& keypoint_detectors, typename pcl::PointCloud<PointT>::Ptr& pointcloud, typename pcl::search::KdTree<PointT>::Ptr& surface_search_method, typename pcl::PointCloud<PointT>::Ptr& keypoints) {
 	PerformanceTimer performance_timer;
@@ -2333,12 +2460,13 @@ template<typename PointT>
 bool Localization<PointT>::applyCloudMatchers(std::vector< typename CloudMatcher<PointT>::Ptr >& matchers, typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
 											  typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
 											  typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
-											  tf2::Transform& pose_corrections_in_out) {
+											  tf2::Transform& pose_corrections_in_out, const tf2::Transform* pointcloud_pose_initial_guess) {
 	return s_applyCloudMatchers(matchers, ambient_pointcloud, surface_search_method, pointcloud_keypoints, pose_corrections_in_out,
 								minimum_number_of_points_in_ambient_pointcloud_, accepted_pose_corrections_, number_of_registration_iterations_for_all_matchers_,
 								correspondence_estimation_time_for_all_matchers_, transformation_estimation_time_for_all_matchers_, transform_cloud_time_for_all_matchers_,
 								cloud_align_time_for_all_matchers_,
-								last_matcher_convergence_state_, root_mean_square_error_of_last_registration_correspondences_, number_correspondences_last_registration_algorithm_);
+								last_matcher_convergence_state_, root_mean_square_error_of_last_registration_correspondences_, number_correspondences_last_registration_algorithm_,
+								pointcloud_pose_initial_guess);
 }
 
 
@@ -2349,7 +2477,8 @@ bool Localization<PointT>::s_applyCloudMatchers(std::vector< typename CloudMatch
 												tf2::Transform& pose_corrections_in_out,
 												int minimum_number_of_points_in_ambient_pointcloud, std::vector< tf2::Transform >& accepted_pose_corrections, int& number_of_registration_iterations_for_all_matchers,
 												double& correspondence_estimation_time_for_all_matchers, double& transformation_estimation_time_for_all_matchers, double& transform_cloud_time_for_all_matchers, double& cloud_align_time_for_all_matchers,
-												std::string& last_matcher_convergence_state, double& root_mean_square_error_of_last_registration_correspondences, int& number_correspondences_last_registration_algorithm) {
+												std::string& last_matcher_convergence_state, double& root_mean_square_error_of_last_registration_correspondences, int& number_correspondences_last_registration_algorithm,
+												const tf2::Transform* pointcloud_pose_initial_guess) {
 
 	if (ambient_pointcloud->size() < (size_t)minimum_number_of_points_in_ambient_pointcloud) { return false; }
 
@@ -2357,6 +2486,9 @@ bool Localization<PointT>::s_applyCloudMatchers(std::vector< typename CloudMatch
 	for (size_t i = 0; i < matchers.size(); ++i) {
 		typename pcl::PointCloud<PointT>::Ptr ambient_pointcloud_aligned(new pcl::PointCloud<PointT>());
 		tf2::Transform pose_correction;
+		if (pointcloud_pose_initial_guess) {
+			matchers[i]->setPosePrior(pose_corrections_in_out * (*pointcloud_pose_initial_guess)); // the ambient cloud was already moved by the corrections of the previous matchers
+		}
 		if (matchers[i]->registerCloud(ambient_pointcloud, surface_search_method, pointcloud_keypoints, pose_correction, accepted_pose_corrections, ambient_pointcloud_aligned, false)) {
 			pose_corrections_in_out = pose_correction * pose_corrections_in_out;
 			registration_successful = true;
@@ -2430,8 +2562,7 @@ bool Localization<PointT>::s_applyTransformationAligner(const tf2::Transform& po
 	}
 
 	Eigen::Transform<double, 3, Eigen::Affine> new_pose_corrections_out_eigen = laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(new_pose_corrections_out);
-	std::string transform_string = math_utils::convertTransformToString<double>(new_pose_corrections_out_eigen.matrix());
-	ROS_DEBUG_STREAM("Pointcloud registration postprocessing applied correction matrix:" << transform_string << "\n");
+	ROS_DEBUG_STREAM("Pointcloud registration postprocessing applied correction matrix:" << math_utils::formatTransform<double>(new_pose_corrections_out_eigen.matrix()) << "\n");
 
 	return true;
 }
@@ -2826,6 +2957,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 
 	localization_diagnostics_msg_.number_points_ambient_pointcloud_after_filtering = ambient_pointcloud->size();
 	if (ambient_pointcloud_with_circular_buffer_) {
+		ambient_pointcloud_with_circular_buffer_->setTrackReplacedElements(circular_buffer_incremental_normal_estimation_); // the neighbors of the overwritten points also need new normals
 		ambient_pointcloud_with_circular_buffer_->insert(*ambient_pointcloud);
 		ambient_pointcloud_with_circular_buffer_->getPointCloud().header = ambient_pointcloud->header;
 		ambient_pointcloud_with_circular_buffer_->getPointCloud().header.frame_id = map_frame_id_;
@@ -2854,16 +2986,49 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 	}
 
 	// ==============================================================  normal estimation
-	typename pcl::search::KdTree<PointT>::Ptr ambient_search_method(new pcl::search::KdTree<PointT>());
-	ambient_search_method->setInputCloud(ambient_pointcloud);
+	typename pcl::search::KdTree<PointT>::Ptr ambient_search_method;
+	if (ambient_pointcloud_use_neighborhood_cache_) {
+		typename NeighborhoodCacheKdTree<PointT>::Ptr ambient_neighborhood_cache(new NeighborhoodCacheKdTree<PointT>());
+		ambient_neighborhood_cache->setMaximumNumberOfNeighbors(ambient_pointcloud_neighborhood_cache_maximum_number_of_neighbors_);
+		ambient_neighborhood_cache->setNumberOfThreads(ambient_pointcloud_neighborhood_cache_number_of_threads_);
+		if (last_ambient_pointcloud_neighborhood_cache_) {
+			ROS_DEBUG_STREAM("Previous ambient point cloud neighborhood cache had " << last_ambient_pointcloud_neighborhood_cache_->getNumberOfCacheMisses() << " searches answered by the kd-tree");
+			ambient_neighborhood_cache->setLargestRequestedNeighborhood(last_ambient_pointcloud_neighborhood_cache_->getLargestRequestedRadius(), last_ambient_pointcloud_neighborhood_cache_->getLargestRequestedK());
+		}
+		last_ambient_pointcloud_neighborhood_cache_ = ambient_neighborhood_cache;
+		ambient_search_method = ambient_neighborhood_cache;
+	} else {
+		ambient_search_method.reset(new pcl::search::KdTree<PointT>());
+	}
+
+	if (compute_normals_when_tracking_pose_ && ambient_cloud_normal_estimator_ && !ambient_cloud_curvature_estimator_ &&
+			!ambient_cloud_normal_estimator_->requiresSurfaceSearchMethod(ambient_pointcloud_raw ? ambient_pointcloud_raw : ambient_pointcloud)) {
+		ROS_DEBUG("Postponing the ambient cloud kd-tree construction to after the normal estimation on the organized surface");
+	} else {
+		ambient_search_method->setInputCloud(ambient_pointcloud);
+	}
 	bool computed_normals = false;
 	localization_times_msg_.surface_normal_estimation_time = 0.0;
 	if (compute_normals_when_tracking_pose_ && (ambient_cloud_normal_estimator_ || ambient_cloud_curvature_estimator_)) {
-		if (!applyNormalEstimator(ambient_cloud_normal_estimator_, ambient_cloud_curvature_estimator_, ambient_pointcloud, ambient_pointcloud_raw, ambient_search_method)) {
+		pcl::IndicesPtr ambient_pointcloud_indices_for_normal_estimation;
+		if (circular_buffer_incremental_normal_estimation_ && ambient_pointcloud_with_circular_buffer_ && !ambient_pointcloud_raw) {
+			ambient_pointcloud_indices_for_normal_estimation.reset(new std::vector<int>());
+			selectCircularBufferPointsForNormalEstimation(ambient_search_method, *ambient_pointcloud_indices_for_normal_estimation);
+		}
+		if (!ambient_pointcloud_raw || ambient_pointcloud_raw->size() <= (size_t)minimum_number_of_points_in_ambient_pointcloud_) {
+			buildAmbientPointCloudNeighborhoodCache(ambient_search_method); // the raw surface is searched with its own kd-tree
+		}
+
+		if (!applyNormalEstimator(ambient_cloud_normal_estimator_, ambient_cloud_curvature_estimator_, ambient_pointcloud, ambient_pointcloud_raw, ambient_search_method, false, ambient_pointcloud_indices_for_normal_estimation)) {
 			sensor_data_processing_status_ = FailedNormalEstimation;
 			return false;
 		}
 		computed_normals = true;
+
+		if (ambient_pointcloud_indices_for_normal_estimation) {
+			ambient_pointcloud_with_circular_buffer_->resetNewElements();
+			ambient_pointcloud = typename pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>(*ambient_pointcloud)); // the buffer keeps all its points (and normals) for the next incremental update
+		}
 	}
 
 	if (!applyCloudFilters(ambient_pointcloud_filters_after_normal_estimation_, ambient_pointcloud)) {
@@ -2871,12 +3036,26 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 		return false;
 	}
 
+	size_t number_of_points_in_ambient_pointcloud_before_nan_removal = ambient_pointcloud->size();
 	std::vector<int> indexes;
 	pcl::removeNaNFromPointCloud(*ambient_pointcloud, *ambient_pointcloud, indexes);
 	indexes.clear();
 	pcl::removeNaNNormalsFromPointCloud(*ambient_pointcloud, *ambient_pointcloud, indexes);
 	indexes.clear();
 
+	if (ambient_pointcloud->size() < (size_t)minimum_number_of_points_in_ambient_pointcloud_) { // organized clouds are only checked for their valid points here
+		ROS_DEBUG_STREAM("Ambient point cloud only has " << ambient_pointcloud->size() << " valid points (from " << number_of_points_in_ambient_pointcloud_before_nan_removal << ")");
+		sensor_data_processing_status_ = PointCloudWithoutTheMinimumNumberOfRequiredPoints;
+		return false;
+	}
+
+	if (!ambient_search_method->getInputCloud() || ambient_pointcloud->size() != number_of_points_in_ambient_pointcloud_before_nan_removal) {
+		ambient_search_method->setInputCloud(ambient_pointcloud); // organized clouds keep their invalid points until here
+	}
+	if (compute_keypoints_when_tracking_pose_ && !ambient_cloud_keypoint_detectors_.empty()) {
+		buildAmbientPointCloudNeighborhoodCache(ambient_search_method); // only built if the normal estimation did not use it or if the nan removal changed the ambient point cloud
+	}
+
 	pointcloud_conversions::publishPointCloud(*ambient_pointcloud, filtered_pointcloud_publisher_, map_frame_id_for_publishing_pointclouds_, publish_filtered_pointcloud_only_if_there_is_subscribers_, "filtered ambient pointcloud");
 
 	if (!filtered_pointcloud_save_filename_.empty()) {
@@ -2955,7 +3134,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 
 		if (!initial_pose_estimators_point_matchers_.empty() && !applyCloudMatchers(initial_pose_estimators_point_matchers_, ambient_pointcloud, ambient_search_method,
 																					(ambient_pointcloud_keypoints_out->size() < (size_t) minimum_number_of_points_in_ambient_pointcloud_)
-																					? ambient_pointcloud : ambient_pointcloud_keypoints_out, pose_corrections_out)) {
+																					? ambient_pointcloud : ambient_pointcloud_keypoints_out, pose_corrections_out, &pointcloud_pose_initial_guess)) {
 			sensor_data_processing_status_ = FailedInitialPoseEstimation;
 			return false;
 		}
@@ -2997,7 +3176,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 				if (applyCloudMatchers(tracking_recovery_matchers_, ambient_pointcloud, ambient_search_method,
 									   (ambient_pointcloud_keypoints_out->size() < (size_t) minimum_number_of_points_in_ambient_pointcloud_) ? ambient_pointcloud
 																																			 : ambient_pointcloud_keypoints_out,
-									   pose_corrections_out)) {
+									   pose_corrections_out, &pointcloud_pose_initial_guess)) {
 					ROS_INFO("Successfully performed registration recovery");
 					performed_recovery = true;
 					localization_times_msg_.pointcloud_registration_time += performance_timer.getElapsedTimeInMilliSec();
@@ -3067,7 +3246,7 @@ bool Localization<PointT>::updateLocalizationWithAmbientPointCloud(typename pcl:
 				if (applyCloudMatchers(tracking_recovery_matchers_, ambient_pointcloud, ambient_search_method,
 									   (ambient_pointcloud_keypoints_out->size() < (size_t) minimum_number_of_points_in_ambient_pointcloud_) ? ambient_pointcloud
 																																			 : ambient_pointcloud_keypoints_out,
-									   pose_corrections_out)) {
+									   pose_corrections_out, &pointcloud_pose_initial_guess)) {
 					pointcloud_pose_corrected_out = pose_corrections_out * pointcloud_pose_initial_guess;
 					if (!applyTransformationAligner(pointcloud_pose_initial_guess, pointcloud_pose_corrected_out, post_process_cloud_registration_pose_corrections, pointcloud_time)) { return false; }
 					pcl::transformPointCloudWithNormals(*ambient_pointcloud, *ambient_pointcloud, laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<double>(post_process_cloud_registration_pose_corrections));
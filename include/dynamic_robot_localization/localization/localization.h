@@ -50,6 +50,7 @@
 // project includes
 #include <dynamic_robot_localization/common/configurable_object.h>
 #include <dynamic_robot_localization/common/impl/math_utils.hpp>
+#include <dynamic_robot_localization/common/neighborhood_cache_kdtree.h>
 #include <dynamic_robot_localization/common/pointcloud_conversions.h>
 #include <dynamic_robot_localization/common/pointcloud_utils.h>
 #include <dynamic_robot_localization/common/transformation_aligner.h>
@@ -75,6 +76,7 @@
 #include <dynamic_robot_localization/curvature_estimators/curvature_estimator.h>
 #include <dynamic_robot_localization/curvature_estimators/principal_curvatures_estimation.h>
 #include <dynamic_robot_localization/normal_estimators/normal_estimator.h>
+#include <dynamic_robot_localization/normal_estimators/integral_image_normal_estimation.h>
 #include <dynamic_robot_localization/normal_estimators/normal_estimator_sac.h>
 #include <dynamic_robot_localization/normal_estimators/normal_estimation_omp.h>
 #include <dynamic_robot_localization/normal_estimators/moving_least_squares.h>
@@ -95,11 +97,17 @@
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_2d.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_non_linear.h>
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_transform_free.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_with_normals.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_generalized.h>
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_multi_resolution.h>
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/iterative_closest_point_multi_seed.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/normal_distributions_transform_2d.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/normal_distributions_transform_3d.h>
 #include <dynamic_robot_localization/cloud_matchers/point_matchers/principal_component_analysis.h>
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/scan_context_place_recognition.h>
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/branch_and_bound_scan_matcher_2d.h>
+#include <dynamic_robot_localization/cloud_matchers/point_matchers/polar_histogram_rotation_estimator.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/sample_consensus_initial_alignment.h>
 #include <dynamic_robot_localization/cloud_matchers/feature_matchers/sample_consensus_initial_alignment_prerejective.h>
 
@@ -289,7 +297,8 @@ class Localization : public ConfigurableObject {
 		virtual void loadReferencePointCloudFromROSPointCloud(const sensor_msgs::PointCloud2ConstPtr& reference_pointcloud_msg);
 		virtual void loadReferencePointCloudFromROSOccupancyGrid(const nav_msgs::OccupancyGridConstPtr& occupancy_grid_msg);
 		virtual void publishReferencePointCloud(const ros::Time& time_stamp, bool update_msg = true);
-		virtual bool updateLocalizationPipelineWithNewReferenceCloud(const ros::Time& time_stamp);
+		/** reference_pointcloud_has_normals skips the reference normal estimator (normals computed during the conversion of the reference map) */
+		virtual bool updateLocalizationPipelineWithNewReferenceCloud(const ros::Time& time_stamp, bool reference_pointcloud_has_normals = false);
 		virtual void updateMatchersReferenceCloud();
 
 		virtual bool setInitialPose(const geometry_msgs::Pose& pose, const std::string& frame_id, const ros::Time& pose_time);
@@ -322,12 +331,18 @@ class Localization : public ConfigurableObject {
 		virtual bool applyNormalEstimator(typename NormalEstimator<PointT>::Ptr& normal_estimator, typename CurvatureEstimator<PointT>::Ptr& curvature_estimator,
 										  typename pcl::PointCloud<PointT>::Ptr& pointcloud,
 										  typename pcl::PointCloud<PointT>::Ptr& surface,
-										  typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, bool pointcloud_is_map = false);
+										  typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, bool pointcloud_is_map = false,
+										  const pcl::IndicesPtr& pointcloud_indices = pcl::IndicesPtr());
 		static bool s_applyNormalEstimator(typename NormalEstimator<PointT>::Ptr& normal_estimator, typename CurvatureEstimator<PointT>::Ptr& curvature_estimator,
 										   typename pcl::PointCloud<PointT>::Ptr& pointcloud,
 										   typename pcl::PointCloud<PointT>::Ptr& surface,
 										   typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method,
-										   tf2::Transform& sensor_pose_tf_guess, int minimum_number_of_points_in_ambient_pointcloud);
+										   tf2::Transform& sensor_pose_tf_guess, int minimum_number_of_points_in_ambient_pointcloud,
+										   const pcl::IndicesPtr& pointcloud_indices = pcl::IndicesPtr());
+		/** Indices of the circular buffer points inserted since the last normal estimation and of their neighbors within the seam radius (whose neighborhood changed) */
+		virtual void selectCircularBufferPointsForNormalEstimation(typename pcl::search::KdTree<PointT>::Ptr& search_method, std::vector<int>& indices_out);
+		/** Builds the neighborhood cache of the ambient kd-tree (if it is a NeighborhoodCacheKdTree without a valid cache) with the configured radius / k or with the largest ones requested in the previous point cloud */
+		virtual void buildAmbientPointCloudNeighborhoodCache(typename pcl::search::KdTree<PointT>::Ptr& search_method);
 
 		virtual bool applyKeypointDetectors(std::vector< typename KeypointDetector<PointT>::Ptr >& keypoint_detectors, typename pcl::PointCloud<PointT>::Ptr& pointcloud,
 											typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
@@ -339,14 +354,16 @@ class Localization : public ConfigurableObject {
 		virtual bool applyCloudMatchers(std::vector< typename CloudMatcher<PointT>::Ptr >& matchers, typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
 										typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
 										typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
-										tf2::Transform& pointcloud_pose_in_out);
+										tf2::Transform& pointcloud_pose_in_out, const tf2::Transform* pointcloud_pose_initial_guess = nullptr);
+		/** If pointcloud_pose_initial_guess is given, the pose prior of each matcher is set to it composed with the pose corrections of the previous matchers */
 		static bool s_applyCloudMatchers(std::vector< typename CloudMatcher<PointT>::Ptr >& matchers, typename pcl::PointCloud<PointT>::Ptr& ambient_pointcloud,
 										 typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
 										 typename pcl::PointCloud<PointT>::Ptr& pointcloud_keypoints,
 										 tf2::Transform& pointcloud_pose_in_out,
 										 int minimum_number_of_points_in_ambient_pointcloud, std::vector< tf2::Transform >& accepted_pose_corrections, int& number_of_registration_iterations_for_all_matchers,
 										 double& correspondence_estimation_time_for_all_matchers, double& transformation_estimation_time_for_all_matchers, double& transform_cloud_time_for_all_matchers, double& cloud_align_time_for_all_matchers,
-										 std::string& last_matcher_convergence_state, double& root_mean_square_error_of_last_registration_correspondences, int& number_correspondences_last_registration_algorithm);
+										 std::string& last_matcher_convergence_state, double& root_mean_square_error_of_last_registration_correspondences, int& number_correspondences_last_registration_algorithm,
+										 const tf2::Transform* pointcloud_pose_initial_guess = nullptr);
 
 		virtual bool applyTransformationAligner(const tf2::Transform& pointcloud_pose_initial_guess, const tf2::Transform& pointcloud_pose_corrected, tf2::Transform& new_pose_corrections_out, const ros::Time& pointcloud_time);
 		static bool s_applyTransformationAligner(const tf2::Transform& pointcloud_pose_initial_guess, const tf2::Transform& pointcloud_pose_corrected, tf2::Transform& new_pose_corrections_out, const ros::Time& pointcloud_time,
@@ -482,6 +499,7 @@ class Localization : public ConfigurableObject {
 		ros::Duration pose_tracking_recovery_timeout_;
 		ros::Duration initial_pose_estimation_timeout_;
 		bool remove_points_in_sensor_origin_;
+		bool keep_ambient_pointcloud_organized_;
 		int minimum_number_of_points_in_ambient_pointcloud_;
 		int minimum_number_of_points_in_reference_pointcloud_;
 		bool localization_detailed_use_millimeters_in_root_mean_square_error_inliers_;
@@ -496,9 +514,21 @@ class Localization : public ConfigurableObject {
 		bool add_odometry_displacement_;
 		bool use_filtered_cloud_as_normal_estimation_surface_ambient_;
 		bool use_filtered_cloud_as_normal_estimation_surface_reference_;
+		bool compute_reference_normals_from_occupancy_grid_gradients_;
+		int occupancy_grid_gradients_smoothing_radius_;
+		double occupancy_grid_gradients_unknown_cell_occupancy_;
 		bool compute_normals_when_tracking_pose_;
 		bool compute_normals_when_recovering_pose_tracking_;
 		bool compute_normals_when_estimating_initial_pose_;
+		bool circular_buffer_incremental_normal_estimation_;
+		double circular_buffer_incremental_normal_estimation_seam_radius_;
+		bool ambient_pointcloud_use_neighborhood_cache_;
+		double ambient_pointcloud_neighborhood_cache_radius_;
+		double ambient_pointcloud_neighborhood_cache_maximum_radius_;
+		int ambient_pointcloud_neighborhood_cache_k_;
+		int ambient_pointcloud_neighborhood_cache_maximum_number_of_neighbors_;
+		int ambient_pointcloud_neighborhood_cache_number_of_threads_;
+		typename NeighborhoodCacheKdTree<PointT>::Ptr last_ambient_pointcloud_neighborhood_cache_;
 		bool compute_keypoints_when_tracking_pose_;
 		bool compute_keypoints_when_recovering_pose_tracking_;
 		bool compute_keypoints_when_estimating_initial_pose_;
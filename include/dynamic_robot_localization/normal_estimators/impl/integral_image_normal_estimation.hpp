@@ -0,0 +1,169 @@
+/**\file integral_image_normal_estimation.hpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/normal_estimators/integral_image_normal_estimation.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <imports>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </imports>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IntegralImageNormalEstimation-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+template<typename PointT>
+void IntegralImageNormalEstimation<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
+	std::string normal_estimation_method;
+	private_node_handle->param(configuration_namespace + "normal_estimation_method", normal_estimation_method, std::string("AVERAGE_3D_GRADIENT"));
+	if (normal_estimation_method == "COVARIANCE_MATRIX") {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, pcl::Normal>::COVARIANCE_MATRIX);
+	} else if (normal_estimation_method == "AVERAGE_DEPTH_CHANGE") {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, pcl::Normal>::AVERAGE_DEPTH_CHANGE);
+	} else if (normal_estimation_method == "SIMPLE_3D_GRADIENT") {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, pcl::Normal>::SIMPLE_3D_GRADIENT);
+	} else {
+		normal_estimator_.setNormalEstimationMethod(pcl::IntegralImageNormalEstimation<PointT, pcl::Normal>::AVERAGE_3D_GRADIENT);
+	}
+
+	double max_depth_change_factor;
+	private_node_handle->param(configuration_namespace + "max_depth_change_factor", max_depth_change_factor, 0.02);
+	normal_estimator_.setMaxDepthChangeFactor((float)max_depth_change_factor);
+
+	double normal_smoothing_size;
+	private_node_handle->param(configuration_namespace + "normal_smoothing_size", normal_smoothing_size, 10.0);
+	normal_estimator_.setNormalSmoothingSize((float)normal_smoothing_size);
+
+	bool use_depth_dependent_smoothing;
+	private_node_handle->param(configuration_namespace + "use_depth_dependent_smoothing", use_depth_dependent_smoothing, true);
+	normal_estimator_.setDepthDependentSmoothing(use_depth_dependent_smoothing);
+
+	private_node_handle->param(configuration_namespace + "maximum_normal_transfer_distance", maximum_normal_transfer_distance_, 0.05);
+
+	unorganized_normal_estimator_.setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+	NormalEstimator<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
+}
+
+
+template<typename PointT>
+void IntegralImageNormalEstimation<PointT>::estimateNormals(typename pcl::PointCloud<PointT>::Ptr& pointcloud,
+		typename pcl::PointCloud<PointT>::Ptr& surface,
+		typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+		tf2::Transform& viewpoint_guess,
+		typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out) {
+	size_t pointcloud_original_size = pointcloud->size();
+	if (pointcloud_original_size < 3) { return; }
+
+	typename pcl::PointCloud<PointT>::Ptr organized_surface = surface ? surface : pointcloud;
+	if (!organized_surface->isOrganized()) {
+		ROS_DEBUG("IntegralImageNormalEstimation received a surface without organized layout, using NormalEstimationOMP instead");
+		if (!surface_search_method->getInputCloud()) { surface_search_method->setInputCloud(organized_surface); }
+		unorganized_normal_estimator_.estimateNormals(pointcloud, surface, surface_search_method, viewpoint_guess, pointcloud_with_normals_out);
+		return;
+	}
+
+	Eigen::Affine3f surface_to_sensor_transform = laserscan_to_pointcloud::tf_rosmsg_eigen_conversions::transformTF2ToTransform<float>(viewpoint_guess.inverse());
+	typename pcl::PointCloud<PointT>::Ptr surface_in_sensor_frame;
+	pcl::PointCloud<pcl::Normal> surface_normals;
+	computeSurfaceNormals(*organized_surface, surface_to_sensor_transform, surface_in_sensor_frame, surface_normals);
+
+	if (pointcloud->width == surface_normals.width && pointcloud->height == surface_normals.height) {
+		for (size_t i = 0; i < pointcloud->size(); ++i) { // same image layout -> the normals are copied by index
+			PointT& point = (*pointcloud)[i];
+			const pcl::Normal& normal = surface_normals[i];
+			point.normal_x = normal.normal_x;
+			point.normal_y = normal.normal_y;
+			point.normal_z = normal.normal_z;
+			point.curvature = normal.curvature;
+		}
+	} else {
+		transferSurfaceNormals(*pointcloud, surface_in_sensor_frame, surface_normals, surface_to_sensor_transform);
+	}
+
+	pointcloud_with_normals_out = pointcloud;  // switch pointers
+
+	std::vector<int> indexes;
+	pcl::removeNaNFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
+	indexes.clear();
+	pcl::removeNaNNormalsFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
+	indexes.clear();
+
+	ROS_DEBUG_STREAM("IntegralImageNormalEstimation computed " << pointcloud_with_normals_out->size() << " normals from a cloud with " << pointcloud_original_size << " points");
+
+	NormalEstimator<PointT>::estimateNormals(pointcloud, surface, surface_search_method, viewpoint_guess, pointcloud_with_normals_out);
+
+	if (pointcloud_with_normals_out->size() > 3 && (pointcloud_with_normals_out->size() != pointcloud_original_size || !surface_search_method->getInputCloud())) {
+		surface_search_method->setInputCloud(pointcloud_with_normals_out);
+	}
+}
+
+
+template<typename PointT>
+void IntegralImageNormalEstimation<PointT>::computeSurfaceNormals(const pcl::PointCloud<PointT>& surface, const Eigen::Affine3f& surface_to_sensor_transform,
+		typename pcl::PointCloud<PointT>::Ptr& surface_in_sensor_frame_out, pcl::PointCloud<pcl::Normal>& surface_normals_out) {
+	surface_in_sensor_frame_out = typename pcl::PointCloud<PointT>::Ptr(new pcl::PointCloud<PointT>());
+	pcl::transformPointCloud(surface, *surface_in_sensor_frame_out, surface_to_sensor_transform); // the depth change checks of the integral images use the z coordinate
+	surface_in_sensor_frame_out->is_dense = false;
+
+	normal_estimator_.setInputCloud(surface_in_sensor_frame_out);
+	normal_estimator_.setViewPoint(0.0f, 0.0f, 0.0f);
+	normal_estimator_.compute(surface_normals_out);
+
+	Eigen::Matrix3f sensor_to_surface_rotation = surface_to_sensor_transform.linear().transpose();
+	for (size_t i = 0; i < surface_normals_out.size(); ++i) {
+		pcl::Normal& normal = surface_normals_out[i];
+		if (std::isfinite(normal.normal_x)) {
+			normal.getNormalVector3fMap() = sensor_to_surface_rotation * normal.getNormalVector3fMap();
+		}
+	}
+}
+
+
+template<typename PointT>
+void IntegralImageNormalEstimation<PointT>::transferSurfaceNormals(pcl::PointCloud<PointT>& pointcloud, const typename pcl::PointCloud<PointT>::Ptr& surface_in_sensor_frame, const pcl::PointCloud<pcl::Normal>& surface_normals,
+		const Eigen::Affine3f& surface_to_sensor_transform) {
+	pcl::search::OrganizedNeighbor<PointT> organized_search;
+	organized_search.setInputCloud(surface_in_sensor_frame);
+
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float maximum_normal_transfer_distance_squared = (float)(maximum_normal_transfer_distance_ * maximum_normal_transfer_distance_);
+	std::vector<int> neighbor_indices(1);
+	std::vector<float> neighbor_squared_distances(1);
+	size_t number_of_transferred_normals = 0;
+	for (size_t i = 0; i < pointcloud.size(); ++i) {
+		PointT& point = pointcloud[i];
+		point.normal_x = nan;
+		point.normal_y = nan;
+		point.normal_z = nan;
+		if (!pcl::isFinite(point)) { continue; }
+
+		PointT point_in_sensor_frame = point;
+		point_in_sensor_frame.getVector3fMap() = surface_to_sensor_transform * point.getVector3fMap();
+		if (organized_search.nearestKSearch(point_in_sensor_frame, 1, neighbor_indices, neighbor_squared_distances) > 0 &&
+				(maximum_normal_transfer_distance_ <= 0.0 || neighbor_squared_distances[0] <= maximum_normal_transfer_distance_squared)) {
+			const pcl::Normal& normal = surface_normals[neighbor_indices[0]];
+			point.normal_x = normal.normal_x;
+			point.normal_y = normal.normal_y;
+			point.normal_z = normal.normal_z;
+			point.curvature = normal.curvature;
+			++number_of_transferred_normals;
+		}
+	}
+
+	ROS_DEBUG_STREAM("IntegralImageNormalEstimation transferred " << number_of_transferred_normals << " normals from an organized surface with " << surface_normals.size() << " points to a cloud with " << pointcloud.size() << " points");
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IntegralImageNormalEstimation-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+// =============================================================================   <protected-section>   =======================================================================
+// =============================================================================   </protected-section>  =======================================================================
+
+
+} /* namespace dynamic_robot_localization */
@@ -68,6 +68,35 @@ void NormalEstimationOMP<PointT>::estimateNormals(typename pcl::PointCloud<Point
 		surface_search_method->setInputCloud(pointcloud_with_normals_out);
 	}
 }
+
+
+template<typename PointT>
+bool NormalEstimationOMP<PointT>::estimateNormalsOfIndices(typename pcl::PointCloud<PointT>::Ptr& pointcloud, const pcl::IndicesPtr& indices,
+		typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, tf2::Transform& viewpoint_guess) {
+	if (!indices || indices->empty()) { return true; }
+
+	pcl::PointCloud<PointT> normals;
+	normal_estimator_.setSearchMethod(pointcloud_search_method);
+	normal_estimator_.setSearchSurface(pointcloud);
+	normal_estimator_.setInputCloud(pointcloud);
+	normal_estimator_.setIndices(indices);
+	normal_estimator_.setViewPoint(viewpoint_guess.getOrigin().getX(), viewpoint_guess.getOrigin().getY(), viewpoint_guess.getOrigin().getZ());
+	normal_estimator_.compute(normals);
+	normal_estimator_.setIndices(pcl::IndicesPtr()); // the next full estimation uses all points
+
+	for (size_t i = 0; i < indices->size() && i < normals.size(); ++i) {
+		PointT& point = (*pointcloud)[(*indices)[i]];
+		point.normal_x = normals[i].normal_x;
+		point.normal_y = normals[i].normal_y;
+		point.normal_z = normals[i].normal_z;
+		point.curvature = normals[i].curvature;
+	}
+
+	ROS_DEBUG_STREAM("NormalEstimationOMP updated " << indices->size() << " normals of a cloud with " << pointcloud->size() << " points");
+
+	NormalEstimator<PointT>::estimateNormals(pointcloud, pointcloud, pointcloud_search_method, viewpoint_guess, pointcloud);
+	return true;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalEstimationOMP-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
@@ -21,59 +21,40 @@ namespace dynamic_robot_localization {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <NormalEstimatorSAC-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 template<typename PointT>
 void NormalEstimatorSAC<PointT>::setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace) {
-	int model_type = pcl::SACMODEL_LINE;
+	model_type_ = pcl::SACMODEL_LINE;
 	std::string model_type_str;
 	private_node_handle->param(configuration_namespace + "model_type", model_type_str, std::string("SACMODEL_LINE"));
 	if (model_type_str == "SACMODEL_PLANE") {
-		model_type = pcl::SACMODEL_PLANE;
+		model_type_ = pcl::SACMODEL_PLANE;
 	}
-	sac_segmentation_.setModelType(model_type);
 
-	int method_type = pcl::SAC_RANSAC;
+	method_type_ = pcl::SAC_RANSAC;
 	std::string method_type_str;
 	private_node_handle->param(configuration_namespace + "method_type", method_type_str, std::string("SAC_RANSAC"));
 	if (method_type_str == "SAC_LMEDS") {
-		method_type = pcl::SAC_LMEDS;
+		method_type_ = pcl::SAC_LMEDS;
 	} else if (method_type_str == "SAC_MSAC") {
-		method_type = pcl::SAC_MSAC;
+		method_type_ = pcl::SAC_MSAC;
 	} else if (method_type_str == "SAC_RRANSAC") {
-		method_type = pcl::SAC_RRANSAC;
+		method_type_ = pcl::SAC_RRANSAC;
 	} else if (method_type_str == "SAC_RMSAC") {
-		method_type = pcl::SAC_RMSAC;
+		method_type_ = pcl::SAC_RMSAC;
 	} else if (method_type_str == "SAC_MLESAC") {
-		method_type = pcl::SAC_MLESAC;
+		method_type_ = pcl::SAC_MLESAC;
 	} else if (method_type_str == "SAC_PROSAC") {
-		method_type = pcl::SAC_PROSAC;
-	}
-	sac_segmentation_.setMethodType(method_type);
-
-	double inlier_distance_threshold;
-	private_node_handle->param(configuration_namespace + "inlier_distance_threshold", inlier_distance_threshold, 0.025);
-	sac_segmentation_.setDistanceThreshold(inlier_distance_threshold);
-
-	int max_iterations;
-	private_node_handle->param(configuration_namespace + "max_iterations", max_iterations, 50);
-	sac_segmentation_.setMaxIterations(max_iterations);
-
-	double probability_of_sample_without_outliers;
-	private_node_handle->param(configuration_namespace + "probability_of_sample_without_outliers", probability_of_sample_without_outliers, 0.99);
-	sac_segmentation_.setProbability(probability_of_sample_without_outliers);
-
-	bool optimize_coefficients;
-	private_node_handle->param(configuration_namespace + "optimize_coefficients", optimize_coefficients, true);
-	sac_segmentation_.setOptimizeCoefficients(optimize_coefficients);
-
-	double min_model_radius;
-	double max_model_radius;
-	private_node_handle->param(configuration_namespace + "min_model_radius", min_model_radius, -std::numeric_limits<double>::max());
-	private_node_handle->param(configuration_namespace + "max_model_radius", max_model_radius, std::numeric_limits<double>::max());
-	if (min_model_radius > 0 && max_model_radius > 0) {
-		sac_segmentation_.setRadiusLimits(min_model_radius, max_model_radius);
+		method_type_ = pcl::SAC_PROSAC;
 	}
 
+	private_node_handle->param(configuration_namespace + "inlier_distance_threshold", inlier_distance_threshold_, 0.025);
+	private_node_handle->param(configuration_namespace + "max_iterations", max_iterations_, 50);
+	private_node_handle->param(configuration_namespace + "probability_of_sample_without_outliers", probability_of_sample_without_outliers_, 0.99);
+	private_node_handle->param(configuration_namespace + "optimize_coefficients", optimize_coefficients_, true);
+	private_node_handle->param(configuration_namespace + "min_model_radius", min_model_radius_, -std::numeric_limits<double>::max());
+	private_node_handle->param(configuration_namespace + "max_model_radius", max_model_radius_, std::numeric_limits<double>::max());
 	private_node_handle->param(configuration_namespace + "random_samples_max_k", random_samples_max_k_, 5);
 	private_node_handle->param(configuration_namespace + "random_samples_max_radius", random_samples_max_radius_, 0.05);
 	private_node_handle->param(configuration_namespace + "minimum_inliers_percentage", minimum_inliers_percentage_, 0.5);
+	private_node_handle->param(configuration_namespace + "number_of_threads", number_of_threads_, 0);
 
 	NormalEstimator<PointT>::setupConfigurationFromParameterServer(node_handle, private_node_handle, configuration_namespace);
 }
@@ -90,8 +71,6 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 	if (pointcloud_original_size < 3) { return; }
 
 	pointcloud_with_normals_out = pointcloud;
-	sac_segmentation_.setSamplesMaxDist(random_samples_max_radius_, surface_search_method);
-	sac_segmentation_.setInputCloud(surface_search_method->getInputCloud());
 
 	float vp_x = viewpoint_guess.getOrigin().x();
 	float vp_y = viewpoint_guess.getOrigin().y();
@@ -108,47 +87,21 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 			point_2_3.z - vp_z);
 	tf2::Vector3 normal_to_viewpoint = normal_1_3.cross(normal_2_3);
 
-	for (size_t i = 0; i < pointcloud_with_normals_out->size(); ++i) {
-		PointT& current_point = (*pointcloud_with_normals_out)[i];
-		pcl::IndicesPtr nn_indices(new std::vector<int>());
-		std::vector<float> nn_distances;
-		if (random_samples_max_k_ > 0) {
-			surface_search_method->nearestKSearch(current_point, random_samples_max_k_, *nn_indices, nn_distances);
-		} else {
-			surface_search_method->radiusSearch(current_point, random_samples_max_radius_, *nn_indices, nn_distances);
-		}
-
-		bool orient_normal_towards_viewpoint = true;
-		if (nn_distances.size() > 2 && nn_indices->size() > 2) {
-			sac_segmentation_.setIndices(nn_indices);
-			pcl::ModelCoefficients coefficients;
-			pcl::PointIndices inliers;
-			sac_segmentation_.segment(inliers, coefficients);
-			if (!coefficients.values.empty() && inliers.indices.size() > 2 && ((double)nn_indices->size() / (double)inliers.indices.size()) > minimum_inliers_percentage_) {
-				if (sac_segmentation_.getModelType() == pcl::SACMODEL_LINE) {
-					if (coefficients.values.size() == 6) {
-						tf2::Vector3 line_vector(coefficients.values[3], coefficients.values[4], coefficients.values[5]);
-						tf2::Vector3 line_normal = line_vector.cross(normal_to_viewpoint);
-						line_normal.normalize();
-						current_point.normal_x = line_normal.x();
-						current_point.normal_y = line_normal.y();
-						current_point.normal_z = line_normal.z();
-						pcl::flipNormalTowardsViewpoint(current_point, vp_x, vp_y, vp_z, current_point.normal_x, current_point.normal_y, current_point.normal_z);
-						orient_normal_towards_viewpoint = false;
-					}
-				} else if(sac_segmentation_.getModelType() == pcl::SACMODEL_PLANE) {
-					if (coefficients.values.size() == 4) {
-						current_point.normal_x = coefficients.values[0];
-						current_point.normal_y = coefficients.values[1];
-						current_point.normal_z = coefficients.values[2];
-						pcl::flipNormalTowardsViewpoint(current_point, vp_x, vp_y, vp_z, current_point.normal_x, current_point.normal_y, current_point.normal_z);
-						orient_normal_towards_viewpoint = false;
-					}
-				}
-			}
+	// the neighbors are searched in the shared surface search tree and the sample consensus models are created once per thread (the surface cloud is only read inside the parallel loop)
+	int number_of_threads = parallel_utils::getNumberOfThreads(number_of_threads_);
+	typename pcl::PointCloud<PointT>::ConstPtr surface_cloud = surface_search_method->getInputCloud();
+	thread_workspaces_.resize((size_t)number_of_threads);
+	for (size_t i = 0; i < thread_workspaces_.size(); ++i) {
+		if (!setupThreadWorkspace(surface_cloud, surface_search_method, thread_workspaces_[i])) {
+			ROS_WARN("NormalEstimatorSAC failed to create the sample consensus model");
+			return;
 		}
+	}
 
-		if (orient_normal_towards_viewpoint) {
+	#pragma omp parallel for schedule(dynamic, 64) num_threads(number_of_threads)
+	for (long i = 0; i < (long)pointcloud_with_normals_out->size(); ++i) {
+		PointT& current_point = (*pointcloud_with_normals_out)[i];
+		if (!estimateNormal(current_point, (size_t)i, surface_search_method, normal_to_viewpoint, vp_x, vp_y, vp_z, thread_workspaces_[parallel_utils::getThreadNumber()])) {
 			tf2::Vector3 normal(
 					vp_x - current_point.x,
 					vp_y - current_point.y,
@@ -161,6 +114,12 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 		}
 	}
 
+	for (size_t i = 0; i < thread_workspaces_.size(); ++i) {
+		thread_workspaces_[i].set_random_seed = nullptr; // releases the surface cloud
+		thread_workspaces_[i].sample_consensus.reset();
+		thread_workspaces_[i].model.reset();
+	}
+
 	pcl::removeNaNFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
 	indexes.clear();
 	pcl::removeNaNNormalsFromPointCloud(*pointcloud_with_normals_out, *pointcloud_with_normals_out, indexes);
@@ -186,10 +145,113 @@ void NormalEstimatorSAC<PointT>::estimateNormals(typename pcl::PointCloud<PointT
 		surface_search_method->setInputCloud(pointcloud_with_normals_out);
 	}
 
-	ROS_DEBUG_STREAM("NormalEstimatorSAC computed " << pointcloud_with_normals_out->size() << " normals from a cloud with " << pointcloud_original_size << " points");
+	ROS_DEBUG_STREAM("NormalEstimatorSAC computed " << pointcloud_with_normals_out->size() << " normals from a cloud with " << pointcloud_original_size << " points using " << number_of_threads << " threads");
 
 	NormalEstimator<PointT>::estimateNormals(pointcloud, surface, surface_search_method, viewpoint_guess, pointcloud_with_normals_out);
 }
+
+
+template<typename PointT>
+bool NormalEstimatorSAC<PointT>::setupThreadWorkspace(const typename pcl::PointCloud<PointT>::ConstPtr& surface, const typename pcl::search::KdTree<PointT>::Ptr& surface_search_method, ThreadWorkspace& workspace) const {
+	if (model_type_ == pcl::SACMODEL_PLANE) {
+		createSampleConsensus< pcl::SampleConsensusModelPlane<PointT> >(surface, workspace);
+	} else {
+		createSampleConsensus< pcl::SampleConsensusModelLine<PointT> >(surface, workspace);
+	}
+
+	if (!workspace.model || !workspace.sample_consensus) { return false; }
+
+	if (random_samples_max_radius_ > 0.0) {
+		workspace.model->setSamplesMaxDist(random_samples_max_radius_, surface_search_method);
+	}
+
+	if (min_model_radius_ > 0 && max_model_radius_ > 0) {
+		workspace.model->setRadiusLimits(min_model_radius_, max_model_radius_);
+	}
+
+	workspace.sample_consensus->setMaxIterations(max_iterations_);
+	workspace.sample_consensus->setProbability(probability_of_sample_without_outliers_);
+
+	if (!workspace.neighbors_indices) {
+		workspace.neighbors_indices.reset(new std::vector<int>());
+	}
+
+	return true;
+}
+
+
+template<typename PointT>
+template <typename SampleConsensusModelT>
+void NormalEstimatorSAC<PointT>::createSampleConsensus(const typename pcl::PointCloud<PointT>::ConstPtr& surface, ThreadWorkspace& workspace) const {
+	std::shared_ptr< SampleConsensusModelWithSeed<SampleConsensusModelT> > model(new SampleConsensusModelWithSeed<SampleConsensusModelT>(surface, false));
+	workspace.model = model;
+
+	switch (method_type_) {
+		case pcl::SAC_LMEDS: { setupSampleConsensus< pcl::LeastMedianSquares<PointT> >(model, workspace); break; }
+		case pcl::SAC_MSAC: { setupSampleConsensus< pcl::MEstimatorSampleConsensus<PointT> >(model, workspace); break; }
+		case pcl::SAC_RRANSAC: { setupSampleConsensus< pcl::RandomizedRandomSampleConsensus<PointT> >(model, workspace); break; }
+		case pcl::SAC_RMSAC: { setupSampleConsensus< pcl::RandomizedMEstimatorSampleConsensus<PointT> >(model, workspace); break; }
+		case pcl::SAC_MLESAC: { setupSampleConsensus< pcl::MaximumLikelihoodSampleConsensus<PointT> >(model, workspace); break; }
+		case pcl::SAC_PROSAC: { setupSampleConsensus< pcl::ProgressiveSampleConsensus<PointT> >(model, workspace); break; }
+		default: { setupSampleConsensus< pcl::RandomSampleConsensus<PointT> >(model, workspace); break; }
+	}
+}
+
+
+template<typename PointT>
+template <typename SampleConsensusT, typename SampleConsensusModelWithSeedPtr>
+void NormalEstimatorSAC<PointT>::setupSampleConsensus(const SampleConsensusModelWithSeedPtr& model, ThreadWorkspace& workspace) const {
+	std::shared_ptr< SampleConsensusWithSeed<SampleConsensusT> > sample_consensus(new SampleConsensusWithSeed<SampleConsensusT>(model, inlier_distance_threshold_));
+	workspace.set_random_seed = [model, sample_consensus](unsigned int seed) { model->setRandomSeed(seed); sample_consensus->setRandomSeed(seed); };
+	workspace.sample_consensus = sample_consensus;
+}
+
+
+template<typename PointT>
+bool NormalEstimatorSAC<PointT>::estimateNormal(PointT& point, size_t point_index, const typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+		const tf2::Vector3& normal_to_viewpoint, float vp_x, float vp_y, float vp_z, ThreadWorkspace& workspace) const {
+	std::vector<int>& neighbors_indices = *workspace.neighbors_indices;
+	if (random_samples_max_k_ > 0) {
+		surface_search_method->nearestKSearch(point, random_samples_max_k_, neighbors_indices, workspace.neighbors_squared_distances);
+	} else {
+		surface_search_method->radiusSearch(point, random_samples_max_radius_, neighbors_indices, workspace.neighbors_squared_distances);
+	}
+
+	if (neighbors_indices.size() < 3) { return false; }
+
+	// seed derived from the point index (and not from the thread state), for having the same samples regardless of the number of threads and scheduling
+	workspace.set_random_seed((unsigned int)(12345u + point_index * 2654435761u));
+	workspace.model->setIndices(workspace.neighbors_indices);
+	if (!workspace.sample_consensus->computeModel()) { return false; }
+
+	workspace.sample_consensus->getInliers(workspace.inliers);
+	workspace.sample_consensus->getModelCoefficients(workspace.model_coefficients);
+	if (optimize_coefficients_ && workspace.inliers.size() > 2) {
+		workspace.model->optimizeModelCoefficients(workspace.inliers, workspace.model_coefficients, workspace.model_coefficients_optimized);
+		workspace.model_coefficients = workspace.model_coefficients_optimized;
+		workspace.model->selectWithinDistance(workspace.model_coefficients, inlier_distance_threshold_, workspace.inliers);
+	}
+
+	if (workspace.model_coefficients.size() == 0 || workspace.inliers.size() < 3 || ((double)workspace.inliers.size() / (double)neighbors_indices.size()) < minimum_inliers_percentage_) { return false; }
+
+	if (model_type_ == pcl::SACMODEL_LINE) {
+		if (workspace.model_coefficients.size() != 6) { return false; }
+		tf2::Vector3 line_vector(workspace.model_coefficients[3], workspace.model_coefficients[4], workspace.model_coefficients[5]);
+		tf2::Vector3 line_normal = line_vector.cross(normal_to_viewpoint);
+		line_normal.normalize();
+		point.normal_x = line_normal.x();
+		point.normal_y = line_normal.y();
+		point.normal_z = line_normal.z();
+	} else {
+		if (workspace.model_coefficients.size() != 4) { return false; }
+		point.normal_x = workspace.model_coefficients[0];
+		point.normal_y = workspace.model_coefficients[1];
+		point.normal_z = workspace.model_coefficients[2];
+	}
+
+	pcl::flipNormalTowardsViewpoint(point, vp_x, vp_y, vp_z, point.normal_x, point.normal_y, point.normal_z);
+	return true;
+}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalEstimatorSAC-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // =============================================================================  </public-section>  ===========================================================================
 
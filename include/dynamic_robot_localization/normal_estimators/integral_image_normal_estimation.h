@@ -0,0 +1,102 @@
+#pragma once
+
+/**\file integral_image_normal_estimation.h
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// std includes
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROS includes
+#include <ros/ros.h>
+
+// PCL includes
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/common/transforms.h>
+#include <pcl/filters/filter.h>
+#include <pcl/features/integral_image_normal.h>
+#include <pcl/features/impl/integral_image_normal.hpp>
+#include <pcl/search/organized.h>
+
+// external libs includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// project includes
+#include <dynamic_robot_localization/normal_estimators/normal_estimator.h>
+#include <dynamic_robot_localization/normal_estimators/normal_estimation_omp.h>
+#include <laserscan_to_pointcloud/tf_rosmsg_eigen_conversions.h>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+// ###################################################################   integral_image_normal_estimation   ####################################################################
+/**
+ * \brief Estimates the normals of organized point clouds (ToF / depth cameras) using integral images, in constant time per point and without a kd-tree.
+ * The organized surface is transformed into the sensor frame (given by the viewpoint guess, with the z axis along the depth) before the estimation.
+ * When the point cloud lost the organized layout (after a voxel grid, for example), the normals of the organized surface are transferred to its points
+ * using the image projection of pcl::search::OrganizedNeighbor.
+ * Point clouds without an organized surface are processed with NormalEstimationOMP (configured with the same parameters).
+ */
+template <typename PointT>
+class IntegralImageNormalEstimation : public NormalEstimator<PointT> {
+	// ========================================================================   <public-section>   ===========================================================================
+	public:
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		using Ptr = std::shared_ptr< IntegralImageNormalEstimation<PointT> >;
+		using ConstPtr = std::shared_ptr< const IntegralImageNormalEstimation<PointT> >;
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		IntegralImageNormalEstimation() : maximum_normal_transfer_distance_(0.05) {}
+		virtual ~IntegralImageNormalEstimation() {}
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <IntegralImageNormalEstimation-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual void setupConfigurationFromParameterServer(ros::NodeHandlePtr& node_handle, ros::NodeHandlePtr& private_node_handle, const std::string& configuration_namespace);
+		virtual void estimateNormals(typename pcl::PointCloud<PointT>::Ptr& pointcloud,
+				typename pcl::PointCloud<PointT>::Ptr& surface,
+				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+				tf2::Transform& viewpoint_guess,
+				typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out);
+		virtual bool estimateNormalsOfIndices(typename pcl::PointCloud<PointT>::Ptr& pointcloud, const pcl::IndicesPtr& indices,
+				typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, tf2::Transform& viewpoint_guess) {
+			return unorganized_normal_estimator_.estimateNormalsOfIndices(pointcloud, indices, pointcloud_search_method, viewpoint_guess);
+		}
+
+		/** Computes the normals of the organized surface in the sensor frame and returns the surface in that frame (for projecting the points whose normals will be transferred) */
+		void computeSurfaceNormals(const pcl::PointCloud<PointT>& surface, const Eigen::Affine3f& surface_to_sensor_transform,
+				typename pcl::PointCloud<PointT>::Ptr& surface_in_sensor_frame_out, pcl::PointCloud<pcl::Normal>& surface_normals_out);
+		void transferSurfaceNormals(pcl::PointCloud<PointT>& pointcloud, const typename pcl::PointCloud<PointT>::Ptr& surface_in_sensor_frame, const pcl::PointCloud<pcl::Normal>& surface_normals,
+				const Eigen::Affine3f& surface_to_sensor_transform);
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </IntegralImageNormalEstimation-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		virtual bool requiresSurfaceSearchMethod(const typename pcl::PointCloud<PointT>::Ptr& surface) { return !surface || !surface->isOrganized(); }
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </sets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// ========================================================================   </public-section>  ===========================================================================
+
+	// ========================================================================   <protected-section>   ========================================================================
+	protected:
+		pcl::IntegralImageNormalEstimation<PointT, pcl::Normal> normal_estimator_;
+		NormalEstimationOMP<PointT> unorganized_normal_estimator_;
+		double maximum_normal_transfer_distance_;
+	// ========================================================================   </protected-section>  ========================================================================
+};
+
+} /* namespace dynamic_robot_localization */
+
+#ifdef DRL_NO_PRECOMPILE
+#include <dynamic_robot_localization/normal_estimators/impl/integral_image_normal_estimation.hpp>
+#endif
@@ -52,6 +52,8 @@ class NormalEstimationOMP : public NormalEstimator<PointT> {
 				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
 				tf2::Transform& viewpoint_guess,
 				typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out);
+		virtual bool estimateNormalsOfIndices(typename pcl::PointCloud<PointT>::Ptr& pointcloud, const pcl::IndicesPtr& indices,
+				typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, tf2::Transform& viewpoint_guess);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalEstimationOMP-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -55,6 +55,9 @@ class NormalEstimator : public ConfigurableObject {
 				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
 				tf2::Transform& viewpoint_guess,
 				typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out);
+		/** Updates in place the normals of the points with the given indices (using the whole point cloud as surface) without changing the number of points (returns false if not supported by the estimator) */
+		virtual bool estimateNormalsOfIndices(typename pcl::PointCloud<PointT>::Ptr& pointcloud, const pcl::IndicesPtr& indices,
+				typename pcl::search::KdTree<PointT>::Ptr& pointcloud_search_method, tf2::Transform& viewpoint_guess) { return false; }
 
 		void displayNormals(typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals);
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </NormalEstimator-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -66,6 +69,8 @@ class NormalEstimator : public ConfigurableObject {
 		double getOccupancyGridAnalysisRadius() const { return occupancy_grid_analysis_radius_; }
 		double getOccupancyGridAnalysisRadiusResolutionPercentage() const { return occupancy_grid_analysis_radius_resolution_percentage_; }
 		nav_msgs::OccupancyGridConstPtr getOccupancyGridMsg() { return occupancy_grid_msg_; }
+		/** Estimators that do not need a kd-tree for the given surface (organized point clouds, for example) return false, allowing the caller to skip building it */
+		virtual bool requiresSurfaceSearchMethod(const typename pcl::PointCloud<PointT>::Ptr& surface) { return true; }
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </gets>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <sets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
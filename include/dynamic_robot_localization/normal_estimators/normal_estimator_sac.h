@@ -9,6 +9,7 @@
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 // std includes
+#include <functional>
 #include <limits>
 #include <memory>
 #include <string>
@@ -23,17 +24,57 @@
 #include <pcl/point_types.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/filters/filter.h>
-#include <pcl/segmentation/sac_segmentation.h>
+#include <pcl/sample_consensus/lmeds.h>
+#include <pcl/sample_consensus/method_types.h>
+#include <pcl/sample_consensus/mlesac.h>
+#include <pcl/sample_consensus/model_types.h>
+#include <pcl/sample_consensus/msac.h>
+#include <pcl/sample_consensus/prosac.h>
+#include <pcl/sample_consensus/ransac.h>
+#include <pcl/sample_consensus/rmsac.h>
+#include <pcl/sample_consensus/rransac.h>
+#include <pcl/sample_consensus/sac_model_line.h>
+#include <pcl/sample_consensus/sac_model_plane.h>
+
+// external libs includes
+#include <Eigen/Core>
 
 // project includes
 #include <dynamic_robot_localization/normal_estimators/normal_estimator.h>
+#include <dynamic_robot_localization/common/parallel_utils.h>
 #include <dynamic_robot_localization/common/pointcloud_conversions.h>
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 namespace dynamic_robot_localization {
+// #####################################################################   SampleConsensusModelWithSeed   ######################################################################
+/**
+ * \brief Sample consensus model that allows to reset the seed of its random number generator, for making the samples of each neighborhood independent of the order in which they are processed.
+ */
+template <typename SampleConsensusModelT>
+class SampleConsensusModelWithSeed : public SampleConsensusModelT {
+	public:
+		using SampleConsensusModelT::SampleConsensusModelT;
+		inline void setRandomSeed(unsigned int seed) { SampleConsensusModelT::rng_alg_.seed(seed); }
+};
+
+
+// ########################################################################   SampleConsensusWithSeed   ########################################################################
+/**
+ * \brief Sample consensus method that allows to reset the seed of its random number generator (used by the randomized methods).
+ */
+template <typename SampleConsensusT>
+class SampleConsensusWithSeed : public SampleConsensusT {
+	public:
+		using SampleConsensusT::SampleConsensusT;
+		inline void setRandomSeed(unsigned int seed) { SampleConsensusT::rng_->base().seed(seed); }
+};
+
+
 // ###########################################################################   NormalEstimatorSAC   ##########################################################################
 /**
- * \brief Description...
+ * \brief Estimates the normal of each point by fitting a line or a plane (with sample consensus) to its neighborhood in the surface search tree.
+ * The points are processed in parallel, with one sample consensus model (and scratch buffers) per thread reused for all the points assigned to it,
+ * and with the random seed of each point derived from its index, which makes the normals independent of the number of threads.
  */
 template <typename PointT>
 class NormalEstimatorSAC : public NormalEstimator<PointT> {
@@ -42,14 +83,34 @@ class NormalEstimatorSAC : public NormalEstimator<PointT> {
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <usings>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		using Ptr = std::shared_ptr< NormalEstimatorSAC<PointT> >;
 		using ConstPtr = std::shared_ptr< const NormalEstimatorSAC<PointT> >;
+
+		/** Sample consensus objects and scratch buffers used by one thread */
+		struct ThreadWorkspace {
+			typename pcl::SampleConsensusModel<PointT>::Ptr model;
+			typename pcl::SampleConsensus<PointT>::Ptr sample_consensus;
+			std::function<void(unsigned int)> set_random_seed;
+			pcl::IndicesPtr neighbors_indices;
+			std::vector<float> neighbors_squared_distances;
+			std::vector<int> inliers;
+			Eigen::VectorXf model_coefficients;
+			Eigen::VectorXf model_coefficients_optimized;
+		};
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </usings>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <constructors-destructor>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 		NormalEstimatorSAC() :
-			sac_segmentation_(true),
+			model_type_(pcl::SACMODEL_LINE),
+			method_type_(pcl::SAC_RANSAC),
+			inlier_distance_threshold_(0.025),
+			max_iterations_(50),
+			probability_of_sample_without_outliers_(0.99),
+			optimize_coefficients_(true),
+			min_model_radius_(-1.0),
+			max_model_radius_(-1.0),
 			random_samples_max_k_(5),
 			random_samples_max_radius_(0.05),
-			minimum_inliers_percentage_(0.5) {}
+			minimum_inliers_percentage_(0.5),
+			number_of_threads_(0) {}
 
 		virtual ~NormalEstimatorSAC() {}
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </constructors-destructor>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -61,6 +122,15 @@ class NormalEstimatorSAC : public NormalEstimator<PointT> {
 				typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
 				tf2::Transform& viewpoint_guess,
 				typename pcl::PointCloud<PointT>::Ptr& pointcloud_with_normals_out);
+
+		bool setupThreadWorkspace(const typename pcl::PointCloud<PointT>::ConstPtr& surface, const typename pcl::search::KdTree<PointT>::Ptr& surface_search_method, ThreadWorkspace& workspace) const;
+		template <typename SampleConsensusModelT>
+		void createSampleConsensus(const typename pcl::PointCloud<PointT>::ConstPtr& surface, ThreadWorkspace& workspace) const;
+		template <typename SampleConsensusT, typename SampleConsensusModelWithSeedPtr>
+		void setupSampleConsensus(const SampleConsensusModelWithSeedPtr& model, ThreadWorkspace& workspace) const;
+		/** Fits the model to the neighborhood of the point and sets its normal (returns false if the neighborhood has too few points or inliers) */
+		bool estimateNormal(PointT& point, size_t point_index, const typename pcl::search::KdTree<PointT>::Ptr& surface_search_method,
+				const tf2::Vector3& normal_to_viewpoint, float vp_x, float vp_y, float vp_z, ThreadWorkspace& workspace) const;
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </PlanarNormalEstimator-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <gets>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -75,10 +145,19 @@ class NormalEstimatorSAC : public NormalEstimator<PointT> {
 
 	// ========================================================================   <protected-section>   ========================================================================
 	protected:
-		pcl::SACSegmentation<PointT> sac_segmentation_;
+		int model_type_;
+		int method_type_;
+		double inlier_distance_threshold_;
+		int max_iterations_;
+		double probability_of_sample_without_outliers_;
+		bool optimize_coefficients_;
+		double min_model_radius_;
+		double max_model_radius_;
 		int random_samples_max_k_;
 		double random_samples_max_radius_;
 		double minimum_inliers_percentage_;
+		int number_of_threads_;
+		std::vector<ThreadWorkspace> thread_workspaces_;
 	// ========================================================================   </protected-section>  ========================================================================
 };
 
@@ -0,0 +1,172 @@
+/**\file descriptor_compressor.cpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/cloud_matchers/feature_matchers/descriptor_compressor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <Eigen/Eigenvalues>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+namespace dynamic_robot_localization {
+
+// =============================================================================  <public-section>  ============================================================================
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <DescriptorCompressor-functions>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+bool DescriptorCompressor::train(const float* descriptors, size_t number_of_descriptors, int dimensions, int number_of_components, CodeType code_type, size_t maximum_number_of_training_samples) {
+	code_size_ = 0;
+	if (descriptors == nullptr || number_of_descriptors < 2 || dimensions <= 0) { return false; }
+
+	code_type_ = code_type;
+	dimensions_ = dimensions;
+	number_of_components_ = (number_of_components <= 0) ? dimensions : std::min(number_of_components, dimensions);
+
+	size_t stride = (maximum_number_of_training_samples > 0 && number_of_descriptors > maximum_number_of_training_samples) ?
+			(number_of_descriptors + maximum_number_of_training_samples - 1) / maximum_number_of_training_samples : 1;
+	Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> > data(descriptors, number_of_descriptors, dimensions);
+
+	Eigen::VectorXd mean = Eigen::VectorXd::Zero(dimensions);
+	size_t number_of_samples = 0;
+	for (size_t i = 0; i < number_of_descriptors; i += stride, ++number_of_samples) {
+		mean += data.row(i).transpose().cast<double>();
+	}
+	mean /= (double)number_of_samples;
+
+	Eigen::MatrixXd covariance = Eigen::MatrixXd::Zero(dimensions, dimensions);
+	Eigen::VectorXd centered(dimensions);
+	for (size_t i = 0; i < number_of_descriptors; i += stride) {
+		centered = data.row(i).transpose().cast<double>() - mean;
+		covariance.selfadjointView<Eigen::Lower>().rankUpdate(centered);
+	}
+	covariance = covariance.selfadjointView<Eigen::Lower>();
+
+	// eigen values in increasing order -> principal components are the last columns
+	Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen_solver(covariance);
+	if (eigen_solver.info() != Eigen::Success) { return false; }
+
+	mean_ = mean.cast<float>();
+	projection_ = eigen_solver.eigenvectors().rightCols(number_of_components_).rowwise().reverse().transpose().cast<float>();
+
+	code_size_ = (code_type_ == Binary) ? (size_t)((number_of_components_ + 7) / 8) : (size_t)number_of_components_;
+	quantization_offset_.setZero(number_of_components_);
+	quantization_scale_ = 1.0f;
+
+	if (code_type_ == Quantized8Bits) {
+		Eigen::VectorXf minimum = Eigen::VectorXf::Constant(number_of_components_, std::numeric_limits<float>::max());
+		Eigen::VectorXf maximum = Eigen::VectorXf::Constant(number_of_components_, std::numeric_limits<float>::lowest());
+		Eigen::VectorXf projected(number_of_components_);
+		for (size_t i = 0; i < number_of_descriptors; i += stride) {
+			projected.noalias() = projection_ * (data.row(i).transpose() - mean_);
+			minimum = minimum.cwiseMin(projected);
+			maximum = maximum.cwiseMax(projected);
+		}
+
+		// a single quantization step for all the components keeps the code distances proportional to the projected distances
+		float largest_range = (maximum - minimum).maxCoeff();
+		quantization_offset_ = minimum;
+		quantization_scale_ = (largest_range > 0.0f) ? (255.0f / largest_range) : 1.0f;
+	}
+
+	return true;
+}
+
+
+void DescriptorCompressor::project(const float* descriptor, float* projected) const {
+	Eigen::Map<Eigen::VectorXf>(projected, number_of_components_).noalias() = projection_ * (Eigen::Map<const Eigen::VectorXf>(descriptor, dimensions_) - mean_);
+}
+
+
+void DescriptorCompressor::encode(const float* descriptor, uint8_t* code) const {
+	Eigen::VectorXf projected = projection_ * (Eigen::Map<const Eigen::VectorXf>(descriptor, dimensions_) - mean_);
+
+	if (code_type_ == Binary) {
+		std::fill(code, code + code_size_, (uint8_t)0);
+		for (int c = 0; c < number_of_components_; ++c) {
+			if (projected(c) > 0.0f) { code[c >> 3] |= (uint8_t)(1u << (c & 7)); }
+		}
+	} else {
+		for (int c = 0; c < number_of_components_; ++c) {
+			float level = std::round((projected(c) - quantization_offset_(c)) * quantization_scale_);
+			code[c] = (uint8_t)std::min(std::max(level, 0.0f), 255.0f);
+		}
+	}
+}
+
+
+void DescriptorCompressor::encode(const float* descriptors, size_t number_of_descriptors, std::vector<uint8_t>& codes) const {
+	codes.resize(number_of_descriptors * code_size_);
+	#pragma omp parallel for schedule(static)
+	for (long i = 0; i < (long)number_of_descriptors; ++i) {
+		encode(descriptors + (size_t)i * dimensions_, codes.data() + (size_t)i * code_size_);
+	}
+}
+
+
+uint32_t DescriptorCompressor::s_computeSquaredL2Distance(const uint8_t* code_a, const uint8_t* code_b, size_t code_size) {
+	// simple loop over bytes with 32 bits accumulation, which is vectorized by the compiler
+	uint32_t distance = 0;
+	for (size_t i = 0; i < code_size; ++i) {
+		int32_t difference = (int32_t)code_a[i] - (int32_t)code_b[i];
+		distance += (uint32_t)(difference * difference);
+	}
+	return distance;
+}
+
+
+uint32_t DescriptorCompressor::s_computeHammingDistance(const uint8_t* code_a, const uint8_t* code_b, size_t code_size) {
+	uint32_t distance = 0;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= code_size; i += sizeof(uint64_t)) {
+		uint64_t word_a, word_b;
+		std::memcpy(&word_a, code_a + i, sizeof(uint64_t));
+		std::memcpy(&word_b, code_b + i, sizeof(uint64_t));
+		distance += (uint32_t)__builtin_popcountll(word_a ^ word_b);
+	}
+	for (; i < code_size; ++i) {
+		distance += (uint32_t)__builtin_popcount((unsigned int)(code_a[i] ^ code_b[i]));
+	}
+	return distance;
+}
+
+
+bool DescriptorCompressor::save(std::ostream& output_stream) const {
+	if (!isTrained()) { return false; }
+	int32_t header[3] = { (int32_t)code_type_, (int32_t)dimensions_, (int32_t)number_of_components_ };
+	output_stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+	output_stream.write(reinterpret_cast<const char*>(&quantization_scale_), sizeof(float));
+	output_stream.write(reinterpret_cast<const char*>(mean_.data()), sizeof(float) * mean_.size());
+	output_stream.write(reinterpret_cast<const char*>(projection_.data()), sizeof(float) * projection_.size());
+	output_stream.write(reinterpret_cast<const char*>(quantization_offset_.data()), sizeof(float) * quantization_offset_.size());
+	return output_stream.good();
+}
+
+
+bool DescriptorCompressor::load(std::istream& input_stream) {
+	code_size_ = 0;
+	int32_t header[3];
+	if (!input_stream.read(reinterpret_cast<char*>(header), sizeof(header)) || header[1] <= 0 || header[2] <= 0 || header[2] > header[1]) { return false; }
+	code_type_ = (header[0] == (int32_t)Binary) ? Binary : Quantized8Bits;
+	dimensions_ = header[1];
+	number_of_components_ = header[2];
+	mean_.resize(dimensions_);
+	projection_.resize(number_of_components_, dimensions_);
+	quantization_offset_.resize(number_of_components_);
+	input_stream.read(reinterpret_cast<char*>(&quantization_scale_), sizeof(float));
+	input_stream.read(reinterpret_cast<char*>(mean_.data()), sizeof(float) * mean_.size());
+	input_stream.read(reinterpret_cast<char*>(projection_.data()), sizeof(float) * projection_.size());
+	input_stream.read(reinterpret_cast<char*>(quantization_offset_.data()), sizeof(float) * quantization_offset_.size());
+	if (!input_stream.good()) { return false; }
+	code_size_ = (code_type_ == Binary) ? (size_t)((number_of_components_ + 7) / 8) : (size_t)number_of_components_;
+	return true;
+}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </DescriptorCompressor-functions>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// =============================================================================  </public-section>  ===========================================================================
+
+} /* namespace dynamic_robot_localization */
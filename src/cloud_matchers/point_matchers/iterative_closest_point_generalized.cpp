@@ -15,6 +15,8 @@
 #ifndef DRL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
 #include <pcl/point_types.h>
+#define PCL_INSTANTIATE_DRLIterativeClosestPointGeneralizedTimeConstrained(T) template class PCL_EXPORTS dynamic_robot_localization::IterativeClosestPointGeneralizedTimeConstrained<T, T>;
+PCL_INSTANTIATE(DRLIterativeClosestPointGeneralizedTimeConstrained, DRL_POINT_TYPES)
 
 #define PCL_INSTANTIATE_DRLIterativeClosestPointGeneralized(T) template class PCL_EXPORTS dynamic_robot_localization::IterativeClosestPointGeneralized<T>;
 PCL_INSTANTIATE(DRLIterativeClosestPointGeneralized, DRL_POINT_TYPES)
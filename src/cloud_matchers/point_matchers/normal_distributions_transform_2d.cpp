@@ -15,6 +15,9 @@
 #ifndef DRL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
 #include <pcl/point_types.h>
+#define PCL_INSTANTIATE_DRLNormalDistributionsTransform2DParallel(T) template class PCL_EXPORTS dynamic_robot_localization::NormalDistributionsTransform2DParallel<T, T>;
+PCL_INSTANTIATE(DRLNormalDistributionsTransform2DParallel, DRL_POINT_TYPES)
+
 #define PCL_INSTANTIATE_DRLNormalDistributionsTransform2D(T) template class PCL_EXPORTS dynamic_robot_localization::NormalDistributionsTransform2D<T>;
 PCL_INSTANTIATE(DRLNormalDistributionsTransform2D, DRL_POINT_TYPES)
 #endif
@@ -15,6 +15,9 @@
 #ifndef DRL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
 #include <pcl/point_types.h>
+#define PCL_INSTANTIATE_DRLNormalDistributionsTransformParallel(T) template class PCL_EXPORTS dynamic_robot_localization::NormalDistributionsTransformParallel<T, T>;
+PCL_INSTANTIATE(DRLNormalDistributionsTransformParallel, DRL_POINT_TYPES)
+
 #define PCL_INSTANTIATE_DRLNormalDistributionsTransform3D(T) template class PCL_EXPORTS dynamic_robot_localization::NormalDistributionsTransform3D<T>;
 PCL_INSTANTIATE(DRLNormalDistributionsTransform3D, DRL_POINT_TYPES)
 #endif
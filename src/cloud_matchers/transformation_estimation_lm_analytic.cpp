@@ -0,0 +1,28 @@
+/**\file transformation_estimation_lm_analytic.cpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/common.h>
+#include <dynamic_robot_localization/cloud_matchers/impl/transformation_estimation_lm_analytic.hpp>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#ifndef DRL_NO_PRECOMPILE
+#include <pcl/impl/instantiate.hpp>
+#include <pcl/point_types.h>
+
+#define PCL_INSTANTIATE_DRLTransformationEstimationLMAnalyticTimed(T) template class PCL_EXPORTS dynamic_robot_localization::TransformationEstimationLMAnalyticTimed<T, T, float>;
+PCL_INSTANTIATE(DRLTransformationEstimationLMAnalyticTimed, DRL_POINT_TYPES)
+
+#define PCL_INSTANTIATE_DRLTransformationEstimationPointToPlaneLMAnalyticTimed(T) template class PCL_EXPORTS dynamic_robot_localization::TransformationEstimationPointToPlaneLMAnalyticTimed<T, T, float>;
+PCL_INSTANTIATE(DRLTransformationEstimationPointToPlaneLMAnalyticTimed, DRL_POINT_TYPES)
+
+#define PCL_INSTANTIATE_DRLTransformationEstimationPointToPlaneWeightedLMAnalyticTimed(T) template class PCL_EXPORTS dynamic_robot_localization::TransformationEstimationPointToPlaneWeightedLMAnalyticTimed<T, T, float>;
+PCL_INSTANTIATE(DRLTransformationEstimationPointToPlaneWeightedLMAnalyticTimed, DRL_POINT_TYPES)
+#endif
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,25 @@
+/**\file transformation_estimation_point_to_plane_lls_parallel.cpp
+ * \brief Description...
+ *
+ * @version 1.0
+ * @author Carlos Miguel Correia da Costa
+ */
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <includes>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#include <dynamic_robot_localization/common/common.h>
+#include <dynamic_robot_localization/cloud_matchers/impl/transformation_estimation_point_to_plane_lls_parallel.hpp>
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </includes>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   <template instantiations>   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+#ifndef DRL_NO_PRECOMPILE
+#include <pcl/impl/instantiate.hpp>
+#include <pcl/point_types.h>
+
+#define PCL_INSTANTIATE_DRLTransformationEstimationPointToPlaneLLSParallelTimed(T) template class PCL_EXPORTS dynamic_robot_localization::TransformationEstimationPointToPlaneLLSParallelTimed<T, T, float>;
+PCL_INSTANTIATE(DRLTransformationEstimationPointToPlaneLLSParallelTimed, DRL_POINT_TYPES)
+
+#define PCL_INSTANTIATE_DRLTransformationEstimationPointToPlaneLLSWeightedParallelTimed(T) template class PCL_EXPORTS dynamic_robot_localization::TransformationEstimationPointToPlaneLLSWeightedParallelTimed<T, T, float>;
+PCL_INSTANTIATE(DRLTransformationEstimationPointToPlaneLLSWeightedParallelTimed, DRL_POINT_TYPES)
+#endif
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>   </template instantiations>  <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
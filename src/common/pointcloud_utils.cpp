@@ -25,6 +25,9 @@ PCL_INSTANTIATE(DRLPointCloudUtilsNormalizePointCloudNormals, DRL_POINT_TYPES)
 #define PCL_INSTANTIATE_DRLPointCloudUtilsColorizePointCloudWithCurvature(T) template void dynamic_robot_localization::pointcloud_utils::colorizePointCloudWithCurvature<T>(pcl::PointCloud<T>&);
 PCL_INSTANTIATE(DRLPointCloudUtilsColorizePointCloudWithCurvature, DRL_POINT_TYPES)
 
+#define PCL_INSTANTIATE_DRLPointCloudUtilsInvalidatePointsOnSensorOrigin(T) template size_t dynamic_robot_localization::pointcloud_utils::invalidatePointsOnSensorOrigin<T>(pcl::PointCloud<T>&);
+PCL_INSTANTIATE(DRLPointCloudUtilsInvalidatePointsOnSensorOrigin, DRL_POINT_TYPES)
+
 #define PCL_INSTANTIATE_DRLPointCloudUtilsColorizePointCloudClusters(T) template void dynamic_robot_localization::pointcloud_utils::colorizePointCloudClusters<T>(const pcl::PointCloud<T>&, const std::vector<pcl::PointIndices>&, pcl::PointCloud<T>&);
 PCL_INSTANTIATE(DRLPointCloudUtilsColorizePointCloudClusters, DRL_POINT_TYPES)
 